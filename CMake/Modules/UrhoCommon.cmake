@@ -248,6 +248,8 @@ endif ()
 cmake_dependent_option (URHO3D_PACKAGING "Enable resources packaging support" FALSE "NOT WEB" TRUE)
 # Enable profiling by default. If disabled, autoprofileblocks become no-ops and the Profiler subsystem is not instantiated.
 option (URHO3D_PROFILING "Enable profiling support" TRUE)
+# Disable allocation tracking by default. If enabled, the global operator new is replaced to count allocations by thread, tagged scope and call site.
+option (URHO3D_TRACK_ALLOCATIONS "Enable allocation tracking at the expense of memory and performance penalty" FALSE)
 # Enable logging by default. If disabled, LOGXXXX macros become no-ops and the Log subsystem is not instantiated.
 option (URHO3D_LOGGING "Enable logging support" TRUE)
 # Enable threading by default, except for Emscripten because its thread support is yet experimental
@@ -446,6 +448,7 @@ foreach (OPT
         URHO3D_PHYSICS
         URHO3D_PROFILING
         URHO3D_THREADING
+        URHO3D_TRACK_ALLOCATIONS
         URHO3D_URHO2D
         URHO3D_WEBP
         URHO3D_WIN32_CONSOLE)
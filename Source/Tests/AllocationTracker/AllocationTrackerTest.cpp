@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Core/AllocationTracker.h>
+
+#include "Test.h"
+
+#include <Urho3D/DebugNew.h>
+
+#ifdef _MSC_VER
+#define TEST_NOINLINE __declspec(noinline)
+#else
+#define TEST_NOINLINE __attribute__((noinline))
+#endif
+
+/// Number of elements pushed into the vectors and characters appended to the strings.
+static const unsigned NUM_ELEMENTS = 1000000;
+/// Number of threads started and exited one after another.
+static const unsigned NUM_THREADS = 200;
+
+/// Grow a vector. One of two identical functions, whose allocations must be attributed to different call sites.
+TEST_NOINLINE static unsigned GrowVectorA()
+{
+    PODVector<unsigned> vector;
+    for (unsigned i = 0; i < NUM_ELEMENTS; ++i)
+        vector.Push(i);
+    return vector.Size();
+}
+
+/// Grow a vector. One of two identical functions, whose allocations must be attributed to different call sites.
+TEST_NOINLINE static unsigned GrowVectorB()
+{
+    PODVector<unsigned> vector;
+    for (unsigned i = 0; i < NUM_ELEMENTS; ++i)
+        vector.Push(i);
+    return vector.Size();
+}
+
+/// Grow a string. One of two identical functions, whose allocations must be attributed to different call sites.
+TEST_NOINLINE static unsigned GrowStringA()
+{
+    String string;
+    for (unsigned i = 0; i < NUM_ELEMENTS; ++i)
+        string += 'a';
+    return string.Length();
+}
+
+/// Grow a string. One of two identical functions, whose allocations must be attributed to different call sites.
+TEST_NOINLINE static unsigned GrowStringB()
+{
+    String string;
+    for (unsigned i = 0; i < NUM_ELEMENTS; ++i)
+        string += 'b';
+    return string.Length();
+}
+
+/// Check that allocations made by growing the containers are attributed to the code using them. If the container internals
+/// were recorded as the call site, both functions of a pair would share one call site.
+static void TestCallSites(AllocationTracker* tracker, unsigned (*growA)(), unsigned (*growB)())
+{
+    PODVector<AllocationCallSite> before;
+    tracker->GetTopCallSites(before, AllocationTracker::DEFAULT_REPORT_CALL_SITES);
+    TEST_CHECK(growA() == NUM_ELEMENTS);
+    TEST_CHECK(growB() == NUM_ELEMENTS);
+    PODVector<AllocationCallSite> after;
+    tracker->GetTopCallSites(after, AllocationTracker::DEFAULT_REPORT_CALL_SITES);
+
+    // Each function allocates at least a megabyte, more than the other code in the test
+    unsigned numCallSites = 0;
+    for (unsigned i = 0; i < after.Size(); ++i)
+    {
+        unsigned long long bytes = after[i].total_.bytes_;
+        for (unsigned j = 0; j < before.Size(); ++j)
+        {
+            if (before[j].address_ == after[i].address_)
+                bytes -= before[j].total_.bytes_;
+        }
+        if (bytes >= NUM_ELEMENTS)
+            ++numCallSites;
+    }
+    TEST_CHECK(numCallSites == 2);
+}
+
+/// Check that the counters of exited threads are reused, so that short-lived threads do not use up the counters and end up
+/// sharing the last ones.
+static void TestThreadCounters(AllocationTracker* tracker)
+{
+    tracker->EndFrame();
+    unsigned numCounters = tracker->GetThreadFrameStats().Size();
+
+    for (unsigned i = 0; i < NUM_THREADS; ++i)
+    {
+        SharedPtr<FunctionThread> thread(new FunctionThread([]() {
+            String string(' ', 100);
+            PODVector<unsigned> vector(100);
+        }));
+        thread->Run();
+        thread->Stop();
+    }
+
+    tracker->EndFrame();
+    PrintLine(ToString("Thread counters in use: %u before, %u after %u threads", numCounters,
+        tracker->GetThreadFrameStats().Size(), NUM_THREADS));
+    TEST_CHECK(tracker->GetThreadFrameStats().Size() <= numCounters + 1);
+}
+
+int main(int argc, char** argv)
+{
+    if (!AllocationTracker::IsEnabled())
+    {
+        PrintLine("Allocation tracking is not compiled in, skipping");
+        return 0;
+    }
+
+    SharedPtr<Context> context = CreateTestContext();
+    SharedPtr<AllocationTracker> tracker(new AllocationTracker(context));
+
+    TestCallSites(tracker, GrowVectorA, GrowVectorB);
+    TestCallSites(tracker, GrowStringA, GrowStringB);
+    TestThreadCounters(tracker);
+    return 0;
+}
@@ -0,0 +1,239 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Graphics/Drawable.h>
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/OctreeQuery.h>
+#include <Urho3D/Scene/Node.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "Test.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Number of drawables in the scene.
+static const unsigned NUM_DRAWABLES = 100000;
+/// Number of frustum queries in the benchmark.
+static const unsigned NUM_QUERIES = 64;
+/// Every this many drawables are moved or resized between the checks.
+static const unsigned CHANGE_INTERVAL = 10;
+/// Half size of the volume the drawables are spread in. Fits the default octree size.
+static const float SPREAD = 900.0f;
+
+/// Drawable with a box of a given size around its node.
+class TestDrawable : public Drawable
+{
+    URHO3D_OBJECT(TestDrawable, Drawable);
+
+public:
+    /// Construct.
+    explicit TestDrawable(Context* context) :
+        Drawable(context, DRAWABLE_GEOMETRY)
+    {
+    }
+
+    /// Set the size of the box. Like the billboards, does not queue the octree update; the box is recalculated on demand.
+    void SetSize(float size)
+    {
+        boundingBox_ = BoundingBox(-0.5f * size, 0.5f * size);
+        worldBoundingBoxDirty_ = true;
+    }
+
+protected:
+    /// Recalculate the world-space bounding box.
+    void OnWorldBoundingBoxUpdate() override
+    {
+        worldBoundingBox_ = boundingBox_.Transformed(node_->GetWorldTransform());
+    }
+};
+
+/// Return the next pseudo-random number between 0 and 1.
+static float NextRandom(unsigned& seed)
+{
+    seed = seed * 1664525 + 1013904223;
+    return (float)(seed >> 8u) / (float)(1u << 24u);
+}
+
+/// Return a pseudo-random position in the volume the drawables are spread in.
+static Vector3 NextPosition(unsigned& seed)
+{
+    float x = NextRandom(seed);
+    float y = NextRandom(seed);
+    float z = NextRandom(seed);
+    return (Vector3(x, y, z) * 2.0f - Vector3::ONE) * SPREAD;
+}
+
+/// Return a camera frustum looking around from the center of the volume.
+static Frustum GetFrustum(unsigned index)
+{
+    Frustum frustum;
+    frustum.Define(60.0f, 16.0f / 9.0f, 1.0f, 0.1f, 500.0f,
+        Matrix3x4(Vector3::ZERO, Quaternion(index * 360.0f / NUM_QUERIES, Vector3::UP), Vector3::ONE));
+    return frustum;
+}
+
+/// Query the octree with a frustum. Return the drawables found in a sorted order.
+static void QueryDrawables(Octree* octree, const Frustum& frustum, PODVector<Drawable*>& result)
+{
+    result.Clear();
+    FrustumOctreeQuery query(result, frustum, DRAWABLE_GEOMETRY);
+    octree->GetDrawables(query);
+    Sort(result.Begin(), result.End());
+}
+
+/// Test each drawable's world bounding box against a frustum one by one. Return the drawables found in a sorted order.
+static void TestDrawables(const PODVector<Drawable*>& drawables, const Frustum& frustum, PODVector<Drawable*>& result)
+{
+    result.Clear();
+    for (unsigned i = 0; i < drawables.Size(); ++i)
+    {
+        if (frustum.IsInsideFast(drawables[i]->GetWorldBoundingBox()) != OUTSIDE)
+            result.Push(drawables[i]);
+    }
+    Sort(result.Begin(), result.End());
+}
+
+/// Check that the octree query finds the same drawables as testing them one by one, with a few frustums.
+static void CheckQueries(Octree* octree, const PODVector<Drawable*>& drawables)
+{
+    PODVector<Drawable*> result;
+    PODVector<Drawable*> expected;
+    for (unsigned i = 0; i < NUM_QUERIES; i += NUM_QUERIES / 8)
+    {
+        QueryDrawables(octree, GetFrustum(i), result);
+        TestDrawables(drawables, GetFrustum(i), expected);
+        TEST_CHECK(!expected.Empty());
+        TEST_CHECK(result == expected);
+    }
+}
+
+/// Measure the octree query against testing each drawable one by one.
+static void BenchmarkQueries(Octree* octree, const PODVector<Drawable*>& drawables)
+{
+    PODVector<Drawable*> result;
+    unsigned numFound = 0;
+    HiresTimer timer;
+    for (unsigned i = 0; i < NUM_QUERIES; ++i)
+    {
+        result.Clear();
+        FrustumOctreeQuery query(result, GetFrustum(i), DRAWABLE_GEOMETRY);
+        octree->GetDrawables(query);
+        numFound += result.Size();
+    }
+    long long queryUSec = timer.GetUSec(true);
+
+    unsigned numExpected = 0;
+    for (unsigned i = 0; i < NUM_QUERIES; ++i)
+    {
+        Frustum frustum = GetFrustum(i);
+        for (unsigned j = 0; j < drawables.Size(); ++j)
+            numExpected += frustum.IsInsideFast(drawables[j]->GetWorldBoundingBox()) != OUTSIDE ? 1 : 0;
+    }
+    long long bruteForceUSec = timer.GetUSec(false);
+
+    TEST_CHECK(numFound == numExpected);
+    PrintLine(ToString("Average %u drawables inside the frustum", numFound / NUM_QUERIES));
+    PrintBenchmark("Octree query", NUM_QUERIES, queryUSec);
+    PrintBenchmark("Testing every drawable", NUM_QUERIES, bruteForceUSec);
+}
+
+/// Update the octree like the renderer does at the start of the frame.
+static void UpdateOctree(Octree* octree, unsigned frameNumber)
+{
+    FrameInfo frame{};
+    frame.frameNumber_ = frameNumber;
+    frame.timeStep_ = 1.0f / 60.0f;
+    octree->Update(frame);
+}
+
+int main(int argc, char** argv)
+{
+    SharedPtr<Context> context = CreateTestContext();
+    auto* queue = new WorkQueue(context);
+    queue->CreateThreads(GetNumLogicalCPUs() - 1);
+    context->RegisterSubsystem(queue);
+    RegisterSceneLibrary(context);
+    RegisterGraphicsLibrary(context);
+    context->RegisterFactory<TestDrawable>();
+
+    SharedPtr<Scene> scene(new Scene(context));
+    auto* octree = scene->CreateComponent<Octree>();
+    PODVector<Drawable*> drawables;
+    unsigned seed = 1;
+    for (unsigned i = 0; i < NUM_DRAWABLES; ++i)
+    {
+        Node* node = scene->CreateChild(String::EMPTY, LOCAL);
+        node->SetPosition(NextPosition(seed));
+        auto* drawable = node->CreateComponent<TestDrawable>(LOCAL);
+        drawable->SetSize(0.5f + 4.0f * NextRandom(seed));
+        drawables.Push(drawable);
+    }
+    unsigned frameNumber = 0;
+    UpdateOctree(octree, ++frameNumber);
+    TEST_CHECK(octree->GetNumDrawables() == NUM_DRAWABLES);
+
+    CheckQueries(octree, drawables);
+    BenchmarkQueries(octree, drawables);
+
+    // Moved drawables are queued for the octree update, which reinserts them and copies their boxes to the octants
+    for (unsigned i = 0; i < NUM_DRAWABLES; i += CHANGE_INTERVAL)
+    {
+        drawables[i]->GetNode()->SetPosition(NextPosition(seed));
+        TEST_CHECK(drawables[i]->IsUpdateQueued());
+    }
+    UpdateOctree(octree, ++frameNumber);
+    CheckQueries(octree, drawables);
+
+    // Drawables resized without queueing recalculate their box during the query. When the view processing does this in worker
+    // threads, the drawables queue themselves for the octree update instead of copying the box to the octant, which is being
+    // read by other threads
+    for (unsigned i = 0; i < NUM_DRAWABLES; i += CHANGE_INTERVAL)
+        static_cast<TestDrawable*>(drawables[i])->SetSize(0.5f + 4.0f * NextRandom(seed));
+    PODVector<Drawable*> result;
+    SharedPtr<FunctionThread> thread(new FunctionThread([&]() { QueryDrawables(octree, GetFrustum(0), result); }));
+    thread->Run();
+    thread->Stop();
+    unsigned numQueued = 0;
+    for (unsigned i = 0; i < NUM_DRAWABLES; i += CHANGE_INTERVAL)
+    {
+        // Drawables in the octants fully inside or outside the frustum were not tested, and are still dirty
+        if (!drawables[i]->IsWorldBoundingBoxDirty())
+        {
+            TEST_CHECK(drawables[i]->IsUpdateQueued());
+            ++numQueued;
+        }
+    }
+    TEST_CHECK(numQueued > 0);
+    PODVector<Drawable*> expected;
+    TestDrawables(drawables, GetFrustum(0), expected);
+    TEST_CHECK(result == expected);
+    PrintLine(ToString("%u resized drawables queued for the octree update from the worker thread", numQueued));
+
+    UpdateOctree(octree, ++frameNumber);
+    for (unsigned i = 0; i < NUM_DRAWABLES; ++i)
+        TEST_CHECK(!drawables[i]->IsUpdateQueued());
+    CheckQueries(octree, drawables);
+    return 0;
+}
@@ -0,0 +1,286 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Math/Vector3.h>
+
+#include "Test.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Count the allocations of the global operator new, unless the engine replaces it for allocation tracking. The MSVC debug heap
+// macros prevent replacing it in debug builds
+#if !defined(URHO3D_TRACK_ALLOCATIONS) && !(defined(_MSC_VER) && defined(_DEBUG))
+#define COUNT_ALLOCATIONS
+
+/// Number of allocations with the global operator new.
+static std::atomic<unsigned> numAllocations{0};
+
+void* operator new(std::size_t size)
+{
+    ++numAllocations;
+    if (void* ptr = malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    free(ptr);
+}
+#endif
+
+#include <Urho3D/DebugNew.h>
+
+/// Number of event types the receivers subscribe to.
+static const unsigned NUM_EVENT_TYPES = 200;
+/// Number of receivers subscribing to every event type.
+static const unsigned NUM_RECEIVERS = 50;
+/// Number of events sent in the dispatch benchmark.
+static const unsigned NUM_SENDS = 20000;
+/// Number of events with parameters sent in the payload benchmark.
+static const unsigned NUM_PAYLOAD_SENDS = 100000;
+/// Number of event types a single receiver subscribes to in the subscription benchmark.
+static const unsigned NUM_SUBSCRIPTIONS = 10000;
+
+/// Object counting the events it receives.
+class Receiver : public Object
+{
+    URHO3D_OBJECT(Receiver, Object);
+
+public:
+    /// Construct.
+    explicit Receiver(Context* context) :
+        Object(context),
+        count_(0)
+    {
+    }
+
+    /// Subscribe to an event from any sender.
+    void Subscribe(StringHash eventType) { SubscribeToEvent(eventType, URHO3D_HANDLER(Receiver, HandleEvent)); }
+    /// Subscribe to an event from a specific sender.
+    void Subscribe(Object* sender, StringHash eventType) { SubscribeToEvent(sender, eventType, URHO3D_HANDLER(Receiver, HandleEvent)); }
+    /// Subscribe to an event from any sender, and unsubscribe when it is received.
+    void SubscribeOnce(StringHash eventType) { SubscribeToEvent(eventType, URHO3D_HANDLER(Receiver, HandleEventOnce)); }
+
+    /// Handle an event by counting it.
+    void HandleEvent(StringHash eventType, VariantMap& eventData) { ++count_; }
+    /// Handle an event by counting it and unsubscribing from it.
+    void HandleEventOnce(StringHash eventType, VariantMap& eventData)
+    {
+        ++count_;
+        UnsubscribeFromEvent(eventType);
+    }
+
+    /// Number of events received.
+    unsigned count_;
+};
+
+/// Event with parameters, like the collision and update events.
+URHO3D_EVENT(E_TESTPAYLOAD, TestPayload)
+{
+    URHO3D_PARAM(P_SENDER, Sender);                    // Object pointer
+    URHO3D_PARAM(P_INDEX, Index);                      // int
+    URHO3D_PARAM(P_TIMESTEP, TimeStep);                // float
+    URHO3D_PARAM(P_POSITION, Position);                // Vector3
+    URHO3D_PARAM(P_NESTED, Nested);                    // bool
+}
+
+/// Object that reads the parameters of the events it receives, and sends a nested event with parameters in response.
+class PayloadReceiver : public Object
+{
+    URHO3D_OBJECT(PayloadReceiver, Object);
+
+public:
+    /// Construct and subscribe to the event.
+    explicit PayloadReceiver(Context* context) :
+        Object(context),
+        sum_(0)
+    {
+        SubscribeToEvent(E_TESTPAYLOAD, URHO3D_HANDLER(PayloadReceiver, HandlePayload));
+    }
+
+    /// Handle the event.
+    void HandlePayload(StringHash eventType, VariantMap& eventData)
+    {
+        using namespace TestPayload;
+
+        sum_ += eventData[P_INDEX].GetInt() + (int)eventData[P_POSITION].GetVector3().x_;
+        if (!eventData[P_NESTED].GetBool())
+            SendEvent(E_TESTPAYLOAD, P_SENDER, this, P_INDEX, 1, P_TIMESTEP, 0.0f, P_POSITION, Vector3::ZERO, P_NESTED, true);
+    }
+
+    /// Sum of the received parameters.
+    long long sum_;
+};
+
+/// Return an event type for the benchmarks.
+static StringHash GetEventType(unsigned index)
+{
+    return StringHash("TestEvent" + String(index));
+}
+
+/// Send events to receivers that each subscribe to many event types.
+static void BenchmarkDispatch(Context* context)
+{
+    PODVector<StringHash> eventTypes;
+    for (unsigned i = 0; i < NUM_EVENT_TYPES; ++i)
+        eventTypes.Push(GetEventType(i));
+
+    Vector<SharedPtr<Receiver> > receivers;
+    for (unsigned i = 0; i < NUM_RECEIVERS; ++i)
+    {
+        receivers.Push(MakeShared<Receiver>(context));
+        for (unsigned j = 0; j < NUM_EVENT_TYPES; ++j)
+            receivers[i]->Subscribe(eventTypes[j]);
+    }
+
+    SharedPtr<Object> sender(new Receiver(context));
+    HiresTimer timer;
+    for (unsigned i = 0; i < NUM_SENDS; ++i)
+        sender->SendEvent(eventTypes[i % NUM_EVENT_TYPES]);
+    long long usec = timer.GetUSec(false);
+
+    for (unsigned i = 0; i < NUM_RECEIVERS; ++i)
+        TEST_CHECK(receivers[i]->count_ == NUM_SENDS);
+    PrintBenchmark(ToString("SendEvent, %u receivers of %u event types", NUM_RECEIVERS, NUM_EVENT_TYPES), NUM_SENDS, usec);
+}
+
+/// Subscribe a receiver to many event types and unsubscribe again.
+static void BenchmarkSubscription(Context* context)
+{
+    PODVector<StringHash> eventTypes;
+    for (unsigned i = 0; i < NUM_SUBSCRIPTIONS; ++i)
+        eventTypes.Push(GetEventType(i));
+
+    SharedPtr<Receiver> receiver(new Receiver(context));
+    HiresTimer timer;
+    for (unsigned i = 0; i < NUM_SUBSCRIPTIONS; ++i)
+        receiver->Subscribe(eventTypes[i]);
+    long long subscribeUSec = timer.GetUSec(true);
+
+    // Subscribing again replaces the handler
+    for (unsigned i = 0; i < NUM_SUBSCRIPTIONS; ++i)
+        receiver->Subscribe(eventTypes[i]);
+    long long resubscribeUSec = timer.GetUSec(true);
+
+    for (unsigned i = 0; i < NUM_SUBSCRIPTIONS; ++i)
+        TEST_CHECK(receiver->HasSubscribedToEvent(eventTypes[i]));
+    receiver->SendEvent(eventTypes[NUM_SUBSCRIPTIONS / 2]);
+    TEST_CHECK(receiver->count_ == 1);
+
+    timer.Reset();
+    for (unsigned i = 0; i < NUM_SUBSCRIPTIONS; ++i)
+        receiver->UnsubscribeFromEvent(eventTypes[i]);
+    long long unsubscribeUSec = timer.GetUSec(false);
+
+    for (unsigned i = 0; i < NUM_SUBSCRIPTIONS; ++i)
+        TEST_CHECK(!receiver->HasSubscribedToEvent(eventTypes[i]));
+    PrintBenchmark("SubscribeToEvent", NUM_SUBSCRIPTIONS, subscribeUSec);
+    PrintBenchmark("SubscribeToEvent again", NUM_SUBSCRIPTIONS, resubscribeUSec);
+    PrintBenchmark("UnsubscribeFromEvent", NUM_SUBSCRIPTIONS, unsubscribeUSec);
+}
+
+/// Send events with parameters, filled through the event data map like the engine does. The maps of each nesting level are
+/// reused, so after the first event no allocations are expected.
+static void BenchmarkPayload(Context* context)
+{
+    using namespace TestPayload;
+
+    SharedPtr<PayloadReceiver> receiver(new PayloadReceiver(context));
+    SharedPtr<Object> sender(new Receiver(context));
+    long long expectedSum = 0;
+
+    HiresTimer timer;
+#ifdef COUNT_ALLOCATIONS
+    unsigned allocationsBefore = 0;
+#endif
+    for (unsigned i = 0; i < NUM_PAYLOAD_SENDS; ++i)
+    {
+        VariantMap& eventData = sender->GetEventDataMap();
+        eventData[P_SENDER] = sender;
+        eventData[P_INDEX] = (int)(i & 0xffu);
+        eventData[P_TIMESTEP] = 0.016f;
+        eventData[P_POSITION] = Vector3(2.0f, 0.0f, 0.0f);
+        eventData[P_NESTED] = false;
+        sender->SendEvent(E_TESTPAYLOAD, eventData);
+        expectedSum += (i & 0xffu) + 2 + 1;
+
+#ifdef COUNT_ALLOCATIONS
+        // The first event allocates the maps and their nodes
+        if (!i)
+            allocationsBefore = numAllocations;
+#endif
+    }
+    long long usec = timer.GetUSec(false);
+
+    TEST_CHECK(receiver->sum_ == expectedSum);
+#ifdef COUNT_ALLOCATIONS
+    unsigned allocations = numAllocations - allocationsBefore;
+    PrintLine(ToString("SendEvent with parameters: %u allocations after the first event", allocations));
+    TEST_CHECK(allocations == 0);
+#endif
+    PrintBenchmark("SendEvent with parameters and a nested event", NUM_PAYLOAD_SENDS, usec);
+}
+
+/// Check that sender-specific handlers receive only the events of their sender, and that a handler may unsubscribe itself.
+static void TestSenders(Context* context)
+{
+    const StringHash eventType = GetEventType(0);
+    SharedPtr<Receiver> first(new Receiver(context));
+    SharedPtr<Receiver> second(new Receiver(context));
+    SharedPtr<Receiver> fromFirst(new Receiver(context));
+    SharedPtr<Receiver> fromAny(new Receiver(context));
+    SharedPtr<Receiver> once(new Receiver(context));
+
+    fromFirst->Subscribe(first, eventType);
+    fromAny->Subscribe(eventType);
+    once->SubscribeOnce(eventType);
+
+    first->SendEvent(eventType);
+    second->SendEvent(eventType);
+    second->SendEvent(eventType);
+
+    TEST_CHECK(fromFirst->count_ == 1);
+    TEST_CHECK(fromAny->count_ == 3);
+    TEST_CHECK(once->count_ == 1);
+    TEST_CHECK(fromFirst->HasSubscribedToEvent(first, eventType));
+    TEST_CHECK(!once->HasSubscribedToEvent(eventType));
+}
+
+int main(int argc, char** argv)
+{
+    SharedPtr<Context> context = CreateTestContext();
+
+    TestSenders(context);
+    BenchmarkDispatch(context);
+    BenchmarkPayload(context);
+    BenchmarkSubscription(context);
+    return EXIT_SUCCESS;
+}
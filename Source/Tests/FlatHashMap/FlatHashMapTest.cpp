@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Container/FlatHashMap.h>
+#include <Urho3D/Container/FlatHashSet.h>
+#include <Urho3D/Container/HashMap.h>
+
+#include "Test.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Number of keys inserted in the benchmarks.
+static const unsigned NUM_KEYS = 200000;
+/// Number of random operations in the comparison test.
+static const unsigned NUM_OPERATIONS = 500000;
+/// Range of the keys in the comparison test. Small, so that the same keys are inserted and erased repeatedly.
+static const unsigned KEY_RANGE = 5000;
+
+/// Return the next pseudo-random number.
+static unsigned NextRandom(unsigned& seed)
+{
+    seed = seed * 1664525 + 1013904223;
+    return seed >> 8u;
+}
+
+/// Return a scattered key. Different indices give different keys.
+static unsigned GetKey(unsigned index)
+{
+    return index * 2654435761u;
+}
+
+/// Measure inserting, finding and erasing keys in a map type.
+template <class T> void BenchmarkMap(const String& name, const PODVector<unsigned>& keys)
+{
+    T map;
+    HiresTimer timer;
+    for (unsigned i = 0; i < keys.Size(); ++i)
+        map[keys[i]] = i;
+    long long insertUSec = timer.GetUSec(true);
+
+    unsigned found = 0;
+    for (unsigned i = 0; i < keys.Size(); ++i)
+        found += map.Find(keys[i]) != map.End() ? 1 : 0;
+    long long findUSec = timer.GetUSec(true);
+
+    for (unsigned i = 0; i < keys.Size(); ++i)
+        found += map.Contains(GetKey(keys.Size() + i)) ? 1 : 0;
+    long long missUSec = timer.GetUSec(true);
+
+    unsigned erased = 0;
+    for (unsigned i = 0; i < keys.Size(); ++i)
+        erased += map.Erase(keys[i]) ? 1 : 0;
+    long long eraseUSec = timer.GetUSec(false);
+
+    TEST_CHECK(found == keys.Size());
+    TEST_CHECK(erased == keys.Size());
+    TEST_CHECK(map.Size() == 0);
+    PrintBenchmark(name + " insert", keys.Size(), insertUSec);
+    PrintBenchmark(name + " find", keys.Size(), findUSec);
+    PrintBenchmark(name + " find missing", keys.Size(), missUSec);
+    PrintBenchmark(name + " erase", keys.Size(), eraseUSec);
+}
+
+/// Apply the same random inserts and erases to FlatHashMap, FlatHashSet and HashMap, and check that they agree.
+static void TestAgainstHashMap()
+{
+    FlatHashMap<unsigned, unsigned> flatMap;
+    FlatHashSet<unsigned> flatSet;
+    HashMap<unsigned, unsigned> map;
+    unsigned seed = 1;
+
+    for (unsigned i = 0; i < NUM_OPERATIONS; ++i)
+    {
+        unsigned key = NextRandom(seed) % KEY_RANGE;
+        if (NextRandom(seed) % 3)
+        {
+            flatMap[key] = i;
+            flatSet.Insert(key);
+            map[key] = i;
+        }
+        else
+        {
+            bool erased = map.Erase(key);
+            TEST_CHECK(flatMap.Erase(key) == erased);
+            TEST_CHECK(flatSet.Erase(key) == erased);
+        }
+
+        // Clearing keeps the capacity, and the maps must stay usable afterward
+        if (i % 100000 == 99999)
+        {
+            flatMap.Clear();
+            flatSet.Clear();
+            map.Clear();
+        }
+    }
+
+    TEST_CHECK(flatMap.Size() == map.Size());
+    TEST_CHECK(flatSet.Size() == map.Size());
+    for (HashMap<unsigned, unsigned>::ConstIterator i = map.Begin(); i != map.End(); ++i)
+    {
+        FlatHashMap<unsigned, unsigned>::ConstIterator j = flatMap.Find(i->first_);
+        TEST_CHECK(j != flatMap.End() && j->second_ == i->second_);
+        TEST_CHECK(flatSet.Contains(i->first_));
+    }
+
+    unsigned numIterated = 0;
+    for (FlatHashMap<unsigned, unsigned>::ConstIterator i = flatMap.Begin(); i != flatMap.End(); ++i)
+    {
+        TEST_CHECK(map.Contains(i->first_));
+        ++numIterated;
+    }
+    TEST_CHECK(numIterated == map.Size());
+}
+
+int main(int argc, char** argv)
+{
+    SharedPtr<Context> context = CreateTestContext();
+
+    TestAgainstHashMap();
+
+    PODVector<unsigned> keys(NUM_KEYS);
+    for (unsigned i = 0; i < NUM_KEYS; ++i)
+        keys[i] = GetKey(i);
+
+    BenchmarkMap<HashMap<unsigned, unsigned> >("HashMap", keys);
+    BenchmarkMap<FlatHashMap<unsigned, unsigned> >("FlatHashMap", keys);
+    return EXIT_SUCCESS;
+}
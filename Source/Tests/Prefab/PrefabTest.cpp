@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/Light.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Scene/Node.h>
+#include <Urho3D/Scene/Prefab.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SplinePath.h>
+
+#include "Test.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Number of instances spawned.
+static const unsigned NUM_INSTANCES = 1000;
+/// Number of child nodes in the prefab.
+static const unsigned NUM_CHILDREN = 8;
+/// Number of child nodes used as spline path control points. Kept low, as the path recalculates its length by sampling whenever
+/// a control point moves, which would dominate the spawn time.
+static const unsigned NUM_CONTROL_POINTS = 2;
+
+/// Create the object to make a prefab of: a node with tags, a variable and a spline path through its first children, each child
+/// having a light and a child node of its own.
+static void CreateObject(Node* node)
+{
+    node->SetName("Object");
+    node->AddTag("Spawned");
+    node->SetVar("Health", 100);
+
+    auto* path = node->CreateComponent<SplinePath>();
+    for (unsigned i = 0; i < NUM_CHILDREN; ++i)
+    {
+        Node* child = node->CreateChild(ToString("Child%u", i));
+        child->SetPosition(Vector3((float)i, 1.0f, 0.5f * i));
+        child->SetRotation(Quaternion(10.0f * i, Vector3::UP));
+        auto* light = child->CreateComponent<Light>();
+        light->SetColor(Color(0.1f * i, 0.5f, 1.0f));
+        light->SetRange(5.0f + i);
+        child->CreateChild("Grandchild")->SetScale(0.5f);
+        if (i < NUM_CONTROL_POINTS)
+            path->AddControlPoint(child);
+    }
+    // SetControlledNode() does not update the saved ID, so set the attribute
+    path->SetControlledIdAttr(node->GetChild(0u)->GetID());
+    path->ApplyAttributes();
+}
+
+/// Return the position of an instance.
+static Vector3 GetInstancePosition(unsigned index)
+{
+    return Vector3((float)(index % 32), 0.0f, (float)(index / 32)) * 10.0f;
+}
+
+/// Spawn the instances by parsing the XML data each time.
+static long long SpawnXML(Scene* scene, const VectorBuffer& data)
+{
+    HiresTimer timer;
+    for (unsigned i = 0; i < NUM_INSTANCES; ++i)
+    {
+        MemoryBuffer source(data.GetData(), data.GetSize());
+        TEST_CHECK(scene->InstantiateXML(source, GetInstancePosition(i), Quaternion::IDENTITY));
+    }
+    return timer.GetUSec(false);
+}
+
+/// Spawn the instances from the prefab.
+static long long SpawnPrefab(Scene* scene, const Prefab* prefab)
+{
+    HiresTimer timer;
+    for (unsigned i = 0; i < NUM_INSTANCES; ++i)
+        TEST_CHECK(scene->InstantiatePrefab(prefab, GetInstancePosition(i), Quaternion::IDENTITY));
+    return timer.GetUSec(false);
+}
+
+/// Return a scene saved as XML.
+static String SaveScene(Scene* scene)
+{
+    VectorBuffer buffer;
+    TEST_CHECK(scene->SaveXML(buffer));
+    return String(reinterpret_cast<const char*>(buffer.GetData()), buffer.GetSize());
+}
+
+int main(int argc, char** argv)
+{
+    SharedPtr<Context> context = CreateTestContext();
+    // The light's texture attribute is resolved through the resource cache
+    context->RegisterSubsystem(new ResourceCache(context));
+    RegisterSceneLibrary(context);
+    RegisterGraphicsLibrary(context);
+
+    VectorBuffer data;
+    {
+        SharedPtr<Scene> templateScene(new Scene(context));
+        Node* object = templateScene->CreateChild();
+        CreateObject(object);
+        TEST_CHECK(object->SaveXML(data));
+    }
+
+    SharedPtr<Prefab> prefab(new Prefab(context));
+    {
+        MemoryBuffer source(data.GetData(), data.GetSize());
+        TEST_CHECK(prefab->Load(source));
+    }
+    TEST_CHECK(prefab->GetNumNodes() == 1 + NUM_CHILDREN * 2);
+    TEST_CHECK(prefab->GetNumComponents() == 1 + NUM_CHILDREN);
+
+    SharedPtr<Scene> xmlScene(new Scene(context));
+    long long xmlUSec = SpawnXML(xmlScene, data);
+    SharedPtr<Scene> prefabScene(new Scene(context));
+    long long prefabUSec = SpawnPrefab(prefabScene, prefab);
+
+    // The objects and IDs are created in the same order, so the scenes must save identically, including the spline paths
+    // referring to the nodes of their own instance
+    TEST_CHECK(SaveScene(xmlScene) == SaveScene(prefabScene));
+    Node* lastInstance = prefabScene->GetChildren().Back();
+    auto* path = lastInstance->GetComponent<SplinePath>();
+    TEST_CHECK(path && path->GetControlledNode() == lastInstance->GetChild(0u));
+    TEST_CHECK(path->GetControlPointIdsAttr().Size() == NUM_CONTROL_POINTS + 1);
+    TEST_CHECK(path->GetControlPointIdsAttr()[1].GetUInt() == lastInstance->GetChild(0u)->GetID());
+
+    PrintBenchmark("InstantiateXML", NUM_INSTANCES, xmlUSec);
+    PrintBenchmark("InstantiatePrefab", NUM_INSTANCES, prefabUSec);
+    return EXIT_SUCCESS;
+}
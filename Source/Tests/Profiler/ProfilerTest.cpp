@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/Profiler.h>
+
+#include "Test.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Time a block in a worker thread.
+static void ProfileBlock(Profiler* profiler)
+{
+    profiler->BeginBlock("WorkerBlock");
+    profiler->EndBlock();
+}
+
+/// Return the number of worker threads the profiler has data for.
+static unsigned CountThreads(Profiler* profiler)
+{
+    const String& output = profiler->PrintData(true, true);
+    unsigned count = 0;
+    for (unsigned i = output.Find("Thread "); i != String::NPOS; i = output.Find("Thread ", i + 1))
+        ++count;
+    return count;
+}
+
+int main(int argc, char** argv)
+{
+    SharedPtr<Context> context = CreateTestContext();
+    SharedPtr<Profiler> first(new Profiler(context));
+    SharedPtr<Profiler> second(new Profiler(context));
+    SharedPtr<Profiler> replacement;
+    unsigned numFirstThreads = 0;
+
+    // The same worker thread switches between the profilers, and then uses a new profiler that may take the address of a destroyed one
+    FunctionThread thread([&]()
+    {
+        ProfileBlock(first);
+        ProfileBlock(second);
+        ProfileBlock(first);
+        numFirstThreads = CountThreads(first);
+
+        first.Reset();
+        replacement = new Profiler(context);
+        ProfileBlock(replacement);
+    });
+    TEST_CHECK(thread.Run());
+    thread.Stop();
+
+    TEST_CHECK(numFirstThreads == 1);
+    TEST_CHECK(CountThreads(second) == 1);
+    TEST_CHECK(CountThreads(replacement) == 1);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Container/RingQueue.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/IO/IOEvents.h>
+#include <Urho3D/IO/Log.h>
+
+#include "Test.h"
+
+#include <atomic>
+#include <cstdio>
+
+#include <Urho3D/DebugNew.h>
+
+/// Capacity of the tested queues. Small so that the threads keep running into a full or empty queue.
+static const unsigned QUEUE_CAPACITY = 1024;
+/// Number of values sent through the single-producer queue.
+static const unsigned NUM_SPSC_VALUES = 4000000;
+/// Number of producer and of consumer threads on the multi-producer queue.
+static const unsigned NUM_MPMC_THREADS = 4;
+/// Number of values each producer sends through the multi-producer queue. Must fit in the low 24 bits.
+static const unsigned NUM_MPMC_VALUES = 1000000;
+/// Number of threads writing to the log.
+static const unsigned NUM_LOG_THREADS = 4;
+/// Number of messages each logging thread writes. Together they exceed the log's queue several times over.
+static const unsigned NUM_LOG_MESSAGES = 2500;
+
+/// Single producer: the consumer must receive every value exactly once and in order.
+static void TestSPSCQueue()
+{
+    SPSCQueue<unsigned> queue(QUEUE_CAPACITY);
+    FunctionThread producer([&queue]()
+    {
+        for (unsigned i = 0; i < NUM_SPSC_VALUES; ++i)
+        {
+            while (!queue.TryPush(i))
+                Time::Sleep(0);
+        }
+    });
+
+    HiresTimer timer;
+    TEST_CHECK(producer.Run());
+
+    for (unsigned i = 0; i < NUM_SPSC_VALUES; ++i)
+    {
+        unsigned value;
+        while (!queue.TryPop(value))
+            Time::Sleep(0);
+        TEST_CHECK(value == i);
+    }
+
+    producer.Stop();
+    PrintBenchmark("SPSCQueue", NUM_SPSC_VALUES, timer.GetUSec(false));
+}
+
+/// Multiple producers and consumers: every value must arrive exactly once, and a consumer never sees the values of one
+/// producer out of order. Each value holds its producer index in the high 8 bits.
+static void TestMPMCQueue()
+{
+    MPMCQueue<unsigned> queue(QUEUE_CAPACITY);
+    const unsigned numValues = NUM_MPMC_THREADS * NUM_MPMC_VALUES;
+    std::atomic<unsigned> numFinishedProducers(0);
+    std::atomic<bool> reordered(false);
+    Vector<PODVector<unsigned> > received(NUM_MPMC_THREADS);
+    Vector<SharedPtr<FunctionThread> > threads;
+
+    for (unsigned p = 0; p < NUM_MPMC_THREADS; ++p)
+    {
+        threads.Push(SharedPtr<FunctionThread>(new FunctionThread([&queue, &numFinishedProducers, p]()
+        {
+            for (unsigned i = 0; i < NUM_MPMC_VALUES; ++i)
+            {
+                while (!queue.TryPush(p << 24u | i))
+                    Time::Sleep(0);
+            }
+            ++numFinishedProducers;
+        })));
+    }
+
+    for (unsigned c = 0; c < NUM_MPMC_THREADS; ++c)
+    {
+        PODVector<unsigned>& dest = received[c];
+        threads.Push(SharedPtr<FunctionThread>(new FunctionThread([&queue, &numFinishedProducers, &reordered, &dest, numValues]()
+        {
+            PODVector<unsigned> nextValues(NUM_MPMC_THREADS, 0);
+            dest.Reserve(numValues);
+
+            for (;;)
+            {
+                // Check the producers before popping, so that an empty queue afterward means nothing more will come
+                bool producersFinished = numFinishedProducers.load() == NUM_MPMC_THREADS;
+                unsigned value;
+                if (!queue.TryPop(value))
+                {
+                    if (producersFinished)
+                        break;
+                    Time::Sleep(0);
+                    continue;
+                }
+
+                unsigned producer = value >> 24u;
+                unsigned index = value & 0xffffffu;
+                if (index < nextValues[producer])
+                    reordered = true;
+                nextValues[producer] = index + 1;
+                dest.Push(value);
+            }
+        })));
+    }
+
+    HiresTimer timer;
+    for (unsigned i = 0; i < threads.Size(); ++i)
+        TEST_CHECK(threads[i]->Run());
+    threads.Clear();
+    long long usec = timer.GetUSec(false);
+
+    TEST_CHECK(!reordered);
+
+    PODVector<unsigned char> counts(numValues, 0);
+    for (unsigned c = 0; c < received.Size(); ++c)
+    {
+        for (unsigned i = 0; i < received[c].Size(); ++i)
+        {
+            unsigned value = received[c][i];
+            TEST_CHECK(!counts[(value >> 24u) * NUM_MPMC_VALUES + (value & 0xffffffu)]++);
+        }
+    }
+    TEST_CHECK(!counts.Contains(0));
+
+    PrintBenchmark("MPMCQueue", numValues, usec);
+}
+
+/// Log from worker threads faster than the log's queue holds. The messages of each thread must arrive in order.
+static void TestLogOrder(Context* context)
+{
+    SharedPtr<Log> log(new Log(context));
+    context->RegisterSubsystem(log);
+    log->SetQuiet(true);
+
+    PODVector<unsigned> nextMessages(NUM_LOG_THREADS, 0);
+    log->SubscribeToEvent(E_LOGMESSAGE, [&nextMessages](StringHash eventType, VariantMap& eventData)
+    {
+        using namespace LogMessage;
+
+        // The message is formatted with the level and possibly a timestamp, so look for the text written by the threads
+        const String& message = eventData[P_MESSAGE].GetString();
+        unsigned start = message.Find("Log stress thread ");
+        unsigned thread, index;
+        if (start == String::NPOS || sscanf(message.CString() + start, "Log stress thread %u message %u", &thread, &index) != 2)
+            return;
+
+        TEST_CHECK(thread < NUM_LOG_THREADS);
+        TEST_CHECK(index == nextMessages[thread]);
+        ++nextMessages[thread];
+    });
+
+    std::atomic<unsigned> numFinishedThreads(0);
+    Vector<SharedPtr<FunctionThread> > threads;
+    for (unsigned t = 0; t < NUM_LOG_THREADS; ++t)
+    {
+        threads.Push(SharedPtr<FunctionThread>(new FunctionThread([&numFinishedThreads, t]()
+        {
+            for (unsigned i = 0; i < NUM_LOG_MESSAGES; ++i)
+                URHO3D_LOGINFOF("Log stress thread %u message %u", t, i);
+            ++numFinishedThreads;
+        })));
+        TEST_CHECK(threads.Back()->Run());
+    }
+
+    // The log delivers the messages from other threads at the end of each frame
+    while (numFinishedThreads.load() < NUM_LOG_THREADS)
+    {
+        log->SendEvent(E_ENDFRAME);
+        Time::Sleep(0);
+    }
+    threads.Clear();
+    log->SendEvent(E_ENDFRAME);
+
+    for (unsigned t = 0; t < NUM_LOG_THREADS; ++t)
+        TEST_CHECK(nextMessages[t] == NUM_LOG_MESSAGES);
+    PrintLine(ToString("Log: %u threads wrote %u messages each, all arrived in order", NUM_LOG_THREADS, NUM_LOG_MESSAGES));
+}
+
+int main(int argc, char** argv)
+{
+    SharedPtr<Context> context = CreateTestContext();
+
+    TestSPSCQueue();
+    TestMPMCQueue();
+#ifdef URHO3D_LOGGING
+    TestLogOrder(context);
+#endif
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Scene/Node.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "Test.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Number of nodes removed and created at once in the burst test.
+static const unsigned NUM_BURST_NODES = 100000;
+/// Number of live nodes in the soak test.
+static const unsigned NUM_LIVE_NODES = 10000;
+/// Number of node spawn and destroy cycles in the soak test.
+static const unsigned NUM_SOAK_CYCLES = 200000;
+/// Freed ID reuse delay in seconds in the timed tests. Long enough that the test steps before a deadline finish in time.
+static const float REUSE_DELAY = 0.5f;
+/// Milliseconds to sleep for the reuse delay to pass.
+static const unsigned REUSE_DELAY_MSEC = 500;
+
+/// Return the next pseudo-random number.
+static unsigned NextRandom(unsigned& seed)
+{
+    seed = seed * 1664525 + 1013904223;
+    return seed;
+}
+
+/// Create a node and remove it, and return its ID.
+static unsigned CreateAndRemove(Scene* scene)
+{
+    Node* node = scene->CreateChild();
+    unsigned id = node->GetID();
+    node->Remove();
+    return id;
+}
+
+/// Check that without the clock initialized by the Time subsystem freed IDs are not reused, even without a delay.
+static void TestNoClock()
+{
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Scene> scene(new Scene(context));
+    scene->SetFreedIDReuseDelay(0.0f);
+
+    unsigned id = CreateAndRemove(scene);
+    TEST_CHECK(CreateAndRemove(scene) != id);
+}
+
+/// Check that without a delay a freed ID is reused immediately.
+static void TestNoDelay(Context* context)
+{
+    SharedPtr<Scene> scene(new Scene(context));
+    scene->SetFreedIDReuseDelay(0.0f);
+    TEST_CHECK(scene->GetFreedIDReuseDelay() == 0.0f);
+
+    unsigned id = CreateAndRemove(scene);
+    TEST_CHECK(CreateAndRemove(scene) == id);
+}
+
+/// Check that IDs removed in a burst are not reused in the same frame, regardless of how many there are, and are reused oldest
+/// first after the delay.
+static void TestBurst(Context* context)
+{
+    SharedPtr<Scene> scene(new Scene(context));
+    scene->SetFreedIDReuseDelay(REUSE_DELAY);
+    TEST_CHECK(scene->GetFreedIDReuseDelay() == REUSE_DELAY);
+
+    PODVector<Node*> nodes;
+    for (unsigned i = 0; i < NUM_BURST_NODES; ++i)
+        nodes.Push(scene->CreateChild());
+    unsigned firstID = nodes[0]->GetID();
+    unsigned lastID = nodes.Back()->GetID();
+    scene->RemoveAllChildren();
+
+    for (unsigned i = 0; i < NUM_BURST_NODES; ++i)
+    {
+        unsigned id = scene->CreateChild()->GetID();
+        TEST_CHECK(id < firstID || id > lastID);
+    }
+
+    // The children are removed starting from the last, so its ID was freed first
+    Time::Sleep(REUSE_DELAY_MSEC + 10);
+    TEST_CHECK(scene->CreateChild()->GetID() == lastID);
+}
+
+/// Check that an ID that is freed, taken explicitly and freed again is reused only after the delay from the second free, and
+/// only once.
+static void TestRefreed(Context* context)
+{
+    SharedPtr<Scene> scene(new Scene(context));
+    scene->SetFreedIDReuseDelay(REUSE_DELAY);
+
+    unsigned id = CreateAndRemove(scene);
+    Time::Sleep(REUSE_DELAY_MSEC / 2);
+    scene->CreateChild(id, REPLICATED)->Remove();
+
+    // Past the deadline of the first free, but not the second
+    Time::Sleep(REUSE_DELAY_MSEC / 2 + 100);
+    TEST_CHECK(CreateAndRemove(scene) != id);
+
+    // Past the deadline of the second free. The other ID freed above is not due yet
+    Time::Sleep(REUSE_DELAY_MSEC / 2);
+    Node* node = scene->CreateChild();
+    TEST_CHECK(node->GetID() == id);
+    TEST_CHECK(scene->CreateChild()->GetID() != id);
+}
+
+/// Spawn and destroy nodes constantly with a set of live nodes, and check that freed IDs are reused so that the IDs stay compact.
+static void TestSoak(Context* context)
+{
+    SharedPtr<Scene> scene(new Scene(context));
+    scene->SetFreedIDReuseDelay(0.0f);
+
+    PODVector<Node*> nodes;
+    for (unsigned i = 0; i < NUM_LIVE_NODES; ++i)
+        nodes.Push(scene->CreateChild());
+
+    unsigned seed = 1;
+    unsigned maxID = 0;
+    HiresTimer timer;
+    for (unsigned i = 0; i < NUM_SOAK_CYCLES; ++i)
+    {
+        unsigned index = NextRandom(seed) % NUM_LIVE_NODES;
+        nodes[index]->Remove();
+        nodes[index] = scene->CreateChild();
+        maxID = Max(maxID, nodes[index]->GetID());
+    }
+    long long usec = timer.GetUSec(false);
+
+    PrintLine(ToString("Maximum node ID %u with %u live nodes", maxID, NUM_LIVE_NODES));
+    TEST_CHECK(maxID <= NUM_LIVE_NODES + 1);
+    PrintBenchmark("Node spawn and destroy cycles", NUM_SOAK_CYCLES, usec);
+}
+
+int main(int argc, char** argv)
+{
+    // Must run before the Time subsystem is created, as it initializes the clock for the whole process
+    TestNoClock();
+
+    SharedPtr<Context> context = CreateTestContext();
+    RegisterSceneLibrary(context);
+
+    TestNoDelay(context);
+    TestBurst(context);
+    TestRefreed(context);
+    TestSoak(context);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,196 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/Light.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Scene/Node.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "Test.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <Urho3D/DebugNew.h>
+
+/// Number of nodes in the benchmark scene.
+static const unsigned NUM_NODES = 50000;
+/// Every this many nodes has a light component.
+static const unsigned LIGHT_INTERVAL = 4;
+
+/// Scene file formats.
+enum SceneFormat
+{
+    FORMAT_BINARY = 0,
+    FORMAT_XML,
+    FORMAT_JSON,
+    FORMAT_MAPPED,
+    MAX_SCENE_FORMATS
+};
+
+/// Names of the scene file formats.
+static const char* formatNames[] = {"binary", "XML", "JSON", "mapped"};
+/// Names of the files the scenes are saved to.
+static const char* fileNames[] = {"SceneMappedTest.bin", "SceneMappedTest.xml", "SceneMappedTest.json", "SceneMappedTest.uscm"};
+
+/// Return the next pseudo-random number.
+static unsigned NextRandom(unsigned& seed)
+{
+    seed = seed * 1664525 + 1013904223;
+    return seed;
+}
+
+/// Return a pseudo-random float with a value in a range typical for scene attributes.
+static float NextFloat(unsigned& seed)
+{
+    return (float)(NextRandom(seed) >> 8u) / (float)(1u << 24u) * 2000.0f - 1000.0f;
+}
+
+/// Create the benchmark scene, with a node hierarchy, variables and light components.
+static SharedPtr<Scene> CreateScene(Context* context)
+{
+    SharedPtr<Scene> scene(new Scene(context));
+    unsigned seed = 1;
+    Node* parent = scene;
+    for (unsigned i = 0; i < NUM_NODES; ++i)
+    {
+        // Groups of up to 16 nodes
+        if (!(i % 16))
+            parent = scene;
+        Node* node = parent->CreateChild(ToString("Node%u", i));
+        parent = node;
+        node->SetPosition(Vector3(NextFloat(seed), NextFloat(seed), NextFloat(seed)));
+        node->SetRotation(Quaternion(NextFloat(seed), Vector3::UP));
+        node->SetScale(1.0f + NextFloat(seed) / 1000.0f);
+        node->SetVar("Index", i);
+
+        if (!(i % LIGHT_INTERVAL))
+        {
+            auto* light = node->CreateComponent<Light>();
+            light->SetColor(Color(NextFloat(seed) / 1000.0f, 0.5f, 1.0f));
+            light->SetRange(NextFloat(seed) / 100.0f + 20.0f);
+        }
+    }
+    return scene;
+}
+
+/// Save a scene in a format to a file.
+static void SaveScene(Context* context, Scene* scene, SceneFormat format)
+{
+    File file(context, fileNames[format], FILE_WRITE);
+    TEST_CHECK(file.IsOpen());
+    switch (format)
+    {
+    case FORMAT_BINARY:
+        TEST_CHECK(scene->Save(file));
+        break;
+    case FORMAT_XML:
+        TEST_CHECK(scene->SaveXML(file));
+        break;
+    case FORMAT_JSON:
+        TEST_CHECK(scene->SaveJSON(file));
+        break;
+    default:
+        TEST_CHECK(scene->SaveMapped(file));
+        break;
+    }
+}
+
+/// Load a scene from a file in a format, and return the time taken.
+static long long LoadScene(Context* context, Scene* scene, SceneFormat format)
+{
+    HiresTimer timer;
+    if (format == FORMAT_MAPPED)
+        TEST_CHECK(scene->LoadMapped(fileNames[format]));
+    else
+    {
+        File file(context, fileNames[format]);
+        TEST_CHECK(file.IsOpen());
+        if (format == FORMAT_BINARY)
+            TEST_CHECK(scene->Load(file));
+        else if (format == FORMAT_XML)
+            TEST_CHECK(scene->LoadXML(file));
+        else
+            TEST_CHECK(scene->LoadJSON(file));
+    }
+    return timer.GetUSec(false);
+}
+
+/// Return a scene saved in the binary format, for comparing scenes.
+static VectorBuffer SaveBinary(Scene* scene)
+{
+    VectorBuffer buffer;
+    TEST_CHECK(scene->Save(buffer));
+    return buffer;
+}
+
+/// Check that two buffers hold the same data.
+static bool Equals(const VectorBuffer& lhs, const VectorBuffer& rhs)
+{
+    return lhs.GetSize() == rhs.GetSize() && !memcmp(lhs.GetData(), rhs.GetData(), lhs.GetSize());
+}
+
+int main(int argc, char** argv)
+{
+    SharedPtr<Context> context = CreateTestContext();
+    // The light's texture attributes are resolved through the resource cache
+    context->RegisterSubsystem(new ResourceCache(context));
+    RegisterSceneLibrary(context);
+    RegisterGraphicsLibrary(context);
+
+    SharedPtr<Scene> scene = CreateScene(context);
+    VectorBuffer original = SaveBinary(scene);
+
+    // Every format must load back to a scene identical to the original
+    long long loadUSec[MAX_SCENE_FORMATS];
+    for (unsigned i = 0; i < MAX_SCENE_FORMATS; ++i)
+    {
+        auto format = (SceneFormat)i;
+        SaveScene(context, scene, format);
+        SharedPtr<Scene> loadedScene(new Scene(context));
+        loadUSec[i] = LoadScene(context, loadedScene, format);
+        TEST_CHECK(Equals(SaveBinary(loadedScene), original));
+    }
+
+    // The mapped format is also accepted by Load(), read into memory
+    {
+        File file(context, fileNames[FORMAT_MAPPED]);
+        SharedPtr<Scene> loadedScene(new Scene(context));
+        TEST_CHECK(loadedScene->Load(file));
+        TEST_CHECK(Equals(SaveBinary(loadedScene), original));
+    }
+
+    for (unsigned i = 0; i < MAX_SCENE_FORMATS; ++i)
+    {
+        File file(context, fileNames[i]);
+        PrintLine(ToString("Scene %s size %u bytes", formatNames[i], file.GetSize()));
+        PrintBenchmark(ToString("Load scene %s nodes", formatNames[i]), NUM_NODES, loadUSec[i]);
+    }
+
+    for (unsigned i = 0; i < MAX_SCENE_FORMATS; ++i)
+        remove(fileNames[i]);
+    return EXIT_SUCCESS;
+}
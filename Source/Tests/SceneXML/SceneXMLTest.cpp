@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Scene/Node.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "Test.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <Urho3D/DebugNew.h>
+
+/// Number of nodes in the benchmark scene.
+static const unsigned NUM_NODES = 50000;
+/// Number of values in the number conversion tests.
+static const unsigned NUM_VALUES = 1000000;
+/// Maximum length of a formatted double.
+static const unsigned DOUBLE_CONVERSION_LENGTH = 32;
+
+/// Return the next pseudo-random number.
+static unsigned NextRandom(unsigned& seed)
+{
+    seed = seed * 1664525 + 1013904223;
+    return seed;
+}
+
+/// Return a pseudo-random float with a value in a range typical for scene attributes.
+static float NextFloat(unsigned& seed)
+{
+    return (float)(NextRandom(seed) >> 8u) / (float)(1u << 24u) * 2000.0f - 1000.0f;
+}
+
+/// Check that floats of every magnitude are formatted with digits that parse back to the same float.
+static void TestFloatRoundTrip()
+{
+    char buffer[FLOAT_CONVERSION_LENGTH];
+    unsigned seed = 1;
+    unsigned numTested = 0;
+    while (numTested < NUM_VALUES)
+    {
+        unsigned bits = NextRandom(seed);
+        float value;
+        memcpy(&value, &bits, sizeof value);
+        if (IsNaN(value) || IsInf(value))
+            continue;
+
+        FormatFloat(buffer, value);
+        char* end = nullptr;
+        TEST_CHECK((float)ParseDouble(buffer, &end) == value);
+        TEST_CHECK(*end == 0);
+        ++numTested;
+    }
+}
+
+/// Check that parsing decimal numbers gives the same double as strtod, and measure both.
+static void TestParseDouble()
+{
+    Vector<String> sources;
+    unsigned seed = 1;
+    char buffer[DOUBLE_CONVERSION_LENGTH];
+    for (unsigned i = 0; i < NUM_VALUES; ++i)
+    {
+        // Mix short numbers like the ones in scene files with full precision doubles that need the slow path
+        if (i % 4)
+            sprintf(buffer, "%g", NextFloat(seed));
+        else
+            sprintf(buffer, "%.17g", NextFloat(seed) / 3.0);
+        sources.Push(buffer);
+    }
+
+    HiresTimer timer;
+    double sum = 0.0;
+    for (unsigned i = 0; i < sources.Size(); ++i)
+        sum += ParseDouble(sources[i].CString());
+    long long parseUSec = timer.GetUSec(true);
+
+    double strtodSum = 0.0;
+    for (unsigned i = 0; i < sources.Size(); ++i)
+        strtodSum += strtod(sources[i].CString(), nullptr);
+    long long strtodUSec = timer.GetUSec(false);
+
+    for (unsigned i = 0; i < sources.Size(); ++i)
+        TEST_CHECK(ParseDouble(sources[i].CString()) == strtod(sources[i].CString(), nullptr));
+    TEST_CHECK(sum == strtodSum);
+    PrintBenchmark("ParseDouble", sources.Size(), parseUSec);
+    PrintBenchmark("strtod", sources.Size(), strtodUSec);
+}
+
+/// Measure saving and loading a scene with many nodes as XML, and check that the transforms survive unchanged.
+static void BenchmarkSceneXML(Context* context)
+{
+    SharedPtr<Scene> scene(new Scene(context));
+    unsigned seed = 1;
+    for (unsigned i = 0; i < NUM_NODES; ++i)
+    {
+        Node* node = scene->CreateChild(ToString("Node%u", i));
+        float x = NextFloat(seed);
+        float y = NextFloat(seed);
+        float z = NextFloat(seed);
+        node->SetPosition(Vector3(x, y, z));
+        float yaw = NextFloat(seed);
+        node->SetRotation(Quaternion(yaw, Vector3::UP));
+        node->SetScale(1.0f + NextFloat(seed) / 1000.0f);
+        node->SetVar("Index", i);
+    }
+
+    HiresTimer timer;
+    VectorBuffer buffer;
+    TEST_CHECK(scene->SaveXML(buffer));
+    long long saveUSec = timer.GetUSec(true);
+
+    SharedPtr<Scene> loadedScene(new Scene(context));
+    MemoryBuffer source(buffer.GetData(), buffer.GetSize());
+    TEST_CHECK(loadedScene->LoadXML(source));
+    long long loadUSec = timer.GetUSec(false);
+
+    const Vector<SharedPtr<Node> >& nodes = scene->GetChildren();
+    const Vector<SharedPtr<Node> >& loadedNodes = loadedScene->GetChildren();
+    TEST_CHECK(loadedNodes.Size() == NUM_NODES);
+    for (unsigned i = 0; i < NUM_NODES; ++i)
+    {
+        TEST_CHECK(loadedNodes[i]->GetName() == nodes[i]->GetName());
+        TEST_CHECK(loadedNodes[i]->GetPosition() == nodes[i]->GetPosition());
+        TEST_CHECK(loadedNodes[i]->GetRotation() == nodes[i]->GetRotation());
+        TEST_CHECK(loadedNodes[i]->GetScale() == nodes[i]->GetScale());
+        TEST_CHECK(loadedNodes[i]->GetVar("Index").GetUInt() == i);
+    }
+
+    PrintLine(ToString("Scene XML size %u bytes", buffer.GetSize()));
+    PrintBenchmark("Save scene XML nodes", NUM_NODES, saveUSec);
+    PrintBenchmark("Load scene XML nodes", NUM_NODES, loadUSec);
+}
+
+int main(int argc, char** argv)
+{
+    SharedPtr<Context> context = CreateTestContext();
+    RegisterSceneLibrary(context);
+
+    TestFloatRoundTrip();
+    TestParseDouble();
+    BenchmarkSceneXML(context);
+    return 0;
+}
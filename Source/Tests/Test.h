@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Core/Thread.h>
+#include <Urho3D/Core/Timer.h>
+
+#include <functional>
+
+// All Urho3D classes reside in namespace Urho3D
+using namespace Urho3D;
+
+/// Create a context for a test. Register the Time subsystem, which initializes the high-resolution timer used for measuring.
+inline SharedPtr<Context> CreateTestContext()
+{
+    SharedPtr<Context> context(new Context());
+    context->RegisterSubsystem(new Time(context));
+    return context;
+}
+
+/// Report a failed check and exit with an error code.
+inline void TestFailed(const char* condition, const char* file, int line)
+{
+    ErrorExit(ToString("%s:%d: check failed: %s", file, line, condition));
+}
+
+/// Check a condition, and fail the test when it does not hold.
+#define TEST_CHECK(condition) do { if (!(condition)) TestFailed(#condition, __FILE__, __LINE__); } while (false)
+
+/// Print the time taken by a benchmark, in total and per operation.
+inline void PrintBenchmark(const String& name, unsigned count, long long usec)
+{
+    PrintLine(ToString("%s: %u in %u us, %u ns each", name.CString(), count, (unsigned)usec,
+        (unsigned)(usec * 1000 / Max(count, 1U))));
+}
+
+/// Thread running a function.
+class FunctionThread : public RefCounted, public Thread
+{
+public:
+    /// Construct.
+    explicit FunctionThread(const std::function<void()>& function) :
+        function_(function)
+    {
+    }
+
+    /// Destruct. Wait for the function to return before destroying it.
+    ~FunctionThread() override { Stop(); }
+
+    /// Run the function.
+    void ThreadFunction() override { function_(); }
+
+private:
+    /// Function to run.
+    std::function<void()> function_;
+};
@@ -0,0 +1,164 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/WorkQueue.h>
+
+#include "Test.h"
+
+#include <cmath>
+
+#include <Urho3D/DebugNew.h>
+
+/// Number of frames measured per configuration.
+static const unsigned NUM_FRAMES = 500;
+/// Number of elements processed in parallel each frame.
+static const unsigned NUM_ELEMENTS = 65536;
+/// Iterations of busy work per element.
+static const unsigned ELEMENT_ITERATIONS = 64;
+
+/// Do busy work on a range of elements.
+static void ProcessElements(const WorkItem* item, unsigned /*threadIndex*/)
+{
+    auto* start = reinterpret_cast<float*>(item->start_);
+    auto* end = reinterpret_cast<float*>(item->end_);
+    for (float* element = start; element < end; ++element)
+    {
+        float value = *element;
+        for (unsigned i = 0; i < ELEMENT_ITERATIONS; ++i)
+            value = value * 0.999f + 0.5f;
+        *element = value;
+    }
+}
+
+/// Return the logical CPU indices of the topology.
+static PODVector<unsigned> GetIndices(const PODVector<LogicalCPU>& topology)
+{
+    PODVector<unsigned> indices;
+    for (unsigned i = 0; i < topology.Size(); ++i)
+        indices.Push(topology[i].index_);
+    return indices;
+}
+
+/// Check that the reported logical CPUs are unique, that the logical CPUs of a physical core are consecutive, and that threads
+/// can be pinned to each of them.
+static void TestTopology(const PODVector<LogicalCPU>& topology)
+{
+    PrintLine(ToString("Logical CPUs in topology: %u, logical CPU count: %u", topology.Size(), GetNumLogicalCPUs()));
+
+    for (unsigned i = 0; i < topology.Size(); ++i)
+    {
+        for (unsigned j = i + 1; j < topology.Size(); ++j)
+        {
+            TEST_CHECK(topology[i].index_ != topology[j].index_);
+            // A later CPU of the same core must not be separated from the earlier ones by another core
+            if (topology[j].core_ == topology[i].core_ && topology[j].package_ == topology[i].package_)
+                TEST_CHECK(topology[j - 1].core_ == topology[i].core_ && topology[j - 1].package_ == topology[i].package_);
+        }
+    }
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+    // The topology only contains CPUs the thread is allowed to run on, so pinning to each of them must succeed
+    TEST_CHECK(!topology.Empty());
+    for (unsigned i = 0; i < topology.Size(); ++i)
+    {
+        PODVector<unsigned> cpus;
+        cpus.Push(topology[i].index_);
+        TEST_CHECK(Thread::SetCurrentThreadAffinity(cpus));
+    }
+    TEST_CHECK(Thread::SetCurrentThreadAffinity(GetIndices(topology)));
+#endif
+}
+
+/// Run frames of parallel work with the worker threads either pinned to one logical CPU per physical core or left to the
+/// scheduler, and print the frame time statistics. The first physical core is left to the main thread, as the engine does by
+/// default.
+static void BenchmarkJitter(const PODVector<LogicalCPU>& topology, bool pinned)
+{
+    PODVector<unsigned> mainCPUs;
+    PODVector<unsigned> workerCPUs;
+    for (unsigned i = 0; i < topology.Size(); ++i)
+    {
+        bool newCore = !i || topology[i].core_ != topology[i - 1].core_ || topology[i].package_ != topology[i - 1].package_;
+        if (i && newCore)
+            workerCPUs.Push(topology[i].index_);
+        else if (workerCPUs.Empty())
+            mainCPUs.Push(topology[i].index_);
+    }
+    // With a single physical core, share it between the main thread and one worker
+    if (workerCPUs.Empty() && !mainCPUs.Empty())
+        workerCPUs.Push(mainCPUs.Back());
+
+    SharedPtr<Context> context = CreateTestContext();
+    auto* queue = new WorkQueue(context);
+    context->RegisterSubsystem(queue);
+    if (pinned && !workerCPUs.Empty())
+    {
+        Thread::SetCurrentThreadAffinity(mainCPUs);
+        queue->CreateThreads(workerCPUs);
+    }
+    else
+        queue->CreateThreads(Max(workerCPUs.Size(), 1U));
+
+    PODVector<float> elements(NUM_ELEMENTS);
+    for (unsigned i = 0; i < NUM_ELEMENTS; ++i)
+        elements[i] = (float)i;
+
+    PODVector<long long> frameTimes(NUM_FRAMES);
+    HiresTimer timer;
+    for (unsigned i = 0; i < NUM_FRAMES; ++i)
+    {
+        timer.Reset();
+        queue->ParallelFor(elements.Begin(), elements.End(), ProcessElements, nullptr, 256);
+        frameTimes[i] = timer.GetUSec(false);
+    }
+
+    long long total = 0;
+    long long maxTime = 0;
+    for (unsigned i = 0; i < NUM_FRAMES; ++i)
+    {
+        total += frameTimes[i];
+        maxTime = Max(maxTime, frameTimes[i]);
+    }
+    double mean = (double)total / NUM_FRAMES;
+    double variance = 0.0;
+    for (unsigned i = 0; i < NUM_FRAMES; ++i)
+        variance += ((double)frameTimes[i] - mean) * ((double)frameTimes[i] - mean);
+
+    PrintLine(ToString("%s, %u workers: frame mean %u us, max %u us, stddev %u us", pinned ? "Pinned" : "Unpinned",
+        queue->GetNumThreads(), (unsigned)mean, (unsigned)maxTime, (unsigned)sqrt(variance / NUM_FRAMES)));
+
+    if (pinned)
+        Thread::SetCurrentThreadAffinity(GetIndices(topology));
+}
+
+int main(int argc, char** argv)
+{
+    PODVector<LogicalCPU> topology = GetCPUTopology();
+    TestTopology(topology);
+
+    if (!topology.Empty())
+    {
+        BenchmarkJitter(topology, false);
+        BenchmarkJitter(topology, true);
+    }
+    return EXIT_SUCCESS;
+}
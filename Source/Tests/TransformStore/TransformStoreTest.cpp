@@ -0,0 +1,187 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Scene/Node.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "Test.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Number of top-level nodes in the benchmark scene.
+static const unsigned NUM_SUBTREES = 1000;
+/// Number of children of each node above the deepest level.
+static const unsigned NUM_CHILDREN = 7;
+/// Depth of the subtrees below the top-level nodes.
+static const unsigned SUBTREE_DEPTH = 2;
+/// Number of frames in which all top-level nodes are moved.
+static const unsigned NUM_FRAMES = 20;
+
+/// Return the next pseudo-random number.
+static unsigned NextRandom(unsigned& seed)
+{
+    seed = seed * 1664525 + 1013904223;
+    return seed;
+}
+
+/// Return a pseudo-random float between -1 and 1.
+static float NextFloat(unsigned& seed)
+{
+    return (float)(NextRandom(seed) >> 8u) / (float)(1u << 23u) - 1.0f;
+}
+
+/// Create a node with a pseudo-random transform and its children recursively.
+static void CreateSubtree(Node* parent, unsigned depth, unsigned& seed, PODVector<Node*>& nodes)
+{
+    Node* node = parent->CreateChild();
+    node->SetPosition(Vector3(NextFloat(seed), NextFloat(seed), NextFloat(seed)) * 10.0f);
+    node->SetRotation(Quaternion(NextFloat(seed) * 180.0f, NextFloat(seed) * 180.0f, NextFloat(seed) * 180.0f));
+    node->SetScale(1.0f + NextFloat(seed) * 0.5f);
+    nodes.Push(node);
+
+    if (depth < SUBTREE_DEPTH)
+    {
+        for (unsigned i = 0; i < NUM_CHILDREN; ++i)
+            CreateSubtree(node, depth + 1, seed, nodes);
+    }
+}
+
+/// Create the benchmark scene, and return its nodes in creation order.
+static SharedPtr<Scene> CreateScene(Context* context, PODVector<Node*>& nodes)
+{
+    SharedPtr<Scene> scene(new Scene(context));
+    unsigned seed = 1;
+    for (unsigned i = 0; i < NUM_SUBTREES; ++i)
+        CreateSubtree(scene, 0, seed, nodes);
+    return scene;
+}
+
+/// Rotate the top-level nodes, which makes the whole scene dirty.
+static void MoveSubtrees(Scene* scene, unsigned frame)
+{
+    const Vector<SharedPtr<Node> >& children = scene->GetChildren();
+    for (unsigned i = 0; i < children.Size(); ++i)
+        children[i]->Rotate(Quaternion((float)(frame + i % 7), Vector3::UP));
+}
+
+/// Read the world transforms of all nodes, as the renderer would.
+static float ReadTransforms(const PODVector<Node*>& nodes)
+{
+    float sum = 0.0f;
+    for (unsigned i = 0; i < nodes.Size(); ++i)
+        sum += nodes[i]->GetWorldTransform().m03_;
+    return sum;
+}
+
+/// Check that the world transforms and rotations of two scenes built the same way match.
+static void CheckTransforms(const PODVector<Node*>& lhs, const PODVector<Node*>& rhs)
+{
+    TEST_CHECK(lhs.Size() == rhs.Size());
+    for (unsigned i = 0; i < lhs.Size(); ++i)
+    {
+        TEST_CHECK(!rhs[i]->IsDirty());
+        TEST_CHECK(lhs[i]->GetWorldTransform().Equals(rhs[i]->GetWorldTransform()));
+        TEST_CHECK(lhs[i]->GetWorldRotation().Equals(rhs[i]->GetWorldRotation()));
+    }
+}
+
+/// Check that the transform store produces the same world transforms as the lazy update, also after the hierarchy changes.
+static void TestTransformStore(Context* context)
+{
+    PODVector<Node*> lazyNodes;
+    SharedPtr<Scene> lazyScene = CreateScene(context, lazyNodes);
+    PODVector<Node*> storeNodes;
+    SharedPtr<Scene> storeScene = CreateScene(context, storeNodes);
+    // Calculate some of the transforms lazily before enabling the store, which must then take them over
+    ReadTransforms(storeNodes);
+    storeScene->SetTransformStoreEnabled(true);
+
+    MoveSubtrees(lazyScene, 0);
+    MoveSubtrees(storeScene, 0);
+    storeScene->UpdateTransforms();
+    ReadTransforms(lazyNodes);
+    CheckTransforms(lazyNodes, storeNodes);
+
+    // Reparent a subtree, remove one and add one, then move a single deep node
+    lazyNodes[1]->SetParent(lazyNodes[lazyNodes.Size() - 1]);
+    storeNodes[1]->SetParent(storeNodes[storeNodes.Size() - 1]);
+    lazyScene->GetChildren()[1]->Remove();
+    storeScene->GetChildren()[1]->Remove();
+    unsigned lazySeed = 2;
+    unsigned storeSeed = 2;
+    PODVector<Node*> newLazyNodes;
+    PODVector<Node*> newStoreNodes;
+    CreateSubtree(lazyScene, 0, lazySeed, newLazyNodes);
+    CreateSubtree(storeScene, 0, storeSeed, newStoreNodes);
+    newLazyNodes.Back()->Translate(Vector3::ONE);
+    newStoreNodes.Back()->Translate(Vector3::ONE);
+    storeScene->UpdateTransforms();
+
+    lazyNodes.Clear();
+    storeNodes.Clear();
+    lazyScene->GetChildren(lazyNodes, true);
+    storeScene->GetChildren(storeNodes, true);
+    ReadTransforms(lazyNodes);
+    CheckTransforms(lazyNodes, storeNodes);
+}
+
+/// Move all nodes each frame and read their world transforms, either calculated lazily or updated by the transform store.
+static void BenchmarkTransforms(Context* context, bool useStore, const char* name)
+{
+    PODVector<Node*> nodes;
+    SharedPtr<Scene> scene = CreateScene(context, nodes);
+    scene->SetTransformStoreEnabled(useStore);
+
+    float sum = 0.0f;
+    HiresTimer timer;
+    for (unsigned i = 0; i < NUM_FRAMES; ++i)
+    {
+        MoveSubtrees(scene, i);
+        scene->UpdateTransforms();
+        sum += ReadTransforms(nodes);
+    }
+    long long usec = timer.GetUSec(false);
+
+    TEST_CHECK(sum == sum);
+    PrintBenchmark(name, NUM_FRAMES * nodes.Size(), usec);
+}
+
+int main(int argc, char** argv)
+{
+    SharedPtr<Context> context = CreateTestContext();
+    // Always create worker threads, so that the threaded update is tested also on a single CPU
+    auto* queue = new WorkQueue(context);
+    queue->CreateThreads(Max(GetNumLogicalCPUs() - 1, 1U));
+    context->RegisterSubsystem(queue);
+    RegisterSceneLibrary(context);
+
+    TestTransformStore(context);
+    BenchmarkTransforms(context, false, "Lazy transform update");
+    BenchmarkTransforms(context, true, "Transform store update, threaded");
+
+    // Compare also without worker threads
+    SharedPtr<Context> serialContext = CreateTestContext();
+    RegisterSceneLibrary(serialContext);
+    BenchmarkTransforms(serialContext, true, "Transform store update, single-threaded");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/WorkQueue.h>
+
+#include "Test.h"
+
+#include <atomic>
+
+#include <Urho3D/DebugNew.h>
+
+/// Number of work items submitted per benchmark round.
+static const unsigned NUM_WORK_ITEMS = 100000;
+/// Iterations of busy work in each benchmark work item.
+static const unsigned WORK_ITEM_ITERATIONS = 200;
+/// Sizes of the arrays sorted in parallel. The smallest is below the chunk size and is sorted directly.
+static const unsigned SORT_SIZES[] = {500, 5000, 100000, 1000000};
+/// Worker thread counts to benchmark.
+static const unsigned BENCHMARK_THREADS[] = {1, 4, 16, 64};
+
+/// Count a work item, after a small amount of busy work.
+static void CountWork(const WorkItem* item, unsigned /*threadIndex*/)
+{
+    volatile unsigned value = 0;
+    for (unsigned i = 0; i < WORK_ITEM_ITERATIONS; ++i)
+        value = value * 31 + i;
+
+    auto* counter = reinterpret_cast<std::atomic<unsigned>*>(item->aux_);
+    counter->fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Record the work item's index to the order vector.
+static void RecordWork(const WorkItem* item, unsigned /*threadIndex*/)
+{
+    auto* order = reinterpret_cast<PODVector<unsigned>*>(item->aux_);
+    order->Push((unsigned)(size_t)item->start_);
+}
+
+/// Create a context with a work queue running the specified number of worker threads.
+static SharedPtr<Context> CreateWorkQueue(unsigned numThreads)
+{
+    SharedPtr<Context> context = CreateTestContext();
+    auto* queue = new WorkQueue(context);
+    context->RegisterSubsystem(queue);
+    queue->CreateThreads(numThreads);
+    return context;
+}
+
+/// Submit many small items and complete them, measuring the scheduling throughput.
+static void BenchmarkScheduler(unsigned numThreads)
+{
+    SharedPtr<Context> context = CreateWorkQueue(numThreads);
+    auto* queue = context->GetSubsystem<WorkQueue>();
+    std::atomic<unsigned> counter(0);
+
+    HiresTimer timer;
+    for (unsigned i = 0; i < NUM_WORK_ITEMS; ++i)
+    {
+        SharedPtr<WorkItem> item = queue->GetFreeItem();
+        item->priority_ = M_MAX_UNSIGNED;
+        item->workFunction_ = CountWork;
+        item->aux_ = &counter;
+        queue->AddWorkItem(item);
+    }
+    queue->Complete(M_MAX_UNSIGNED);
+    long long usec = timer.GetUSec(false);
+
+    TEST_CHECK(counter.load() == NUM_WORK_ITEMS);
+    TEST_CHECK(queue->IsCompleted(0));
+    PrintBenchmark(ToString("AddWorkItem, %u threads", numThreads), NUM_WORK_ITEMS, usec);
+}
+
+/// Run the same user-owned items with the same dependency in consecutive submissions. The dependent item is added first, so
+/// that it would run first if the dependency were lost.
+static void TestReusedDependencies(unsigned numThreads)
+{
+    SharedPtr<Context> context = CreateWorkQueue(numThreads);
+    auto* queue = context->GetSubsystem<WorkQueue>();
+    PODVector<unsigned> order;
+
+    SharedPtr<WorkItem> first(new WorkItem());
+    SharedPtr<WorkItem> second(new WorkItem());
+    first->workFunction_ = second->workFunction_ = RecordWork;
+    first->aux_ = second->aux_ = &order;
+    first->priority_ = second->priority_ = M_MAX_UNSIGNED;
+    first->start_ = (void*)1;
+    second->start_ = (void*)2;
+
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        order.Clear();
+        queue->AddDependency(second, first);
+        queue->AddWorkItem(second);
+        queue->AddWorkItem(first);
+        queue->Complete(M_MAX_UNSIGNED);
+
+        TEST_CHECK(first->completed_ && second->completed_);
+        TEST_CHECK(order.Size() == 2 && order[0] == 1 && order[1] == 2);
+    }
+}
+
+/// Compare two values for sorting.
+static bool CompareValues(unsigned lhs, unsigned rhs)
+{
+    return lhs < rhs;
+}
+
+/// Sort arrays with many equal values in parallel, and check the result against a serial sort.
+static void TestParallelSort(unsigned numThreads)
+{
+    SharedPtr<Context> context = CreateWorkQueue(numThreads);
+    auto* queue = context->GetSubsystem<WorkQueue>();
+    unsigned seed = 1;
+
+    for (unsigned i = 0; i < sizeof SORT_SIZES / sizeof SORT_SIZES[0]; ++i)
+    {
+        unsigned size = SORT_SIZES[i];
+        PODVector<unsigned> values(size);
+        for (unsigned j = 0; j < size; ++j)
+        {
+            seed = seed * 1664525 + 1013904223;
+            values[j] = (seed >> 8u) % (size / 4 + 1);
+        }
+
+        PODVector<unsigned> expected(values);
+        HiresTimer timer;
+        Sort(expected.Begin(), expected.End(), CompareValues);
+        long long serialUSec = timer.GetUSec(true);
+        queue->ParallelSort(values.Begin(), values.End(), CompareValues);
+        long long parallelUSec = timer.GetUSec(false);
+
+        TEST_CHECK(values == expected);
+        PrintBenchmark(ToString("Sort, %u elements", size), size, serialUSec);
+        PrintBenchmark(ToString("ParallelSort, %u threads, %u elements", numThreads, size), size, parallelUSec);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    TestReusedDependencies(0);
+    TestReusedDependencies(4);
+    TestParallelSort(4);
+
+    for (unsigned i = 0; i < sizeof BENCHMARK_THREADS / sizeof BENCHMARK_THREADS[0]; ++i)
+        BenchmarkScheduler(BENCHMARK_THREADS[i]);
+    return EXIT_SUCCESS;
+}
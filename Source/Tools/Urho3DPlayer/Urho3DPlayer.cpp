@@ -102,6 +102,7 @@ void Urho3DPlayer::Setup()
             "-ap <paths>  Resource autoload path(s), separated by semicolons, default to 'AutoLoad'\n"
             "-log <level> Change the log level, valid 'level' values: 'debug', 'info', 'warning', 'error'\n"
             "-ds <file>   Dump used shader variations to a file for precaching\n"
+            "-pc <file>   Capture the profiler timeline and save it to a file on exit, in Chrome trace format if the extension is .json\n"
             "-mq <level>  Material quality level, default 2 (high)\n"
             "-tq <level>  Texture quality level, default 2 (high)\n"
             "-tf <level>  Texture filter mode, default 2 (trilinear)\n"
@@ -122,6 +123,9 @@ void Urho3DPlayer::Setup()
             "-noshadows   Disable shadow rendering\n"
             "-nolimit     Disable frame limiter\n"
             "-nothreads   Disable worker threads\n"
+            "-threadspercore <num> Worker threads per physical CPU core, default 1\n"
+            "-reservedcores <num> Physical CPU cores reserved for the main thread, default 1\n"
+            "-affinity    Pin worker threads to CPUs\n"
             "-nosound     Disable sound output\n"
             "-noip        Disable sound mixing interpolation\n"
             "-touch       Touch emulation on desktop platform\n"
@@ -26,6 +26,7 @@
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/PackageFile.h"
 #include "../Scene/ObjectAnimation.h"
+#include "../Scene/Prefab.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SmoothedTransform.h"
 #include "../Scene/SplinePath.h"
@@ -98,6 +99,13 @@ static void RegisterObjectAnimation(asIScriptEngine* engine)
 }
 
 
+static void RegisterPrefab(asIScriptEngine* engine)
+{
+    RegisterResource<Prefab>(engine, "Prefab");
+    engine->RegisterObjectMethod("Prefab", "uint get_numNodes() const", asMETHOD(Prefab, GetNumNodes), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Prefab", "uint get_numComponents() const", asMETHOD(Prefab, GetNumComponents), asCALL_THISCALL);
+}
+
 static void RegisterAnimatable(asIScriptEngine* engine)
 {
     RegisterAnimatable<Animatable>(engine, "Animatable");
@@ -200,6 +208,11 @@ static bool SceneSaveJSON(File* file, const String& indentation, Scene* ptr)
     return file && ptr->SaveJSON(*file, indentation);
 }
 
+static bool SceneSaveMapped(File* file, Scene* ptr)
+{
+    return file && ptr->SaveMapped(*file);
+}
+
 static bool SceneSaveXMLVectorBuffer(VectorBuffer& buffer, const String& indentation, Scene* ptr)
 {
     return ptr->SaveXML(buffer, indentation);
@@ -352,6 +365,8 @@ static void RegisterScene(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Scene", "bool LoadJSON(VectorBuffer&)", asFUNCTION(SceneLoadJSONVectorBuffer), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("Scene", "bool SaveJSON(File@+, const String&in indentation = \"\t\")", asFUNCTION(SceneSaveJSON), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("Scene", "bool SaveJSON(VectorBuffer&, const String&in indentation = \"\t\")", asFUNCTION(SceneSaveJSONVectorBuffer), asCALL_CDECL_OBJLAST);
+    engine->RegisterObjectMethod("Scene", "bool LoadMapped(const String&in)", asMETHOD(Scene, LoadMapped), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "bool SaveMapped(File@+) const", asFUNCTION(SceneSaveMapped), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("Scene", "bool LoadAsync(File@+, LoadMode mode = LOAD_SCENE_AND_RESOURCES)", asMETHOD(Scene, LoadAsync), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "bool LoadAsyncXML(File@+, LoadMode mode = LOAD_SCENE_AND_RESOURCES)", asMETHOD(Scene, LoadAsyncXML), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "void StopAsyncLoading()", asMETHOD(Scene, StopAsyncLoading), asCALL_THISCALL);
@@ -362,6 +377,7 @@ static void RegisterScene(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Scene", "Node@+ InstantiateXML(VectorBuffer&, const Vector3&in, const Quaternion&in, CreateMode mode = REPLICATED)", asFUNCTION(SceneInstantiateXMLVectorBuffer), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("Scene", "Node@+ InstantiateXML(XMLFile@+, const Vector3&in, const Quaternion&in, CreateMode mode = REPLICATED)", asFUNCTION(SceneInstantiateXMLFile), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("Scene", "Node@+ InstantiateXML(const XMLElement&in, const Vector3&in, const Quaternion&in, CreateMode mode = REPLICATED)", asMETHODPR(Scene, InstantiateXML, (const XMLElement&, const Vector3&, const Quaternion&, CreateMode), Node*), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "Node@+ InstantiatePrefab(Prefab@+, const Vector3&in, const Quaternion&in, CreateMode mode = REPLICATED)", asMETHOD(Scene, InstantiatePrefab), asCALL_THISCALL);
 
     engine->RegisterObjectMethod("Scene", "Node@+ InstantiateJSON(File@+, const Vector3&in, const Quaternion&in, CreateMode mode = REPLICATED)", asFUNCTION(SceneInstantiateJSON), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("Scene", "Node@+ InstantiateJSON(VectorBuffer&, const Vector3&in, const Quaternion&in, CreateMode mode = REPLICATED)", asFUNCTION(SceneInstantiateJSONVectorBuffer), asCALL_CDECL_OBJLAST);
@@ -397,6 +413,11 @@ static void RegisterScene(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Scene", "LoadMode get_asyncLoadMode() const", asMETHOD(Scene, GetAsyncLoadMode), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "void set_asyncLoadingMs(int)", asMETHOD(Scene, SetAsyncLoadingMs), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "int get_asyncLoadingMs() const", asMETHOD(Scene, GetAsyncLoadingMs), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "void set_freedIDReuseDelay(float)", asMETHOD(Scene, SetFreedIDReuseDelay), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "float get_freedIDReuseDelay() const", asMETHOD(Scene, GetFreedIDReuseDelay), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "void set_transformStoreEnabled(bool)", asMETHOD(Scene, SetTransformStoreEnabled), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "bool get_transformStoreEnabled() const", asMETHOD(Scene, IsTransformStoreEnabled), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "void UpdateTransforms()", asMETHOD(Scene, UpdateTransforms), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "uint get_checksum() const", asMETHOD(Scene, GetChecksum), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "const String& get_fileName() const", asMETHOD(Scene, GetFileName), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "Array<PackageFile@>@ get_requiredPackageFiles() const", asFUNCTION(SceneGetRequiredPackageFiles), asCALL_CDECL_OBJLAST);
@@ -416,6 +437,7 @@ void RegisterSceneAPI(asIScriptEngine* engine)
     RegisterValueAnimation(engine);
     RegisterObjectAnimation(engine);
     RegisterAnimatable(engine);
+    RegisterPrefab(engine);
     RegisterNode(engine);
     RegisterSmoothedTransform(engine);
     RegisterSplinePath(engine);
@@ -22,6 +22,10 @@
 
 #include "../Precompiled.h"
 
+#ifdef URHO3D_TRACK_ALLOCATIONS
+#include "../Core/AllocationTracker.h"
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -97,6 +101,10 @@ void* AllocatorReserve(AllocatorBlock* allocator)
         allocator->capacity_ += newCapacity;
     }
 
+#ifdef URHO3D_TRACK_ALLOCATIONS
+    AllocationTracker::RecordSourceAllocation(ALLOC_SOURCE_BLOCK, allocator->nodeSize_, URHO3D_RETURN_ADDRESS);
+#endif
+
     // We should have new free node(s) chained
     AllocatorNode* freeNode = allocator->free_;
     void* ptr = (reinterpret_cast<unsigned char*>(freeNode)) + sizeof(AllocatorNode);
@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#ifdef URHO3D_IS_BUILDING
+#include "Urho3D.h"
+#else
+#include <Urho3D/Urho3D.h>
+#endif
+
+#include "../Container/Hash.h"
+#include "../Container/Swap.h"
+
+#include <cstring>
+
+namespace Urho3D
+{
+
+/// Open-addressing hash set/map base class. Elements are stored in a single array with robin hood linear probing and backward shift deletion. Probing does not wrap around: the array has extra slots after the last home slot, and the capacity grows if a probe would run past them.
+class URHO3D_API FlatHashBase
+{
+public:
+    /// Initial capacity.
+    static const unsigned MIN_CAPACITY = 8;
+    /// Minimum probe distance allowed before growing.
+    static const unsigned MIN_MAX_DISTANCE = 4;
+
+    /// Construct.
+    FlatHashBase() :
+        buffer_(nullptr),
+        distances_(nullptr),
+        size_(0),
+        capacity_(0),
+        shift_(0),
+        maxDistance_(0)
+    {
+    }
+
+    /// Swap with another hash set or map.
+    void Swap(FlatHashBase& rhs)
+    {
+        Urho3D::Swap(buffer_, rhs.buffer_);
+        Urho3D::Swap(distances_, rhs.distances_);
+        Urho3D::Swap(size_, rhs.size_);
+        Urho3D::Swap(capacity_, rhs.capacity_);
+        Urho3D::Swap(shift_, rhs.shift_);
+        Urho3D::Swap(maxDistance_, rhs.maxDistance_);
+    }
+
+    /// Return number of elements.
+    unsigned Size() const { return size_; }
+
+    /// Return number of home slots. The element array has some extra slots after them.
+    unsigned Capacity() const { return capacity_; }
+
+    /// Return whether has no elements.
+    bool Empty() const { return size_ == 0; }
+
+protected:
+    /// Return total number of slots including the extra slots.
+    unsigned NumSlots() const { return capacity_ ? capacity_ + maxDistance_ : 0; }
+
+    /// Return the home slot for a hash. Uses Fibonacci hashing so that sequential keys and aligned pointers spread evenly.
+    unsigned HomeIndex(unsigned hash) const { return (hash * 2654435769u) >> shift_; }
+
+    /// Return whether one more element can be inserted without exceeding the maximum load factor.
+    bool CanInsert() const { return (size_ + 1) * 4 <= capacity_ * 3; }
+
+    /// Return index of the first used slot, or the number of slots if empty.
+    unsigned FirstIndex() const
+    {
+        if (!size_)
+            return NumSlots();
+
+        unsigned index = 0;
+        while (!distances_[index])
+            ++index;
+        return index;
+    }
+
+    /// Allocate an empty buffer for a capacity, which must be a power of two, and an element size. Return the previous buffer, which the caller must free.
+    unsigned char* AllocateBuffer(unsigned capacity, unsigned elementSize)
+    {
+        unsigned char* oldBuffer = buffer_;
+
+        unsigned log2 = 0;
+        while ((1u << log2) < capacity)
+            ++log2;
+
+        capacity_ = capacity;
+        shift_ = 32 - log2;
+        maxDistance_ = log2;
+        if (maxDistance_ < MIN_MAX_DISTANCE)
+            maxDistance_ = MIN_MAX_DISTANCE;
+        size_ = 0;
+
+        const unsigned numSlots = NumSlots();
+        buffer_ = new unsigned char[numSlots * elementSize + numSlots + 1];
+        distances_ = buffer_ + numSlots * elementSize;
+        memset(distances_, 0, numSlots);
+        // Nonzero sentinel stops iteration at the end
+        distances_[numSlots] = 1;
+
+        return oldBuffer;
+    }
+
+    /// Element storage followed by the distances.
+    unsigned char* buffer_;
+    /// Probe distance plus one for each slot, zero if the slot is empty.
+    unsigned char* distances_;
+    /// Number of elements.
+    unsigned size_;
+    /// Number of home slots. Always a power of two or zero.
+    unsigned capacity_;
+    /// Shift for mapping a hash to a home slot.
+    unsigned shift_;
+    /// Maximum probe distance.
+    unsigned maxDistance_;
+};
+
+}
@@ -0,0 +1,608 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/FlatHashBase.h"
+#include "../Container/Pair.h"
+#include "../Container/Vector.h"
+
+#include <cassert>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+namespace Urho3D
+{
+
+/// Open-addressing hash map template class. Faster to look up and iterate than HashMap, but the iteration order is unspecified and inserting invalidates iterators and pointers to values. Erasing by iterator during iteration is supported.
+template <class T, class U> class FlatHashMap : public FlatHashBase
+{
+public:
+    using KeyType = T;
+    using ValueType = U;
+
+    /// Hash map key-value pair with const key.
+    class KeyValue
+    {
+    public:
+        /// Construct with key and value.
+        KeyValue(const T& first, const U& second) :
+            first_(first),
+            second_(second)
+        {
+        }
+
+        /// Copy-construct.
+        KeyValue(const KeyValue& value) :
+            first_(value.first_),
+            second_(value.second_)
+        {
+        }
+
+        /// Move-construct. The key is copied.
+        KeyValue(KeyValue&& value) noexcept :
+            first_(value.first_),
+            second_(std::move(value.second_))
+        {
+        }
+
+        /// Prevent assignment.
+        KeyValue& operator =(const KeyValue& rhs) = delete;
+
+        /// Test for equality with another pair.
+        bool operator ==(const KeyValue& rhs) const { return first_ == rhs.first_ && second_ == rhs.second_; }
+        /// Test for inequality with another pair.
+        bool operator !=(const KeyValue& rhs) const { return first_ != rhs.first_ || second_ != rhs.second_; }
+
+        /// Key.
+        const T first_;
+        /// Value.
+        U second_;
+    };
+
+    /// Hash map iterator.
+    struct Iterator
+    {
+        /// Construct.
+        Iterator() = default;
+
+        /// Construct with a slot and its distance.
+        Iterator(KeyValue* ptr, const unsigned char* distance) :
+            ptr_(ptr),
+            distance_(distance)
+        {
+        }
+
+        /// Preincrement the pointer.
+        Iterator& operator ++()
+        {
+            GotoNext();
+            return *this;
+        }
+
+        /// Postincrement the pointer.
+        Iterator operator ++(int)
+        {
+            Iterator it = *this;
+            GotoNext();
+            return it;
+        }
+
+        /// Point to the pair.
+        KeyValue* operator ->() const { return ptr_; }
+
+        /// Dereference the pair.
+        KeyValue& operator *() const { return *ptr_; }
+
+        /// Test for equality with another iterator.
+        bool operator ==(const Iterator& rhs) const { return ptr_ == rhs.ptr_; }
+
+        /// Test for inequality with another iterator.
+        bool operator !=(const Iterator& rhs) const { return ptr_ != rhs.ptr_; }
+
+        /// Go to the next used slot.
+        void GotoNext()
+        {
+            do
+            {
+                ++ptr_;
+                ++distance_;
+            } while (!*distance_);
+        }
+
+        /// Pointer to the slot.
+        KeyValue* ptr_{};
+        /// Pointer to the slot's distance.
+        const unsigned char* distance_{};
+    };
+
+    /// Hash map const iterator.
+    struct ConstIterator
+    {
+        /// Construct.
+        ConstIterator() = default;
+
+        /// Construct with a slot and its distance.
+        ConstIterator(const KeyValue* ptr, const unsigned char* distance) :
+            ptr_(ptr),
+            distance_(distance)
+        {
+        }
+
+        /// Construct from a non-const iterator.
+        ConstIterator(const Iterator& rhs) :     // NOLINT(google-explicit-constructor)
+            ptr_(rhs.ptr_),
+            distance_(rhs.distance_)
+        {
+        }
+
+        /// Preincrement the pointer.
+        ConstIterator& operator ++()
+        {
+            GotoNext();
+            return *this;
+        }
+
+        /// Postincrement the pointer.
+        ConstIterator operator ++(int)
+        {
+            ConstIterator it = *this;
+            GotoNext();
+            return it;
+        }
+
+        /// Point to the pair.
+        const KeyValue* operator ->() const { return ptr_; }
+
+        /// Dereference the pair.
+        const KeyValue& operator *() const { return *ptr_; }
+
+        /// Test for equality with another iterator.
+        bool operator ==(const ConstIterator& rhs) const { return ptr_ == rhs.ptr_; }
+
+        /// Test for inequality with another iterator.
+        bool operator !=(const ConstIterator& rhs) const { return ptr_ != rhs.ptr_; }
+
+        /// Go to the next used slot.
+        void GotoNext()
+        {
+            do
+            {
+                ++ptr_;
+                ++distance_;
+            } while (!*distance_);
+        }
+
+        /// Pointer to the slot.
+        const KeyValue* ptr_{};
+        /// Pointer to the slot's distance.
+        const unsigned char* distance_{};
+    };
+
+    /// Construct empty.
+    FlatHashMap() = default;
+
+    /// Construct from another hash map.
+    FlatHashMap(const FlatHashMap<T, U>& map)
+    {
+        CopyFrom(map);
+    }
+
+    /// Move-construct from another hash map.
+    FlatHashMap(FlatHashMap<T, U>&& map) noexcept
+    {
+        Swap(map);
+    }
+
+    /// Aggregate initialization constructor.
+    FlatHashMap(const std::initializer_list<Pair<T, U>>& list)
+    {
+        for (auto it = list.begin(); it != list.end(); it++)
+            Insert(*it);
+    }
+
+    /// Destruct.
+    ~FlatHashMap()
+    {
+        Clear();
+        delete[] buffer_;
+    }
+
+    /// Assign a hash map.
+    FlatHashMap& operator =(const FlatHashMap<T, U>& rhs)
+    {
+        if (&rhs != this)
+        {
+            FlatHashMap<T, U> copy(rhs);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    /// Move-assign a hash map.
+    FlatHashMap& operator =(FlatHashMap<T, U>&& rhs) noexcept
+    {
+        assert(&rhs != this);
+        Swap(rhs);
+        return *this;
+    }
+
+    /// Test for equality with another hash map.
+    bool operator ==(const FlatHashMap<T, U>& rhs) const
+    {
+        if (rhs.Size() != Size())
+            return false;
+
+        for (ConstIterator i = Begin(); i != End(); ++i)
+        {
+            ConstIterator j = rhs.Find(i->first_);
+            if (j == rhs.End() || j->second_ != i->second_)
+                return false;
+        }
+
+        return true;
+    }
+
+    /// Test for inequality with another hash map.
+    bool operator !=(const FlatHashMap<T, U>& rhs) const { return !(*this == rhs); }
+
+    /// Index the map. Create a new pair if key not found.
+    U& operator [](const T& key)
+    {
+        unsigned index = FindIndex(key);
+        if (index == NumSlots())
+            index = InsertNew(key, U());
+        return Slots()[index].second_;
+    }
+
+    /// Index the map. Return null if key is not found, does not create a new pair.
+    U* operator [](const T& key) const
+    {
+        unsigned index = FindIndex(key);
+        return index != NumSlots() ? &Slots()[index].second_ : nullptr;
+    }
+
+    /// Populate the map using variadic template. This handles the base case.
+    FlatHashMap& Populate(const T& key, const U& value)
+    {
+        this->operator [](key) = value;
+        return *this;
+    }
+
+    /// Populate the map using variadic template.
+    template <typename... Args> FlatHashMap& Populate(const T& key, const U& value, const Args&... args)
+    {
+        this->operator [](key) = value;
+        return Populate(args...);
+    }
+
+    /// Insert a pair. Return an iterator to it.
+    Iterator Insert(const Pair<T, U>& pair)
+    {
+        bool exists;
+        return Insert(pair, exists);
+    }
+
+    /// Insert a pair. Return iterator and set exists flag according to whether the key already existed.
+    Iterator Insert(const Pair<T, U>& pair, bool& exists)
+    {
+        unsigned index = FindIndex(pair.first_);
+        exists = index != NumSlots();
+        if (exists)
+            Slots()[index].second_ = pair.second_;
+        else
+            index = InsertNew(pair.first_, pair.second_);
+        return Iterator(Slots() + index, distances_ + index);
+    }
+
+    /// Insert a map.
+    void Insert(const FlatHashMap<T, U>& map)
+    {
+        for (ConstIterator it = map.Begin(); it != map.End(); ++it)
+            this->operator [](it->first_) = it->second_;
+    }
+
+    /// Erase a pair by key. Return true if was found.
+    bool Erase(const T& key)
+    {
+        unsigned index = FindIndex(key);
+        if (index == NumSlots())
+            return false;
+
+        EraseIndex(index);
+        return true;
+    }
+
+    /// Erase a pair by iterator. Return iterator to the next pair. The pairs not yet visited by an iteration stay ahead of the returned iterator.
+    Iterator Erase(const Iterator& it)
+    {
+        if (!it.ptr_ || it == End())
+            return End();
+
+        auto index = (unsigned)(it.ptr_ - Slots());
+        EraseIndex(index);
+        // Backward shift may have moved the next pair into the erased slot
+        Iterator next(Slots() + index, distances_ + index);
+        if (!*next.distance_)
+            ++next;
+        return next;
+    }
+
+    /// Clear the map. Keeps the allocated capacity.
+    void Clear()
+    {
+        if (!size_)
+            return;
+
+        const unsigned numSlots = NumSlots();
+        KeyValue* slots = Slots();
+        for (unsigned i = 0; i < numSlots; ++i)
+        {
+            if (distances_[i])
+            {
+                (slots + i)->~KeyValue();
+                distances_[i] = 0;
+            }
+        }
+        size_ = 0;
+    }
+
+    /// Reserve capacity for a number of pairs without exceeding the maximum load factor.
+    void Reserve(unsigned numElements)
+    {
+        unsigned capacity = MIN_CAPACITY;
+        while (numElements * 4 > capacity * 3)
+            capacity <<= 1;
+        if (capacity > capacity_)
+            Rehash(capacity);
+    }
+
+    /// Return iterator to the pair with key, or end iterator if not found.
+    Iterator Find(const T& key)
+    {
+        unsigned index = FindIndex(key);
+        return Iterator(Slots() + index, distances_ + index);
+    }
+
+    /// Return const iterator to the pair with key, or end iterator if not found.
+    ConstIterator Find(const T& key) const
+    {
+        unsigned index = FindIndex(key);
+        return ConstIterator(Slots() + index, distances_ + index);
+    }
+
+    /// Return whether contains a pair with key.
+    bool Contains(const T& key) const { return FindIndex(key) != NumSlots(); }
+
+    /// Try to copy value to output. Return true if was found.
+    bool TryGetValue(const T& key, U& out) const
+    {
+        unsigned index = FindIndex(key);
+        if (index == NumSlots())
+            return false;
+
+        out = Slots()[index].second_;
+        return true;
+    }
+
+    /// Return all the keys.
+    Vector<T> Keys() const
+    {
+        Vector<T> result;
+        result.Reserve(Size());
+        for (ConstIterator i = Begin(); i != End(); ++i)
+            result.Push(i->first_);
+        return result;
+    }
+
+    /// Return all the values.
+    Vector<U> Values() const
+    {
+        Vector<U> result;
+        result.Reserve(Size());
+        for (ConstIterator i = Begin(); i != End(); ++i)
+            result.Push(i->second_);
+        return result;
+    }
+
+    /// Return iterator to the beginning.
+    Iterator Begin()
+    {
+        unsigned index = FirstIndex();
+        return Iterator(Slots() + index, distances_ + index);
+    }
+
+    /// Return iterator to the beginning.
+    ConstIterator Begin() const
+    {
+        unsigned index = FirstIndex();
+        return ConstIterator(Slots() + index, distances_ + index);
+    }
+
+    /// Return iterator to the end.
+    Iterator End()
+    {
+        unsigned index = NumSlots();
+        return Iterator(Slots() + index, distances_ + index);
+    }
+
+    /// Return iterator to the end.
+    ConstIterator End() const
+    {
+        unsigned index = NumSlots();
+        return ConstIterator(Slots() + index, distances_ + index);
+    }
+
+    /// Return first pair.
+    const KeyValue& Front() const { return *Begin(); }
+
+private:
+    /// Return the slots.
+    KeyValue* Slots() const { return reinterpret_cast<KeyValue*>(buffer_); }
+
+    /// Return index of the slot with key, or the number of slots if not found.
+    unsigned FindIndex(const T& key) const
+    {
+        if (!size_)
+            return NumSlots();
+
+        const KeyValue* slots = Slots();
+        unsigned index = HomeIndex(MakeHash(key));
+        for (unsigned distance = 1; distance <= maxDistance_; ++distance, ++index)
+        {
+            // A pair further from its home than the key would be cannot exist past this point
+            if (distances_[index] < distance)
+                break;
+            if (distances_[index] == distance && slots[index].first_ == key)
+                return index;
+        }
+
+        return NumSlots();
+    }
+
+    /// Insert a key that does not exist yet. Return the index of its slot.
+    unsigned InsertNew(const T& key, const U& value)
+    {
+        if (!CanInsert())
+            Rehash(capacity_ ? capacity_ << 1 : MIN_CAPACITY);
+
+        unsigned index = ReserveSlot(MakeHash(key));
+        new(Slots() + index) KeyValue(key, value);
+        return index;
+    }
+
+    /// Make room for a new element with a hash, growing if necessary. Return the index of the free slot.
+    unsigned ReserveSlot(unsigned hash)
+    {
+        for (;;)
+        {
+            if (capacity_)
+            {
+                // Find the first slot that is empty or holds an element closer to its home
+                unsigned index = HomeIndex(hash);
+                unsigned distance = 1;
+                while (distance <= maxDistance_ && distances_[index] >= distance)
+                {
+                    ++index;
+                    ++distance;
+                }
+
+                if (distance <= maxDistance_)
+                {
+                    // Find the end of the cluster. All elements up to it move one slot further, so none may be at the maximum distance
+                    unsigned empty = index;
+                    while (distances_[empty] && distances_[empty] < maxDistance_)
+                        ++empty;
+
+                    if (!distances_[empty])
+                    {
+                        KeyValue* slots = Slots();
+                        for (unsigned i = empty; i > index; --i)
+                        {
+                            new(slots + i) KeyValue(std::move(slots[i - 1]));
+                            (slots + i - 1)->~KeyValue();
+                            distances_[i] = (unsigned char)(distances_[i - 1] + 1);
+                        }
+
+                        distances_[index] = (unsigned char)distance;
+                        ++size_;
+                        return index;
+                    }
+                }
+            }
+
+            // Probe sequence would become too long, grow and retry
+            Rehash(capacity_ ? capacity_ << 1 : MIN_CAPACITY);
+        }
+    }
+
+    /// Erase the element at a slot and shift the following elements of the cluster back.
+    void EraseIndex(unsigned index)
+    {
+        KeyValue* slots = Slots();
+        (slots + index)->~KeyValue();
+
+        // The sentinel stops the loop at the end
+        while (distances_[index + 1] > 1)
+        {
+            new(slots + index) KeyValue(std::move(slots[index + 1]));
+            (slots + index + 1)->~KeyValue();
+            distances_[index] = (unsigned char)(distances_[index + 1] - 1);
+            ++index;
+        }
+
+        distances_[index] = 0;
+        --size_;
+    }
+
+    /// Reallocate to a capacity, which must be a power of two, and reinsert the elements.
+    void Rehash(unsigned capacity)
+    {
+        KeyValue* oldSlots = Slots();
+        const unsigned char* oldDistances = distances_;
+        const unsigned oldNumSlots = NumSlots();
+        unsigned char* oldBuffer = AllocateBuffer(capacity, sizeof(KeyValue));
+
+        for (unsigned i = 0; i < oldNumSlots; ++i)
+        {
+            if (oldDistances[i])
+            {
+                // If the new capacity is still too small, this grows further
+                unsigned index = ReserveSlot(MakeHash(oldSlots[i].first_));
+                new(Slots() + index) KeyValue(std::move(oldSlots[i]));
+                (oldSlots + i)->~KeyValue();
+            }
+        }
+
+        delete[] oldBuffer;
+    }
+
+    /// Copy the elements of another map into this empty map, keeping the same layout.
+    void CopyFrom(const FlatHashMap<T, U>& map)
+    {
+        if (!map.size_)
+            return;
+
+        AllocateBuffer(map.capacity_, sizeof(KeyValue));
+        const unsigned numSlots = NumSlots();
+        for (unsigned i = 0; i < numSlots; ++i)
+        {
+            if (map.distances_[i])
+            {
+                new(Slots() + i) KeyValue(map.Slots()[i]);
+                distances_[i] = map.distances_[i];
+            }
+        }
+        size_ = map.size_;
+    }
+};
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::ConstIterator begin(const Urho3D::FlatHashMap<T, U>& v) { return v.Begin(); }
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::ConstIterator end(const Urho3D::FlatHashMap<T, U>& v) { return v.End(); }
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::Iterator begin(Urho3D::FlatHashMap<T, U>& v) { return v.Begin(); }
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::Iterator end(Urho3D::FlatHashMap<T, U>& v) { return v.End(); }
+
+}
@@ -0,0 +1,410 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/FlatHashBase.h"
+
+#include <cassert>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+namespace Urho3D
+{
+
+/// Open-addressing hash set template class. Faster to look up and iterate than HashSet, but the iteration order is unspecified and inserting invalidates iterators. Erasing by iterator during iteration is supported.
+template <class T> class FlatHashSet : public FlatHashBase
+{
+public:
+    /// Hash set const iterator. Keys can not be modified in place.
+    struct ConstIterator
+    {
+        /// Construct.
+        ConstIterator() = default;
+
+        /// Construct with a slot and its distance.
+        ConstIterator(const T* ptr, const unsigned char* distance) :
+            ptr_(ptr),
+            distance_(distance)
+        {
+        }
+
+        /// Preincrement the pointer.
+        ConstIterator& operator ++()
+        {
+            GotoNext();
+            return *this;
+        }
+
+        /// Postincrement the pointer.
+        ConstIterator operator ++(int)
+        {
+            ConstIterator it = *this;
+            GotoNext();
+            return it;
+        }
+
+        /// Point to the key.
+        const T* operator ->() const { return ptr_; }
+
+        /// Dereference the key.
+        const T& operator *() const { return *ptr_; }
+
+        /// Test for equality with another iterator.
+        bool operator ==(const ConstIterator& rhs) const { return ptr_ == rhs.ptr_; }
+
+        /// Test for inequality with another iterator.
+        bool operator !=(const ConstIterator& rhs) const { return ptr_ != rhs.ptr_; }
+
+        /// Go to the next used slot.
+        void GotoNext()
+        {
+            do
+            {
+                ++ptr_;
+                ++distance_;
+            } while (!*distance_);
+        }
+
+        /// Pointer to the slot.
+        const T* ptr_{};
+        /// Pointer to the slot's distance.
+        const unsigned char* distance_{};
+    };
+
+    /// Hash set iterator.
+    using Iterator = ConstIterator;
+
+    /// Construct empty.
+    FlatHashSet() = default;
+
+    /// Construct from another hash set.
+    FlatHashSet(const FlatHashSet<T>& set)
+    {
+        CopyFrom(set);
+    }
+
+    /// Move-construct from another hash set.
+    FlatHashSet(FlatHashSet<T>&& set) noexcept
+    {
+        Swap(set);
+    }
+
+    /// Aggregate initialization constructor.
+    FlatHashSet(const std::initializer_list<T>& list)
+    {
+        for (auto it = list.begin(); it != list.end(); it++)
+            Insert(*it);
+    }
+
+    /// Destruct.
+    ~FlatHashSet()
+    {
+        Clear();
+        delete[] buffer_;
+    }
+
+    /// Assign a hash set.
+    FlatHashSet& operator =(const FlatHashSet<T>& rhs)
+    {
+        if (&rhs != this)
+        {
+            FlatHashSet<T> copy(rhs);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    /// Move-assign a hash set.
+    FlatHashSet& operator =(FlatHashSet<T>&& rhs) noexcept
+    {
+        assert(&rhs != this);
+        Swap(rhs);
+        return *this;
+    }
+
+    /// Test for equality with another hash set.
+    bool operator ==(const FlatHashSet<T>& rhs) const
+    {
+        if (rhs.Size() != Size())
+            return false;
+
+        for (ConstIterator i = Begin(); i != End(); ++i)
+        {
+            if (!rhs.Contains(*i))
+                return false;
+        }
+
+        return true;
+    }
+
+    /// Test for inequality with another hash set.
+    bool operator !=(const FlatHashSet<T>& rhs) const { return !(*this == rhs); }
+
+    /// Insert a key. Return an iterator to it.
+    Iterator Insert(const T& key)
+    {
+        bool exists;
+        return Insert(key, exists);
+    }
+
+    /// Insert a key. Return iterator and set exists flag according to whether the key already existed.
+    Iterator Insert(const T& key, bool& exists)
+    {
+        unsigned index = FindIndex(key);
+        exists = index != NumSlots();
+        if (!exists)
+        {
+            if (!CanInsert())
+                Rehash(capacity_ ? capacity_ << 1 : MIN_CAPACITY);
+
+            index = ReserveSlot(MakeHash(key));
+            new(Slots() + index) T(key);
+        }
+        return Iterator(Slots() + index, distances_ + index);
+    }
+
+    /// Insert a set.
+    void Insert(const FlatHashSet<T>& set)
+    {
+        for (ConstIterator it = set.Begin(); it != set.End(); ++it)
+            Insert(*it);
+    }
+
+    /// Erase a key. Return true if was found.
+    bool Erase(const T& key)
+    {
+        unsigned index = FindIndex(key);
+        if (index == NumSlots())
+            return false;
+
+        EraseIndex(index);
+        return true;
+    }
+
+    /// Erase a key by iterator. Return iterator to the next key. The keys not yet visited by an iteration stay ahead of the returned iterator.
+    Iterator Erase(const Iterator& it)
+    {
+        if (!it.ptr_ || it == End())
+            return End();
+
+        auto index = (unsigned)(it.ptr_ - Slots());
+        EraseIndex(index);
+        // Backward shift may have moved the next key into the erased slot
+        Iterator next(Slots() + index, distances_ + index);
+        if (!*next.distance_)
+            ++next;
+        return next;
+    }
+
+    /// Clear the set. Keeps the allocated capacity.
+    void Clear()
+    {
+        if (!size_)
+            return;
+
+        const unsigned numSlots = NumSlots();
+        T* slots = Slots();
+        for (unsigned i = 0; i < numSlots; ++i)
+        {
+            if (distances_[i])
+            {
+                (slots + i)->~T();
+                distances_[i] = 0;
+            }
+        }
+        size_ = 0;
+    }
+
+    /// Reserve capacity for a number of keys without exceeding the maximum load factor.
+    void Reserve(unsigned numElements)
+    {
+        unsigned capacity = MIN_CAPACITY;
+        while (numElements * 4 > capacity * 3)
+            capacity <<= 1;
+        if (capacity > capacity_)
+            Rehash(capacity);
+    }
+
+    /// Return iterator to the key, or end iterator if not found.
+    ConstIterator Find(const T& key) const
+    {
+        unsigned index = FindIndex(key);
+        return ConstIterator(Slots() + index, distances_ + index);
+    }
+
+    /// Return whether contains a key.
+    bool Contains(const T& key) const { return FindIndex(key) != NumSlots(); }
+
+    /// Return iterator to the beginning.
+    ConstIterator Begin() const
+    {
+        unsigned index = FirstIndex();
+        return ConstIterator(Slots() + index, distances_ + index);
+    }
+
+    /// Return iterator to the end.
+    ConstIterator End() const
+    {
+        unsigned index = NumSlots();
+        return ConstIterator(Slots() + index, distances_ + index);
+    }
+
+    /// Return first key.
+    const T& Front() const { return *Begin(); }
+
+private:
+    /// Return the slots.
+    T* Slots() const { return reinterpret_cast<T*>(buffer_); }
+
+    /// Return index of the slot with key, or the number of slots if not found.
+    unsigned FindIndex(const T& key) const
+    {
+        if (!size_)
+            return NumSlots();
+
+        const T* slots = Slots();
+        unsigned index = HomeIndex(MakeHash(key));
+        for (unsigned distance = 1; distance <= maxDistance_; ++distance, ++index)
+        {
+            // A key further from its home than the searched key would be cannot exist past this point
+            if (distances_[index] < distance)
+                break;
+            if (distances_[index] == distance && slots[index] == key)
+                return index;
+        }
+
+        return NumSlots();
+    }
+
+    /// Make room for a new key with a hash, growing if necessary. Return the index of the free slot.
+    unsigned ReserveSlot(unsigned hash)
+    {
+        for (;;)
+        {
+            if (capacity_)
+            {
+                // Find the first slot that is empty or holds a key closer to its home
+                unsigned index = HomeIndex(hash);
+                unsigned distance = 1;
+                while (distance <= maxDistance_ && distances_[index] >= distance)
+                {
+                    ++index;
+                    ++distance;
+                }
+
+                if (distance <= maxDistance_)
+                {
+                    // Find the end of the cluster. All keys up to it move one slot further, so none may be at the maximum distance
+                    unsigned empty = index;
+                    while (distances_[empty] && distances_[empty] < maxDistance_)
+                        ++empty;
+
+                    if (!distances_[empty])
+                    {
+                        T* slots = Slots();
+                        for (unsigned i = empty; i > index; --i)
+                        {
+                            new(slots + i) T(std::move(slots[i - 1]));
+                            (slots + i - 1)->~T();
+                            distances_[i] = (unsigned char)(distances_[i - 1] + 1);
+                        }
+
+                        distances_[index] = (unsigned char)distance;
+                        ++size_;
+                        return index;
+                    }
+                }
+            }
+
+            // Probe sequence would become too long, grow and retry
+            Rehash(capacity_ ? capacity_ << 1 : MIN_CAPACITY);
+        }
+    }
+
+    /// Erase the key at a slot and shift the following keys of the cluster back.
+    void EraseIndex(unsigned index)
+    {
+        T* slots = Slots();
+        (slots + index)->~T();
+
+        // The sentinel stops the loop at the end
+        while (distances_[index + 1] > 1)
+        {
+            new(slots + index) T(std::move(slots[index + 1]));
+            (slots + index + 1)->~T();
+            distances_[index] = (unsigned char)(distances_[index + 1] - 1);
+            ++index;
+        }
+
+        distances_[index] = 0;
+        --size_;
+    }
+
+    /// Reallocate to a capacity, which must be a power of two, and reinsert the keys.
+    void Rehash(unsigned capacity)
+    {
+        T* oldSlots = Slots();
+        const unsigned char* oldDistances = distances_;
+        const unsigned oldNumSlots = NumSlots();
+        unsigned char* oldBuffer = AllocateBuffer(capacity, sizeof(T));
+
+        for (unsigned i = 0; i < oldNumSlots; ++i)
+        {
+            if (oldDistances[i])
+            {
+                // If the new capacity is still too small, this grows further
+                unsigned index = ReserveSlot(MakeHash(oldSlots[i]));
+                new(Slots() + index) T(std::move(oldSlots[i]));
+                (oldSlots + i)->~T();
+            }
+        }
+
+        delete[] oldBuffer;
+    }
+
+    /// Copy the keys of another set into this empty set, keeping the same layout.
+    void CopyFrom(const FlatHashSet<T>& set)
+    {
+        if (!set.size_)
+            return;
+
+        AllocateBuffer(set.capacity_, sizeof(T));
+        const unsigned numSlots = NumSlots();
+        for (unsigned i = 0; i < numSlots; ++i)
+        {
+            if (set.distances_[i])
+            {
+                new(Slots() + i) T(set.Slots()[i]);
+                distances_[i] = set.distances_[i];
+            }
+        }
+        size_ = set.size_;
+    }
+};
+
+template <class T> typename Urho3D::FlatHashSet<T>::ConstIterator begin(const Urho3D::FlatHashSet<T>& v) { return v.Begin(); }
+
+template <class T> typename Urho3D::FlatHashSet<T>::ConstIterator end(const Urho3D::FlatHashSet<T>& v) { return v.End(); }
+
+}
@@ -0,0 +1,274 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#ifdef URHO3D_IS_BUILDING
+#include "Urho3D.h"
+#else
+#include <Urho3D/Urho3D.h>
+#endif
+
+#include <atomic>
+#include <cassert>
+#include <new>
+#include <utility>
+
+namespace Urho3D
+{
+
+/// Assumed size of a CPU cache line. Ring queues pad their positions by this much to keep the producer and consumer from sharing a cache line.
+static const unsigned RING_QUEUE_CACHE_LINE = 64;
+
+/// Bounded lock-free queue for one producer thread and one consumer thread. Push and pop are wait-free. The capacity is rounded up to a power of two.
+template <class T> class SPSCQueue
+{
+public:
+    /// Construct with capacity.
+    explicit SPSCQueue(unsigned capacity) :
+        head_(0),
+        tail_(0)
+    {
+        capacity_ = 1;
+        while (capacity_ < capacity)
+            capacity_ <<= 1;
+        mask_ = capacity_ - 1;
+        buffer_ = new Slot[capacity_];
+    }
+
+    /// Destruct. Destroys the values remaining in the queue.
+    ~SPSCQueue()
+    {
+        const unsigned tail = tail_.load(std::memory_order_relaxed);
+        for (unsigned i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+            buffer_[i & mask_].Get()->~T();
+        delete[] buffer_;
+    }
+
+    /// Prevent copy construction.
+    SPSCQueue(const SPSCQueue<T>& rhs) = delete;
+    /// Prevent assignment.
+    SPSCQueue<T>& operator =(const SPSCQueue<T>& rhs) = delete;
+
+    /// Add a value at the back. Return false if the queue is full. Call only from the producer thread.
+    bool TryPush(const T& value) { return TryEmplace(value); }
+
+    /// Move a value to the back. Return false and leave the value untouched if the queue is full. Call only from the producer thread.
+    bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+    /// Remove the value at the front and move it to the destination. Return false if the queue is empty. Call only from the consumer thread.
+    bool TryPop(T& dest)
+    {
+        const unsigned head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+
+        T* value = buffer_[head & mask_].Get();
+        dest = std::move(*value);
+        value->~T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Return number of values in the queue. Only a snapshot while the other thread is active.
+    unsigned Size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+
+    /// Return whether the queue is empty. Only a snapshot while the other thread is active.
+    bool Empty() const { return Size() == 0; }
+
+    /// Return the capacity.
+    unsigned Capacity() const { return capacity_; }
+
+private:
+    /// Storage for one value.
+    struct Slot
+    {
+        /// Return the value.
+        T* Get() { return reinterpret_cast<T*>(storage_); }
+
+        /// Value storage.
+        alignas(T) unsigned char storage_[sizeof(T)];
+    };
+
+    /// Construct a value at the back.
+    template <class U> bool TryEmplace(U&& value)
+    {
+        const unsigned tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == capacity_)
+            return false;
+
+        new(buffer_[tail & mask_].Get()) T(std::forward<U>(value));
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Value slots.
+    Slot* buffer_;
+    /// Number of slots.
+    unsigned capacity_;
+    /// Mask to convert a position to a slot index.
+    unsigned mask_;
+    /// Padding before the consumer position.
+    unsigned char headPadding_[RING_QUEUE_CACHE_LINE];
+    /// Position of the next value to pop. Written only by the consumer.
+    std::atomic<unsigned> head_;
+    /// Padding between the consumer and producer positions.
+    unsigned char tailPadding_[RING_QUEUE_CACHE_LINE];
+    /// Position of the next value to push. Written only by the producer.
+    std::atomic<unsigned> tail_;
+};
+
+/// Bounded lock-free queue for any number of producer and consumer threads. Each slot has a sequence number, so threads only contend on the position counters, and values are popped in the order their pushes claimed a position. The capacity is rounded up to a power of two.
+template <class T> class MPMCQueue
+{
+public:
+    /// Construct with capacity.
+    explicit MPMCQueue(unsigned capacity) :
+        head_(0),
+        tail_(0)
+    {
+        capacity_ = 2;
+        while (capacity_ < capacity)
+            capacity_ <<= 1;
+        mask_ = capacity_ - 1;
+        buffer_ = new Slot[capacity_];
+        for (unsigned i = 0; i < capacity_; ++i)
+            buffer_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+
+    /// Destruct. Destroys the values remaining in the queue.
+    ~MPMCQueue()
+    {
+        const unsigned tail = tail_.load(std::memory_order_relaxed);
+        for (unsigned i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+            buffer_[i & mask_].Get()->~T();
+        delete[] buffer_;
+    }
+
+    /// Prevent copy construction.
+    MPMCQueue(const MPMCQueue<T>& rhs) = delete;
+    /// Prevent assignment.
+    MPMCQueue<T>& operator =(const MPMCQueue<T>& rhs) = delete;
+
+    /// Add a value at the back. Return false if the queue is full. Can be called from any thread.
+    bool TryPush(const T& value) { return TryEmplace(value); }
+
+    /// Move a value to the back. Return false and leave the value untouched if the queue is full. Can be called from any thread.
+    bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+    /// Remove the value at the front and move it to the destination. Return false if the queue is empty. Can be called from any thread.
+    bool TryPop(T& dest)
+    {
+        unsigned head = head_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot& slot = buffer_[head & mask_];
+            const auto diff = (int)(slot.sequence_.load(std::memory_order_acquire) - (head + 1));
+            if (diff == 0)
+            {
+                // The slot holds the value for this position, try to claim it
+                if (head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+                {
+                    T* value = slot.Get();
+                    dest = std::move(*value);
+                    value->~T();
+                    // Free the slot for the push one lap later
+                    slot.sequence_.store(head + capacity_, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                head = head_.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// Return approximate number of values in the queue.
+    unsigned Size() const
+    {
+        const auto size = (int)(tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_relaxed));
+        return size > 0 ? (unsigned)size : 0;
+    }
+
+    /// Return whether the queue is approximately empty.
+    bool Empty() const { return Size() == 0; }
+
+    /// Return the capacity.
+    unsigned Capacity() const { return capacity_; }
+
+private:
+    /// Storage for one value with its sequence number.
+    struct Slot
+    {
+        /// Return the value.
+        T* Get() { return reinterpret_cast<T*>(storage_); }
+
+        /// Position the slot is ready for: equal to the position when free for a push, position + 1 when holding the pushed value.
+        std::atomic<unsigned> sequence_;
+        /// Value storage.
+        alignas(T) unsigned char storage_[sizeof(T)];
+    };
+
+    /// Construct a value at the back.
+    template <class U> bool TryEmplace(U&& value)
+    {
+        unsigned tail = tail_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot& slot = buffer_[tail & mask_];
+            const auto diff = (int)(slot.sequence_.load(std::memory_order_acquire) - tail);
+            if (diff == 0)
+            {
+                // The slot is free for this position, try to claim it
+                if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+                {
+                    new(slot.Get()) T(std::forward<U>(value));
+                    slot.sequence_.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                tail = tail_.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// Value slots.
+    Slot* buffer_;
+    /// Number of slots.
+    unsigned capacity_;
+    /// Mask to convert a position to a slot index.
+    unsigned mask_;
+    /// Padding before the consumer position.
+    unsigned char headPadding_[RING_QUEUE_CACHE_LINE];
+    /// Position of the next value to pop.
+    std::atomic<unsigned> head_;
+    /// Padding between the consumer and producer positions.
+    unsigned char tailPadding_[RING_QUEUE_CACHE_LINE];
+    /// Position of the next value to push.
+    std::atomic<unsigned> tail_;
+};
+
+}
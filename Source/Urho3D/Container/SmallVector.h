@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/Vector.h"
+
+namespace Urho3D
+{
+
+/// %Vector template class with inline storage for N elements. Does not allocate memory until the size exceeds N, and can be passed wherever a Vector is expected.
+template <class T, unsigned N> class SmallVector : public Vector<T>
+{
+    static_assert(N > 0, "Inline capacity must be nonzero");
+
+public:
+    /// Construct empty.
+    SmallVector() noexcept
+    {
+        SetInlineBuffer();
+    }
+
+    /// Construct with initial size.
+    explicit SmallVector(unsigned size) :
+        SmallVector()
+    {
+        this->Resize(size);
+    }
+
+    /// Construct with initial size and default value.
+    SmallVector(unsigned size, const T& value) :
+        SmallVector()
+    {
+        this->Resize(size, value);
+    }
+
+    /// Construct with initial data.
+    SmallVector(const T* data, unsigned size) :
+        SmallVector()
+    {
+        this->Insert(this->End(), data, data + size);
+    }
+
+    /// Copy-construct from another vector.
+    SmallVector(const SmallVector<T, N>& vector) :
+        SmallVector()
+    {
+        this->Push(vector);
+    }
+
+    /// Copy-construct from another vector.
+    SmallVector(const Vector<T>& vector) :     // NOLINT(google-explicit-constructor)
+        SmallVector()
+    {
+        this->Push(vector);
+    }
+
+    /// Move-construct from another vector.
+    SmallVector(SmallVector<T, N>&& vector) :
+        SmallVector()
+    {
+        this->Swap(vector);
+    }
+
+    /// Move-construct from another vector.
+    SmallVector(Vector<T>&& vector) :          // NOLINT(google-explicit-constructor)
+        SmallVector()
+    {
+        this->Swap(vector);
+    }
+
+    /// Aggregate initialization constructor.
+    SmallVector(const std::initializer_list<T>& list) :
+        SmallVector()
+    {
+        for (auto it = list.begin(); it != list.end(); it++)
+            this->Push(*it);
+    }
+
+    /// Destruct. The elements are destroyed here, while the inline storage still exists.
+    ~SmallVector()
+    {
+        this->Clear();
+    }
+
+    /// Assign from another vector.
+    SmallVector<T, N>& operator =(const SmallVector<T, N>& rhs)
+    {
+        return *this = static_cast<const Vector<T>&>(rhs);
+    }
+
+    /// Assign from another vector. Reuses the existing buffer.
+    SmallVector<T, N>& operator =(const Vector<T>& rhs)
+    {
+        // In case of self-assignment do nothing
+        if (&rhs != this)
+        {
+            this->Clear();
+            this->Push(rhs);
+        }
+        return *this;
+    }
+
+    /// Move-assign from another vector.
+    SmallVector<T, N>& operator =(SmallVector<T, N>&& rhs)
+    {
+        Vector<T>::operator =(std::move(rhs));
+        return *this;
+    }
+
+    /// Move-assign from another vector.
+    SmallVector<T, N>& operator =(Vector<T>&& rhs)
+    {
+        Vector<T>::operator =(std::move(rhs));
+        return *this;
+    }
+
+    /// Return whether the elements are in the inline storage.
+    bool IsInline() const { return this->externalBuffer_ != 0; }
+
+private:
+    /// Point the vector to the inline storage.
+    void SetInlineBuffer()
+    {
+        this->buffer_ = storage_;
+        this->capacity_ = N;
+        this->externalBuffer_ = 1;
+    }
+
+    /// Inline storage.
+    alignas(T) unsigned char storage_[N * sizeof(T)];
+};
+
+/// %Vector template class for POD types with inline storage for N elements. Does not allocate memory until the size exceeds N, and can be passed wherever a PODVector is expected.
+template <class T, unsigned N> class SmallPODVector : public PODVector<T>
+{
+    static_assert(N > 0, "Inline capacity must be nonzero");
+
+public:
+    /// Construct empty.
+    SmallPODVector() noexcept
+    {
+        SetInlineBuffer();
+    }
+
+    /// Construct with initial size.
+    explicit SmallPODVector(unsigned size) :
+        SmallPODVector()
+    {
+        this->Resize(size);
+    }
+
+    /// Construct with initial size and default value.
+    SmallPODVector(unsigned size, const T& value) :
+        SmallPODVector()
+    {
+        this->Resize(size);
+        for (unsigned i = 0; i < size; ++i)
+            this->At(i) = value;
+    }
+
+    /// Construct with initial data.
+    SmallPODVector(const T* data, unsigned size) :
+        SmallPODVector()
+    {
+        this->Insert(this->End(), data, data + size);
+    }
+
+    /// Copy-construct from another vector.
+    SmallPODVector(const SmallPODVector<T, N>& vector) :
+        SmallPODVector()
+    {
+        this->Push(vector);
+    }
+
+    /// Copy-construct from another vector.
+    SmallPODVector(const PODVector<T>& vector) :   // NOLINT(google-explicit-constructor)
+        SmallPODVector()
+    {
+        this->Push(vector);
+    }
+
+    /// Aggregate initialization constructor.
+    SmallPODVector(const std::initializer_list<T>& list) :
+        SmallPODVector()
+    {
+        for (auto it = list.begin(); it != list.end(); it++)
+            this->Push(*it);
+    }
+
+    /// Assign from another vector.
+    SmallPODVector<T, N>& operator =(const SmallPODVector<T, N>& rhs)
+    {
+        PODVector<T>::operator =(rhs);
+        return *this;
+    }
+
+    /// Assign from another vector.
+    SmallPODVector<T, N>& operator =(const PODVector<T>& rhs)
+    {
+        PODVector<T>::operator =(rhs);
+        return *this;
+    }
+
+    /// Return whether the elements are in the inline storage.
+    bool IsInline() const { return this->externalBuffer_ != 0; }
+
+private:
+    /// Point the vector to the inline storage.
+    void SetInlineBuffer()
+    {
+        this->buffer_ = storage_;
+        this->capacity_ = N;
+        this->externalBuffer_ = 1;
+    }
+
+    /// Inline storage.
+    alignas(T) unsigned char storage_[N * sizeof(T)];
+};
+
+}
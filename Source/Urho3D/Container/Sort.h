@@ -29,6 +29,16 @@ namespace Urho3D
 {
 
 static const int QUICKSORT_THRESHOLD = 16;
+static const int RADIX_SORT_THRESHOLD = 64;
+
+/// Sort key and payload pair for radix sort.
+template <class T> struct RadixSortItem
+{
+    /// Sort key.
+    unsigned long long key_;
+    /// Payload.
+    T value_;
+};
 
 // Based on Comparison of several sorting algorithms by Juha Nieminen
 // http://warp.povusers.org/SortComparison/
@@ -141,4 +151,73 @@ template <class T, class U> void Sort(RandomAccessIterator<T> begin, RandomAcces
     InsertionSort(begin, end, compare);
 }
 
+/// Merge two consecutive sorted ranges [begin, middle) and [middle, end) into a destination array using a compare function. Elements of the first range are taken first when equal, so the merge is stable.
+template <class T, class U> void Merge(RandomAccessIterator<T> begin, RandomAccessIterator<T> middle, RandomAccessIterator<T> end,
+    RandomAccessIterator<T> dest, U compare)
+{
+    RandomAccessIterator<T> i = begin;
+    RandomAccessIterator<T> j = middle;
+    while (i < middle && j < end)
+    {
+        if (compare(*j, *i))
+            *dest++ = *j++;
+        else
+            *dest++ = *i++;
+    }
+    while (i < middle)
+        *dest++ = *i++;
+    while (j < end)
+        *dest++ = *j++;
+}
+
+/// Sort in ascending order of the 64-bit keys using least significant digit radix sort with 8-bit digits. The sort is stable. The temporary array must have room for all the items. Digits that are equal in all keys are skipped, so keys that only use part of the range need fewer passes.
+template <class T> void RadixSort(RandomAccessIterator<RadixSortItem<T> > begin, RandomAccessIterator<RadixSortItem<T> > end, RadixSortItem<T>* temp)
+{
+    auto count = (unsigned)(end - begin);
+    if (count < RADIX_SORT_THRESHOLD)
+    {
+        InsertionSort(begin, end, [](const RadixSortItem<T>& lhs, const RadixSortItem<T>& rhs) { return lhs.key_ < rhs.key_; });
+        return;
+    }
+
+    // Count the digits for all passes at once
+    unsigned counts[8][256] = {};
+    RadixSortItem<T>* src = begin.ptr_;
+    RadixSortItem<T>* dest = temp;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        unsigned long long key = src[i].key_;
+        for (unsigned pass = 0; pass < 8; ++pass)
+            ++counts[pass][(key >> (pass * 8)) & 0xffu];
+    }
+
+    for (unsigned pass = 0; pass < 8; ++pass)
+    {
+        unsigned* offsets = counts[pass];
+        unsigned shift = pass * 8;
+        if (offsets[(src[0].key_ >> shift) & 0xffu] == count)
+            continue;
+
+        unsigned offset = 0;
+        for (unsigned j = 0; j < 256; ++j)
+        {
+            unsigned digitCount = offsets[j];
+            offsets[j] = offset;
+            offset += digitCount;
+        }
+
+        for (unsigned i = 0; i < count; ++i)
+            dest[offsets[(src[i].key_ >> shift) & 0xffu]++] = src[i];
+
+        Swap(src, dest);
+    }
+
+    // After an odd number of passes the result is in the temporary array
+    if (src != begin.ptr_)
+    {
+        for (unsigned i = 0; i < count; ++i)
+            begin.ptr_[i] = src[i];
+    }
+}
+
 }
@@ -22,6 +22,10 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringUtils.h"
+#ifdef URHO3D_TRACK_ALLOCATIONS
+#include "../Core/AllocationTracker.h"
+#endif
 #include "../IO/Log.h"
 
 #include <cstdio>
@@ -35,14 +39,12 @@
 namespace Urho3D
 {
 
-char String::endZero = 0;
-
 const String String::EMPTY;
 
 String::String(const WString& str) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     SetUTF8FromWChar(str.CString());
 }
@@ -50,97 +52,97 @@ String::String(const WString& str) :
 String::String(int value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%d", value);
+    FormatInt(tempBuffer, value);
     *this = tempBuffer;
 }
 
 String::String(short value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%d", value);
+    FormatInt(tempBuffer, value);
     *this = tempBuffer;
 }
 
 String::String(long value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%ld", value);
+    FormatInt(tempBuffer, value);
     *this = tempBuffer;
 }
 
 String::String(long long value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%lld", value);
+    FormatInt(tempBuffer, value);
     *this = tempBuffer;
 }
 
 String::String(unsigned value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%u", value);
+    FormatUInt(tempBuffer, value);
     *this = tempBuffer;
 }
 
 String::String(unsigned short value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%u", value);
+    FormatUInt(tempBuffer, value);
     *this = tempBuffer;
 }
 
 String::String(unsigned long value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%lu", value);
+    FormatUInt(tempBuffer, value);
     *this = tempBuffer;
 }
 
 String::String(unsigned long long value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%llu", value);
+    FormatUInt(tempBuffer, value);
     *this = tempBuffer;
 }
 
 String::String(float value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%g", value);
+    FormatFloat(tempBuffer, value);
     *this = tempBuffer;
 }
 
 String::String(double value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%.15g", value);
@@ -150,7 +152,7 @@ String::String(double value) :
 String::String(bool value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
     if (value)
         *this = "true";
@@ -161,70 +163,70 @@ String::String(bool value) :
 String::String(char value) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
-    Resize(1);
-    buffer_[0] = value;
+    DoResize(1, URHO3D_ALLOCATION_CALL_SITE);
+    Buffer()[0] = value;
 }
 
 String::String(char value, unsigned length) :
     length_(0),
     capacity_(0),
-    buffer_(&endZero)
+    inlineBuffer_{}
 {
-    Resize(length);
+    DoResize(length, URHO3D_ALLOCATION_CALL_SITE);
     for (unsigned i = 0; i < length; ++i)
-        buffer_[i] = value;
+        Buffer()[i] = value;
 }
 
 String& String::operator +=(int rhs)
 {
-    return *this += String(rhs);
+    return DoAppend(String(rhs), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::operator +=(short rhs)
 {
-    return *this += String(rhs);
+    return DoAppend(String(rhs), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::operator +=(long rhs)
 {
-    return *this += String(rhs);
+    return DoAppend(String(rhs), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::operator +=(long long rhs)
 {
-    return *this += String(rhs);
+    return DoAppend(String(rhs), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::operator +=(unsigned rhs)
 {
-    return *this += String(rhs);
+    return DoAppend(String(rhs), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::operator +=(unsigned short rhs)
 {
-    return *this += String(rhs);
+    return DoAppend(String(rhs), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::operator +=(unsigned long rhs)
 {
-    return *this += String(rhs);
+    return DoAppend(String(rhs), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::operator +=(unsigned long long rhs)
 {
-    return *this += String(rhs);
+    return DoAppend(String(rhs), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::operator +=(float rhs)
 {
-    return *this += String(rhs);
+    return DoAppend(String(rhs), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::operator +=(bool rhs)
 {
-    return *this += String(rhs);
+    return DoAppend(String(rhs), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 void String::Replace(char replaceThis, char replaceWith, bool caseSensitive)
@@ -233,8 +235,8 @@ void String::Replace(char replaceThis, char replaceWith, bool caseSensitive)
     {
         for (unsigned i = 0; i < length_; ++i)
         {
-            if (buffer_[i] == replaceThis)
-                buffer_[i] = replaceWith;
+            if (Buffer()[i] == replaceThis)
+                Buffer()[i] = replaceWith;
         }
     }
     else
@@ -242,8 +244,8 @@ void String::Replace(char replaceThis, char replaceWith, bool caseSensitive)
         replaceThis = (char)tolower(replaceThis);
         for (unsigned i = 0; i < length_; ++i)
         {
-            if (tolower(buffer_[i]) == replaceThis)
-                buffer_[i] = replaceWith;
+            if (tolower(Buffer()[i]) == replaceThis)
+                Buffer()[i] = replaceWith;
         }
     }
 }
@@ -257,7 +259,7 @@ void String::Replace(const String& replaceThis, const String& replaceWith, bool
         unsigned pos = Find(replaceThis, nextPos, caseSensitive);
         if (pos == NPOS)
             break;
-        Replace(pos, replaceThis.length_, replaceWith);
+        Replace(pos, replaceThis.length_, replaceWith.Buffer(), replaceWith.length_, URHO3D_ALLOCATION_CALL_SITE);
         nextPos = pos + replaceWith.length_;
     }
 }
@@ -268,7 +270,7 @@ void String::Replace(unsigned pos, unsigned length, const String& replaceWith)
     if (pos + length > length_)
         return;
 
-    Replace(pos, length, replaceWith.buffer_, replaceWith.length_);
+    Replace(pos, length, replaceWith.Buffer(), replaceWith.length_, URHO3D_ALLOCATION_CALL_SITE);
 }
 
 void String::Replace(unsigned pos, unsigned length, const char* replaceWith)
@@ -277,7 +279,7 @@ void String::Replace(unsigned pos, unsigned length, const char* replaceWith)
     if (pos + length > length_)
         return;
 
-    Replace(pos, length, replaceWith, CStringLength(replaceWith));
+    Replace(pos, length, replaceWith, CStringLength(replaceWith), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String::Iterator String::Replace(const String::Iterator& start, const String::Iterator& end, const String& replaceWith)
@@ -286,7 +288,8 @@ String::Iterator String::Replace(const String::Iterator& start, const String::It
     if (pos >= length_)
         return End();
     auto length = (unsigned)(end - start);
-    Replace(pos, length, replaceWith);
+    if (pos + length <= length_)
+        Replace(pos, length, replaceWith.Buffer(), replaceWith.length_, URHO3D_ALLOCATION_CALL_SITE);
 
     return Begin() + pos;
 }
@@ -307,39 +310,54 @@ String String::Replaced(const String& replaceThis, const String& replaceWith, bo
 
 String& String::Append(const String& str)
 {
-    return *this += str;
+    return DoAppend(str, URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::Append(const char* str)
 {
-    return *this += str;
+    return DoAppend(str, CStringLength(str), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::Append(char c)
 {
-    return *this += c;
+    return DoAppend(&c, 1, URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::Append(const char* str, unsigned length)
+{
+    return DoAppend(str, length, URHO3D_ALLOCATION_CALL_SITE);
+}
+
+String& String::DoAppend(const char* str, unsigned length, void* callSite)
 {
     if (str)
     {
         unsigned oldLength = length_;
-        Resize(oldLength + length);
-        CopyChars(&buffer_[oldLength], str, length);
+        DoResize(oldLength + length, callSite);
+        CopyChars(&Buffer()[oldLength], str, length);
     }
     return *this;
 }
 
+String& String::DoAppend(const String& str, void* callSite)
+{
+    // Obtain the length before resizing, in case the other string is this string
+    unsigned oldLength = length_;
+    unsigned strLength = str.length_;
+    DoResize(oldLength + strLength, callSite);
+    CopyChars(Buffer() + oldLength, str.Buffer(), strLength);
+    return *this;
+}
+
 void String::Insert(unsigned pos, const String& str)
 {
     if (pos > length_)
         pos = length_;
 
     if (pos == length_)
-        (*this) += str;
+        DoAppend(str, URHO3D_ALLOCATION_CALL_SITE);
     else
-        Replace(pos, 0, str);
+        Replace(pos, 0, str.Buffer(), str.length_, URHO3D_ALLOCATION_CALL_SITE);
 }
 
 void String::Insert(unsigned pos, char c)
@@ -348,13 +366,13 @@ void String::Insert(unsigned pos, char c)
         pos = length_;
 
     if (pos == length_)
-        (*this) += c;
+        DoAppend(&c, 1, URHO3D_ALLOCATION_CALL_SITE);
     else
     {
         unsigned oldLength = length_;
-        Resize(length_ + 1);
+        DoResize(length_ + 1, URHO3D_ALLOCATION_CALL_SITE);
         MoveRange(pos + 1, pos, oldLength - pos);
-        buffer_[pos] = c;
+        Buffer()[pos] = c;
     }
 }
 
@@ -374,7 +392,7 @@ String::Iterator String::Insert(const String::Iterator& dest, const String::Iter
     if (pos > length_)
         pos = length_;
     auto length = (unsigned)(end - start);
-    Replace(pos, 0, &(*start), length);
+    Replace(pos, 0, &(*start), length, URHO3D_ALLOCATION_CALL_SITE);
 
     return Begin() + pos;
 }
@@ -417,62 +435,90 @@ String::Iterator String::Erase(const String::Iterator& start, const String::Iter
 
 void String::Resize(unsigned newLength)
 {
-    if (!capacity_)
-    {
-        // If zero length requested, do not allocate buffer yet
-        if (!newLength)
-            return;
+    DoResize(newLength, URHO3D_ALLOCATION_CALL_SITE);
+}
 
-        // Calculate initial capacity
-        capacity_ = newLength + 1;
-        if (capacity_ < MIN_CAPACITY)
-            capacity_ = MIN_CAPACITY;
+void String::Reserve(unsigned newCapacity)
+{
+    DoReserve(newCapacity, URHO3D_ALLOCATION_CALL_SITE);
+}
 
-        buffer_ = new char[capacity_];
-    }
-    else
+void String::DoResize(unsigned newLength, void* callSite)
+{
+    unsigned capacity = capacity_ ? capacity_ : INLINE_CAPACITY;
+    if (capacity < newLength + 1)
     {
-        if (newLength && capacity_ < newLength + 1)
+        if (!capacity_)
+        {
+            // Calculate initial capacity when moving out of the inline buffer
+            capacity = newLength + 1;
+            if (capacity < MIN_CAPACITY)
+                capacity = MIN_CAPACITY;
+        }
+        else
         {
             // Increase the capacity with half each time it is exceeded
-            while (capacity_ < newLength + 1)
-                capacity_ += (capacity_ + 1) >> 1u;
+            while (capacity < newLength + 1)
+                capacity += (capacity + 1) >> 1u;
+        }
 
-            auto* newBuffer = new char[capacity_];
-            // Move the existing data to the new buffer, then delete the old buffer
-            if (length_)
-                CopyChars(newBuffer, buffer_, length_);
+#ifdef URHO3D_TRACK_ALLOCATIONS
+        AllocationTracker::RecordSourceAllocation(ALLOC_SOURCE_STRING, capacity, callSite);
+#endif
+        auto* newBuffer = new char[capacity];
+        // Move the existing data to the new buffer, then delete the old buffer
+        if (length_)
+            CopyChars(newBuffer, Buffer(), length_);
+        if (capacity_)
             delete[] buffer_;
 
-            buffer_ = newBuffer;
-        }
+        // The buffer pointer shares storage with the inline buffer, so set it only after copying
+        buffer_ = newBuffer;
+        capacity_ = capacity;
     }
 
-    buffer_[newLength] = 0;
+    Buffer()[newLength] = 0;
     length_ = newLength;
 }
 
-void String::Reserve(unsigned newCapacity)
+void String::DoReserve(unsigned newCapacity, void* callSite)
 {
     if (newCapacity < length_ + 1)
         newCapacity = length_ + 1;
+
+    if (newCapacity <= INLINE_CAPACITY)
+    {
+        // Move back to the inline buffer if the string is allocated
+        if (capacity_)
+        {
+            char* oldBuffer = buffer_;
+            CopyChars(inlineBuffer_, oldBuffer, length_ + 1);
+            delete[] oldBuffer;
+            capacity_ = 0;
+        }
+        return;
+    }
+
     if (newCapacity == capacity_)
         return;
 
+#ifdef URHO3D_TRACK_ALLOCATIONS
+    AllocationTracker::RecordSourceAllocation(ALLOC_SOURCE_STRING, newCapacity, callSite);
+#endif
     auto* newBuffer = new char[newCapacity];
     // Move the existing data to the new buffer, then delete the old buffer
-    CopyChars(newBuffer, buffer_, length_ + 1);
+    CopyChars(newBuffer, Buffer(), length_ + 1);
     if (capacity_)
         delete[] buffer_;
 
-    capacity_ = newCapacity;
     buffer_ = newBuffer;
+    capacity_ = newCapacity;
 }
 
 void String::Compact()
 {
     if (capacity_)
-        Reserve(length_ + 1);
+        DoReserve(length_ + 1, URHO3D_ALLOCATION_CALL_SITE);
 }
 
 void String::Clear()
@@ -482,9 +528,14 @@ void String::Clear()
 
 void String::Swap(String& str)
 {
+    // The string does not point into itself, so the inline buffer or the buffer pointer can be swapped as raw bytes
+    char temp[INLINE_CAPACITY];
+    memcpy(temp, inlineBuffer_, INLINE_CAPACITY);
+    memcpy(inlineBuffer_, str.inlineBuffer_, INLINE_CAPACITY);
+    memcpy(str.inlineBuffer_, temp, INLINE_CAPACITY);
+
     Urho3D::Swap(length_, str.length_);
     Urho3D::Swap(capacity_, str.capacity_);
-    Urho3D::Swap(buffer_, str.buffer_);
 }
 
 String String::Substring(unsigned pos) const
@@ -492,8 +543,8 @@ String String::Substring(unsigned pos) const
     if (pos < length_)
     {
         String ret;
-        ret.Resize(length_ - pos);
-        CopyChars(ret.buffer_, buffer_ + pos, ret.length_);
+        ret.DoResize(length_ - pos, URHO3D_ALLOCATION_CALL_SITE);
+        CopyChars(ret.Buffer(), Buffer() + pos, ret.length_);
 
         return ret;
     }
@@ -508,8 +559,8 @@ String String::Substring(unsigned pos, unsigned length) const
         String ret;
         if (pos + length > length_)
             length = length_ - pos;
-        ret.Resize(length);
-        CopyChars(ret.buffer_, buffer_ + pos, ret.length_);
+        ret.DoResize(length, URHO3D_ALLOCATION_CALL_SITE);
+        CopyChars(ret.Buffer(), Buffer() + pos, ret.length_);
 
         return ret;
     }
@@ -524,14 +575,14 @@ String String::Trimmed() const
 
     while (trimStart < trimEnd)
     {
-        char c = buffer_[trimStart];
+        char c = Buffer()[trimStart];
         if (c != ' ' && c != 9)
             break;
         ++trimStart;
     }
     while (trimEnd > trimStart)
     {
-        char c = buffer_[trimEnd - 1];
+        char c = Buffer()[trimEnd - 1];
         if (c != ' ' && c != 9)
             break;
         --trimEnd;
@@ -544,7 +595,7 @@ String String::ToLower() const
 {
     String ret(*this);
     for (unsigned i = 0; i < ret.length_; ++i)
-        ret[i] = (char)tolower(buffer_[i]);
+        ret[i] = (char)tolower(Buffer()[i]);
 
     return ret;
 }
@@ -553,7 +604,7 @@ String String::ToUpper() const
 {
     String ret(*this);
     for (unsigned i = 0; i < ret.length_; ++i)
-        ret[i] = (char)toupper(buffer_[i]);
+        ret[i] = (char)toupper(Buffer()[i]);
 
     return ret;
 }
@@ -574,7 +625,7 @@ unsigned String::Find(char c, unsigned startPos, bool caseSensitive) const
     {
         for (unsigned i = startPos; i < length_; ++i)
         {
-            if (buffer_[i] == c)
+            if (Buffer()[i] == c)
                 return i;
         }
     }
@@ -583,7 +634,7 @@ unsigned String::Find(char c, unsigned startPos, bool caseSensitive) const
         c = (char)tolower(c);
         for (unsigned i = startPos; i < length_; ++i)
         {
-            if (tolower(buffer_[i]) == c)
+            if (tolower(Buffer()[i]) == c)
                 return i;
         }
     }
@@ -596,13 +647,13 @@ unsigned String::Find(const String& str, unsigned startPos, bool caseSensitive)
     if (!str.length_ || str.length_ > length_)
         return NPOS;
 
-    char first = str.buffer_[0];
+    char first = str.Buffer()[0];
     if (!caseSensitive)
         first = (char)tolower(first);
 
     for (unsigned i = startPos; i <= length_ - str.length_; ++i)
     {
-        char c = buffer_[i];
+        char c = Buffer()[i];
         if (!caseSensitive)
             c = (char)tolower(c);
 
@@ -612,8 +663,8 @@ unsigned String::Find(const String& str, unsigned startPos, bool caseSensitive)
             bool found = true;
             for (unsigned j = 1; j < str.length_; ++j)
             {
-                c = buffer_[i + j];
-                char d = str.buffer_[j];
+                c = Buffer()[i + j];
+                char d = str.Buffer()[j];
                 if (!caseSensitive)
                 {
                     c = (char)tolower(c);
@@ -648,7 +699,7 @@ unsigned String::FindLast(char c, unsigned startPos, bool caseSensitive) const
     {
         for (unsigned i = startPos; i < length_; --i)
         {
-            if (buffer_[i] == c)
+            if (Buffer()[i] == c)
                 return i;
         }
     }
@@ -657,7 +708,7 @@ unsigned String::FindLast(char c, unsigned startPos, bool caseSensitive) const
         c = (char)tolower(c);
         for (unsigned i = startPos; i < length_; --i)
         {
-            if (tolower(buffer_[i]) == c)
+            if (tolower(Buffer()[i]) == c)
                 return i;
         }
     }
@@ -672,13 +723,13 @@ unsigned String::FindLast(const String& str, unsigned startPos, bool caseSensiti
     if (startPos > length_ - str.length_)
         startPos = length_ - str.length_;
 
-    char first = str.buffer_[0];
+    char first = str.Buffer()[0];
     if (!caseSensitive)
         first = (char)tolower(first);
 
     for (unsigned i = startPos; i < length_; --i)
     {
-        char c = buffer_[i];
+        char c = Buffer()[i];
         if (!caseSensitive)
             c = (char)tolower(c);
 
@@ -687,8 +738,8 @@ unsigned String::FindLast(const String& str, unsigned startPos, bool caseSensiti
             bool found = true;
             for (unsigned j = 1; j < str.length_; ++j)
             {
-                c = buffer_[i + j];
-                char d = str.buffer_[j];
+                c = Buffer()[i + j];
+                char d = str.Buffer()[j];
                 if (!caseSensitive)
                 {
                     c = (char)tolower(c);
@@ -781,10 +832,10 @@ unsigned String::LengthUTF8() const
 {
     unsigned ret = 0;
 
-    const char* src = buffer_;
+    const char* src = Buffer();
     if (!src)
         return ret;
-    const char* end = buffer_ + length_;
+    const char* end = Buffer() + length_;
 
     while (src < end)
     {
@@ -811,12 +862,12 @@ unsigned String::ByteOffsetUTF8(unsigned index) const
 
 unsigned String::NextUTF8Char(unsigned& byteOffset) const
 {
-    if (!buffer_)
+    if (!Buffer())
         return 0;
 
-    const char* src = buffer_ + byteOffset;
+    const char* src = Buffer() + byteOffset;
     unsigned ret = DecodeUTF8(src);
-    byteOffset = (unsigned)(src - buffer_);
+    byteOffset = (unsigned)(src - Buffer());
 
     return ret;
 }
@@ -849,7 +900,7 @@ void String::ReplaceUTF8(unsigned index, unsigned unicodeChar)
     EncodeUTF8(dest, unicodeChar);
     *dest = 0;
 
-    Replace(beginCharPos, byteOffset - beginCharPos, temp, (unsigned)(dest - temp));
+    Replace(beginCharPos, byteOffset - beginCharPos, temp, (unsigned)(dest - temp), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String& String::AppendUTF8(unsigned unicodeChar)
@@ -858,7 +909,7 @@ String& String::AppendUTF8(unsigned unicodeChar)
     char* dest = temp;
     EncodeUTF8(dest, unicodeChar);
     *dest = 0;
-    return Append(temp);
+    return DoAppend(temp, (unsigned)(dest - temp), URHO3D_ALLOCATION_CALL_SITE);
 }
 
 String String::SubstringUTF8(unsigned pos) const
@@ -1211,7 +1262,7 @@ int String::Compare(const char* lhs, const char* rhs, bool caseSensitive)
     }
 }
 
-void String::Replace(unsigned pos, unsigned length, const char* srcStart, unsigned srcLength)
+void String::Replace(unsigned pos, unsigned length, const char* srcStart, unsigned srcLength, void* callSite)
 {
     int delta = (int)srcLength - (int)length;
 
@@ -1220,18 +1271,18 @@ void String::Replace(unsigned pos, unsigned length, const char* srcStart, unsign
         if (delta < 0)
         {
             MoveRange(pos + srcLength, pos + length, length_ - pos - length);
-            Resize(length_ + delta);
+            DoResize(length_ + delta, callSite);
         }
         if (delta > 0)
         {
-            Resize(length_ + delta);
+            DoResize(length_ + delta, callSite);
             MoveRange(pos + srcLength, pos + length, length_ - pos - length - delta);
         }
     }
     else
-        Resize(length_ + delta);
+        DoResize(length_ + delta, callSite);
 
-    CopyChars(buffer_ + pos, srcStart, srcLength);
+    CopyChars(Buffer() + pos, srcStart, srcLength);
 }
 
 WString::WString() :
@@ -33,6 +33,7 @@ namespace Urho3D
 
 static const int CONVERSION_BUFFER_LENGTH = 128;
 static const int MATRIX_CONVERSION_BUFFER_LENGTH = 256;
+static const int FLOAT_CONVERSION_LENGTH = 16;
 
 class WString;
 
@@ -53,7 +54,7 @@ public:
     String() noexcept :
         length_(0),
         capacity_(0),
-        buffer_(&endZero)
+        inlineBuffer_{}
     {
     }
 
@@ -61,7 +62,7 @@ public:
     String(const String& str) :
         length_(0),
         capacity_(0),
-        buffer_(&endZero)
+        inlineBuffer_{}
     {
         *this = str;
     }
@@ -70,7 +71,7 @@ public:
     String(String && str) noexcept :
         length_(0),
         capacity_(0),
-        buffer_(&endZero)
+        inlineBuffer_{}
     {
         Swap(str);
     }
@@ -79,7 +80,7 @@ public:
     String(const char* str) :   // NOLINT(google-explicit-constructor)
         length_(0),
         capacity_(0),
-        buffer_(&endZero)
+        inlineBuffer_{}
     {
         *this = str;
     }
@@ -88,7 +89,7 @@ public:
     String(char* str) :         // NOLINT(google-explicit-constructor)
         length_(0),
         capacity_(0),
-        buffer_(&endZero)
+        inlineBuffer_{}
     {
         *this = (const char*)str;
     }
@@ -97,17 +98,17 @@ public:
     String(const char* str, unsigned length) :
         length_(0),
         capacity_(0),
-        buffer_(&endZero)
+        inlineBuffer_{}
     {
-        Resize(length);
-        CopyChars(buffer_, str, length);
+        DoResize(length, URHO3D_ALLOCATION_CALL_SITE);
+        CopyChars(Buffer(), str, length);
     }
 
     /// Construct from a null-terminated wide character array.
     explicit String(const wchar_t* str) :
         length_(0),
         capacity_(0),
-        buffer_(&endZero)
+        inlineBuffer_{}
     {
         SetUTF8FromWChar(str);
     }
@@ -116,7 +117,7 @@ public:
     explicit String(wchar_t* str) :
         length_(0),
         capacity_(0),
-        buffer_(&endZero)
+        inlineBuffer_{}
     {
         SetUTF8FromWChar(str);
     }
@@ -155,7 +156,7 @@ public:
     template <class T> explicit String(const T& value) :
         length_(0),
         capacity_(0),
-        buffer_(&endZero)
+        inlineBuffer_{}
     {
         *this = value.ToString();
     }
@@ -172,8 +173,8 @@ public:
     {
         if (&rhs != this)
         {
-            Resize(rhs.length_);
-            CopyChars(buffer_, rhs.buffer_, rhs.length_);
+            DoResize(rhs.length_, URHO3D_ALLOCATION_CALL_SITE);
+            CopyChars(Buffer(), rhs.Buffer(), rhs.length_);
         }
 
         return *this;
@@ -191,8 +192,8 @@ public:
     String& operator =(const char* rhs)
     {
         unsigned rhsLength = CStringLength(rhs);
-        Resize(rhsLength);
-        CopyChars(buffer_, rhs, rhsLength);
+        DoResize(rhsLength, URHO3D_ALLOCATION_CALL_SITE);
+        CopyChars(Buffer(), rhs, rhsLength);
 
         return *this;
     }
@@ -201,8 +202,8 @@ public:
     String& operator +=(const String& rhs)
     {
         unsigned oldLength = length_;
-        Resize(length_ + rhs.length_);
-        CopyChars(buffer_ + oldLength, rhs.buffer_, rhs.length_);
+        DoResize(length_ + rhs.length_, URHO3D_ALLOCATION_CALL_SITE);
+        CopyChars(Buffer() + oldLength, rhs.Buffer(), rhs.length_);
 
         return *this;
     }
@@ -212,8 +213,8 @@ public:
     {
         unsigned rhsLength = CStringLength(rhs);
         unsigned oldLength = length_;
-        Resize(length_ + rhsLength);
-        CopyChars(buffer_ + oldLength, rhs, rhsLength);
+        DoResize(length_ + rhsLength, URHO3D_ALLOCATION_CALL_SITE);
+        CopyChars(Buffer() + oldLength, rhs, rhsLength);
 
         return *this;
     }
@@ -222,8 +223,8 @@ public:
     String& operator +=(char rhs)
     {
         unsigned oldLength = length_;
-        Resize(length_ + 1);
-        buffer_[oldLength] = rhs;
+        DoResize(length_ + 1, URHO3D_ALLOCATION_CALL_SITE);
+        Buffer()[oldLength] = rhs;
 
         return *this;
     }
@@ -256,9 +257,9 @@ public:
     String operator +(const String& rhs) const
     {
         String ret;
-        ret.Resize(length_ + rhs.length_);
-        CopyChars(ret.buffer_, buffer_, length_);
-        CopyChars(ret.buffer_ + length_, rhs.buffer_, rhs.length_);
+        ret.DoResize(length_ + rhs.length_, URHO3D_ALLOCATION_CALL_SITE);
+        CopyChars(ret.Buffer(), Buffer(), length_);
+        CopyChars(ret.Buffer() + length_, rhs.Buffer(), rhs.length_);
 
         return ret;
     }
@@ -268,9 +269,9 @@ public:
     {
         unsigned rhsLength = CStringLength(rhs);
         String ret;
-        ret.Resize(length_ + rhsLength);
-        CopyChars(ret.buffer_, buffer_, length_);
-        CopyChars(ret.buffer_ + length_, rhs, rhsLength);
+        ret.DoResize(length_ + rhsLength, URHO3D_ALLOCATION_CALL_SITE);
+        CopyChars(ret.Buffer(), Buffer(), length_);
+        CopyChars(ret.Buffer() + length_, rhs, rhsLength);
 
         return ret;
     }
@@ -303,28 +304,28 @@ public:
     char& operator [](unsigned index)
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
 
     /// Return const char at index.
     const char& operator [](unsigned index) const
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
 
     /// Return char at index.
     char& At(unsigned index)
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
 
     /// Return const char at index.
     const char& At(unsigned index) const
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
 
     /// Replace all occurrences of a character.
@@ -377,22 +378,22 @@ public:
     void Swap(String& str);
 
     /// Return iterator to the beginning.
-    Iterator Begin() { return Iterator(buffer_); }
+    Iterator Begin() { return Iterator(Buffer()); }
 
     /// Return const iterator to the beginning.
-    ConstIterator Begin() const { return ConstIterator(buffer_); }
+    ConstIterator Begin() const { return ConstIterator(Buffer()); }
 
     /// Return iterator to the end.
-    Iterator End() { return Iterator(buffer_ + length_); }
+    Iterator End() { return Iterator(Buffer() + length_); }
 
     /// Return const iterator to the end.
-    ConstIterator End() const { return ConstIterator(buffer_ + length_); }
+    ConstIterator End() const { return ConstIterator(Buffer() + length_); }
 
     /// Return first char, or 0 if empty.
-    char Front() const { return buffer_[0]; }
+    char Front() const { return Buffer()[0]; }
 
     /// Return last char, or 0 if empty.
-    char Back() const { return length_ ? buffer_[length_ - 1] : buffer_[0]; }
+    char Back() const { return length_ ? Buffer()[length_ - 1] : Buffer()[0]; }
 
     /// Return a substring from position to end.
     String Substring(unsigned pos) const;
@@ -422,12 +423,12 @@ public:
     bool EndsWith(const String& str, bool caseSensitive = true) const;
 
     /// Return the C string.
-    const char* CString() const { return buffer_; }
+    const char* CString() const { return Buffer(); }
 
     /// Return length.
     unsigned Length() const { return length_; }
 
-    /// Return buffer capacity.
+    /// Return buffer capacity, zero if the string is stored in the inline buffer.
     unsigned Capacity() const { return capacity_; }
 
     /// Return whether the string is empty.
@@ -469,7 +470,7 @@ public:
     unsigned ToHash() const
     {
         unsigned hash = 0;
-        const char* ptr = buffer_;
+        const char* ptr = Buffer();
         while (*ptr)
         {
             hash = *ptr + (hash << 6u) + (hash << 16u) - hash;
@@ -509,15 +510,23 @@ public:
     static const unsigned NPOS = 0xffffffff;
     /// Initial dynamic allocation size.
     static const unsigned MIN_CAPACITY = 8;
+    /// Capacity of the inline buffer, including the terminating zero. Strings that fit in it do not allocate memory. The inline buffer shares storage with the buffer pointer, so the size of the string does not change.
+    static const unsigned INLINE_CAPACITY = sizeof(char*);
     /// Empty string.
     static const String EMPTY;
 
 private:
+    /// Return the string buffer.
+    char* Buffer() { return capacity_ ? buffer_ : inlineBuffer_; }
+
+    /// Return the string buffer.
+    const char* Buffer() const { return capacity_ ? buffer_ : inlineBuffer_; }
+
     /// Move a range of characters within the string.
     void MoveRange(unsigned dest, unsigned src, unsigned count)
     {
         if (count)
-            memmove(buffer_ + dest, buffer_ + src, count);
+            memmove(Buffer() + dest, Buffer() + src, count);
     }
 
     /// Copy chars from one buffer to another.
@@ -537,18 +546,28 @@ private:
 #endif
     }
 
-    /// Replace a substring with another substring.
-    void Replace(unsigned pos, unsigned length, const char* srcStart, unsigned srcLength);
+    /// Resize the string, recording an allocation for the given call site.
+    void DoResize(unsigned newLength, void* callSite);
+    /// Set new capacity, recording the allocation for the given call site.
+    void DoReserve(unsigned newCapacity, void* callSite);
+    /// Append characters, recording an allocation for the given call site.
+    String& DoAppend(const char* str, unsigned length, void* callSite);
+    /// Append a string, recording an allocation for the given call site.
+    String& DoAppend(const String& str, void* callSite);
+    /// Replace a substring with another substring, recording an allocation for the given call site.
+    void Replace(unsigned pos, unsigned length, const char* srcStart, unsigned srcLength, void* callSite);
 
     /// String length.
     unsigned length_;
     /// Capacity, zero if buffer not allocated.
     unsigned capacity_;
-    /// String buffer, point to &endZero if buffer is not allocated.
-    char* buffer_;
-
-    /// End zero for empty strings.
-    static char endZero;
+    union
+    {
+        /// Allocated string buffer.
+        char* buffer_;
+        /// Inline buffer for short strings, used while the capacity is zero.
+        char inlineBuffer_[INLINE_CAPACITY];
+    };
 };
 
 /// Add a string to a C string.
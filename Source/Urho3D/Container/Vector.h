@@ -70,19 +70,19 @@ public:
     /// Construct with initial data.
     Vector(const T* data, unsigned size)
     {
-        DoInsertElements(0, data, data + size, CopyTag{});
+        DoInsertElements(0, data, data + size, CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Copy-construct from another vector.
     Vector(const Vector<T>& vector)
     {
-        DoInsertElements(0, vector.Begin(), vector.End(), CopyTag{});
+        DoInsertElements(0, vector.Begin(), vector.End(), CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Copy-construct from another vector (iterator version).
     Vector(ConstIterator start, ConstIterator end)
     {
-        DoInsertElements(0, start, end, CopyTag{});
+        DoInsertElements(0, start, end, CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Move-construct from another vector.
@@ -104,7 +104,8 @@ public:
     ~Vector()
     {
         DestructElements(Buffer(), size_);
-        delete[] buffer_;
+        if (!externalBuffer_)
+            delete[] buffer_;
     }
 
     /// Assign from another vector.
@@ -127,17 +128,32 @@ public:
         return *this;
     }
 
+    /// Swap with another vector.
+    void Swap(Vector<T>& rhs)
+    {
+        if (!externalBuffer_ && !rhs.externalBuffer_)
+            VectorBase::Swap(rhs);
+        else
+        {
+            // External buffers can not change owner, so go through a temporary vector
+            Vector<T> temp;
+            temp.MoveFrom(rhs);
+            rhs.MoveFrom(*this);
+            MoveFrom(temp);
+        }
+    }
+
     /// Add-assign an element.
     Vector<T>& operator +=(const T& rhs)
     {
-        Push(rhs);
+        DoInsertElements(size_, &rhs, &rhs + 1, CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
         return *this;
     }
 
     /// Add-assign another vector.
     Vector<T>& operator +=(const Vector<T>& rhs)
     {
-        Push(rhs);
+        DoInsertElements(size_, rhs.Begin(), rhs.End(), CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
         return *this;
     }
 
@@ -231,7 +247,7 @@ public:
         else
         {
             T value(std::forward<Args>(args)...);
-            Push(std::move(value));
+            DoInsertElements(size_, &value, &value + 1, MoveTag{}, URHO3D_ALLOCATION_CALL_SITE);
         }
         return Back();
     }
@@ -247,7 +263,7 @@ public:
             new (&Back()) T(value);
         }
         else
-            DoInsertElements(size_, &value, &value + 1, CopyTag{});
+            DoInsertElements(size_, &value, &value + 1, CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Move-add an element at the end.
@@ -260,7 +276,7 @@ public:
             new (&Back()) T(std::move(value));
         }
         else
-            DoInsertElements(size_, &value, &value + 1, MoveTag{});
+            DoInsertElements(size_, &value, &value + 1, MoveTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 #else
     // FIXME: Attempt had been made to use this model in the Coverity-Scan model file without any success
@@ -268,12 +284,15 @@ public:
     void Push(const T& value)
     {
         T array[] = {value};
-        DoInsertElements(size_, array, array + 1, CopyTag{});
+        DoInsertElements(size_, array, array + 1, CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 #endif
 
     /// Add another vector at the end.
-    void Push(const Vector<T>& vector) { DoInsertElements(size_, vector.Begin(), vector.End(), CopyTag{}); }
+    void Push(const Vector<T>& vector)
+    {
+        DoInsertElements(size_, vector.Begin(), vector.End(), CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
+    }
 
     /// Remove the last element.
     void Pop()
@@ -285,54 +304,54 @@ public:
     /// Insert an element at position.
     void Insert(unsigned pos, const T& value)
     {
-        DoInsertElements(pos, &value, &value + 1, CopyTag{});
+        DoInsertElements(pos, &value, &value + 1, CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Insert an element at position.
     void Insert(unsigned pos, T && value)
     {
-        DoInsertElements(pos, &value, &value + 1, MoveTag{});
+        DoInsertElements(pos, &value, &value + 1, MoveTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Insert another vector at position.
     void Insert(unsigned pos, const Vector<T>& vector)
     {
-        DoInsertElements(pos, vector.Begin(), vector.End(), CopyTag{});
+        DoInsertElements(pos, vector.Begin(), vector.End(), CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Insert an element by iterator.
     Iterator Insert(const Iterator& dest, const T& value)
     {
         auto pos = (unsigned)(dest - Begin());
-        return DoInsertElements(pos, &value, &value + 1, CopyTag{});
+        return DoInsertElements(pos, &value, &value + 1, CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Move-insert an element by iterator.
     Iterator Insert(const Iterator& dest, T && value)
     {
         auto pos = (unsigned)(dest - Begin());
-        return DoInsertElements(pos, &value, &value + 1, MoveTag{});
+        return DoInsertElements(pos, &value, &value + 1, MoveTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Insert a vector by iterator.
     Iterator Insert(const Iterator& dest, const Vector<T>& vector)
     {
         auto pos = (unsigned)(dest - Begin());
-        return DoInsertElements(pos, vector.Begin(), vector.End(), CopyTag{});
+        return DoInsertElements(pos, vector.Begin(), vector.End(), CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Insert a vector partially by iterators.
     Iterator Insert(const Iterator& dest, const ConstIterator& start, const ConstIterator& end)
     {
         auto pos = (unsigned)(dest - Begin());
-        return DoInsertElements(pos, start, end, CopyTag{});
+        return DoInsertElements(pos, start, end, CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Insert elements.
     Iterator Insert(const Iterator& dest, const T* start, const T* end)
     {
         auto pos = (unsigned)(dest - Begin());
-        return DoInsertElements(pos, start, end, CopyTag{});
+        return DoInsertElements(pos, start, end, CopyTag{}, URHO3D_ALLOCATION_CALL_SITE);
     }
 
     /// Erase a range of elements.
@@ -422,44 +441,22 @@ public:
     void Clear() { Resize(0); }
 
     /// Resize the vector.
-    void Resize(unsigned newSize) { DoResize(newSize); }
+    void Resize(unsigned newSize) { DoResize(newSize, URHO3D_ALLOCATION_CALL_SITE); }
 
     /// Resize the vector and fill new elements with default value.
     void Resize(unsigned newSize, const T& value)
     {
         unsigned oldSize = Size();
-        DoResize(newSize);
+        DoResize(newSize, URHO3D_ALLOCATION_CALL_SITE);
         for (unsigned i = oldSize; i < newSize; ++i)
             At(i) = value;
     }
 
     /// Set new capacity.
-    void Reserve(unsigned newCapacity)
-    {
-        if (newCapacity < size_)
-            newCapacity = size_;
-
-        if (newCapacity != capacity_)
-        {
-            T* newBuffer = nullptr;
-            capacity_ = newCapacity;
-
-            if (capacity_)
-            {
-                newBuffer = reinterpret_cast<T*>(AllocateBuffer((unsigned)(capacity_ * sizeof(T))));
-                // Move the data into the new buffer
-                ConstructElements(newBuffer, Begin(), End(), MoveTag{});
-            }
-
-            // Delete the old buffer
-            DestructElements(Buffer(), size_);
-            delete[] buffer_;
-            buffer_ = reinterpret_cast<unsigned char*>(newBuffer);
-        }
-    }
+    void Reserve(unsigned newCapacity) { DoReserve(newCapacity, URHO3D_ALLOCATION_CALL_SITE); }
 
     /// Reallocate so that no extra memory is used.
-    void Compact() { Reserve(size_); }
+    void Compact() { DoReserve(size_, URHO3D_ALLOCATION_CALL_SITE); }
 
     /// Return iterator to value, or to the end if not found.
     Iterator Find(const T& value)
@@ -579,8 +576,39 @@ private:
         }
     }
 
+    /// Set new capacity, recording the allocation for the given call site.
+    void DoReserve(unsigned newCapacity, void* callSite)
+    {
+        if (newCapacity < size_)
+            newCapacity = size_;
+
+        // Do not move out of an external buffer to a smaller one
+        if (externalBuffer_ && newCapacity <= capacity_)
+            return;
+
+        if (newCapacity != capacity_)
+        {
+            T* newBuffer = nullptr;
+            capacity_ = newCapacity;
+
+            if (capacity_)
+            {
+                newBuffer = reinterpret_cast<T*>(AllocateBuffer((unsigned)(capacity_ * sizeof(T)), callSite));
+                // Move the data into the new buffer
+                ConstructElements(newBuffer, Begin(), End(), MoveTag{});
+            }
+
+            // Delete the old buffer
+            DestructElements(Buffer(), size_);
+            if (!externalBuffer_)
+                delete[] buffer_;
+            buffer_ = reinterpret_cast<unsigned char*>(newBuffer);
+            externalBuffer_ = 0;
+        }
+    }
+
     /// Resize the vector and create/remove new elements as necessary.
-    void DoResize(unsigned newSize)
+    void DoResize(unsigned newSize, void* callSite)
     {
         // If size shrinks, destruct the removed elements
         if (newSize < size_)
@@ -594,14 +622,15 @@ private:
 
                 // Reallocate vector
                 Vector<T> newVector;
-                newVector.Reserve(CalculateCapacity(newSize, capacity_));
+                newVector.DoReserve(CalculateCapacity(newSize, capacity_), callSite);
                 newVector.size_ = size_;
                 T* dest = newVector.Buffer();
 
                 // Move old elements
                 ConstructElements(dest, src, src + size_, MoveTag{});
 
-                Swap(newVector);
+                // The temporary vector destructs the old elements and frees the old buffer
+                VectorBase::Swap(newVector);
             }
 
             // Initialize the new elements
@@ -613,7 +642,7 @@ private:
 
     /// Insert elements into the vector using copy or move constructor.
     template <class Tag, class RandomIteratorT>
-    Iterator DoInsertElements(unsigned pos, RandomIteratorT start, RandomIteratorT end, Tag)
+    Iterator DoInsertElements(unsigned pos, RandomIteratorT start, RandomIteratorT end, Tag, void* callSite)
     {
         if (pos > size_)
             pos = size_;
@@ -625,7 +654,7 @@ private:
 
             // Reallocate vector
             Vector<T> newVector;
-            newVector.Reserve(CalculateCapacity(size_ + numElements, capacity_));
+            newVector.DoReserve(CalculateCapacity(size_ + numElements, capacity_), callSite);
             newVector.size_ = size_ + numElements;
             T* dest = newVector.Buffer();
 
@@ -638,7 +667,7 @@ private:
             if (pos < size_)
                 ConstructElements(dest + pos + numElements, src + pos, src + size_, MoveTag{});
 
-            Swap(newVector);
+            VectorBase::Swap(newVector);
         }
         else if (numElements > 0)
         {
@@ -671,6 +700,29 @@ private:
         return Begin() + pos;
     }
 
+    /// Move the elements of another vector to this empty vector and leave the other vector empty. Takes over an owned buffer unless the elements fit in this vector's external buffer.
+    void MoveFrom(Vector<T>& rhs)
+    {
+        assert(!size_);
+        if (!rhs.externalBuffer_ && (!externalBuffer_ || rhs.size_ > capacity_))
+        {
+            if (!externalBuffer_)
+                delete[] buffer_;
+            buffer_ = rhs.buffer_;
+            size_ = rhs.size_;
+            capacity_ = rhs.capacity_;
+            externalBuffer_ = 0;
+            rhs.buffer_ = nullptr;
+            rhs.size_ = 0;
+            rhs.capacity_ = 0;
+        }
+        else
+        {
+            DoInsertElements(0, rhs.Begin(), rhs.End(), MoveTag{}, URHO3D_ALLOCATION_CALL_SITE);
+            rhs.Clear();
+        }
+    }
+
     /// Call the elements' destructors.
     static void DestructElements(T* dest, unsigned count)
     {
@@ -730,7 +782,8 @@ public:
     /// Destruct.
     ~PODVector()
     {
-        delete[] buffer_;
+        if (!externalBuffer_)
+            delete[] buffer_;
     }
 
     /// Assign from another vector.
@@ -745,17 +798,32 @@ public:
         return *this;
     }
 
+    /// Swap with another vector.
+    void Swap(PODVector<T>& rhs)
+    {
+        if (!externalBuffer_ && !rhs.externalBuffer_)
+            VectorBase::Swap(rhs);
+        else
+        {
+            // External buffers can not change owner, so go through a temporary vector
+            PODVector<T> temp;
+            temp.MoveFrom(rhs);
+            rhs.MoveFrom(*this);
+            MoveFrom(temp);
+        }
+    }
+
     /// Add-assign an element.
     PODVector<T>& operator +=(const T& rhs)
     {
-        Push(rhs);
+        DoPush(rhs, URHO3D_ALLOCATION_CALL_SITE);
         return *this;
     }
 
     /// Add-assign another vector.
     PODVector<T>& operator +=(const PODVector<T>& rhs)
     {
-        Push(rhs);
+        DoPush(rhs, URHO3D_ALLOCATION_CALL_SITE);
         return *this;
     }
 
@@ -838,24 +906,10 @@ public:
     }
 
     /// Add an element at the end.
-    void Push(const T& value)
-    {
-        if (size_ < capacity_)
-            ++size_;
-        else
-            Resize(size_ + 1);
-        Back() = value;
-    }
+    void Push(const T& value) { DoPush(value, URHO3D_ALLOCATION_CALL_SITE); }
 
     /// Add another vector at the end.
-    void Push(const PODVector<T>& vector)
-    {
-        // Obtain the size before resizing, in case the other vector is another reference to this vector
-        unsigned thisSize = size_;
-        unsigned vectorSize = vector.size_;
-        Resize(thisSize + vectorSize);
-        CopyElements(Buffer() + thisSize, vector.Buffer(), vectorSize);
-    }
+    void Push(const PODVector<T>& vector) { DoPush(vector, URHO3D_ALLOCATION_CALL_SITE); }
 
     /// Remove the last element.
     void Pop()
@@ -871,7 +925,7 @@ public:
             pos = size_;
 
         unsigned oldSize = size_;
-        Resize(size_ + 1);
+        DoResize(size_ + 1, URHO3D_ALLOCATION_CALL_SITE);
         MoveRange(pos + 1, pos, oldSize - pos);
         Buffer()[pos] = value;
     }
@@ -883,7 +937,7 @@ public:
             pos = size_;
 
         unsigned oldSize = size_;
-        Resize(size_ + vector.size_);
+        DoResize(size_ + vector.size_, URHO3D_ALLOCATION_CALL_SITE);
         MoveRange(pos + vector.size_, pos, oldSize - pos);
         CopyElements(Buffer() + pos, vector.Buffer(), vector.size_);
     }
@@ -917,7 +971,7 @@ public:
         if (pos > size_)
             pos = size_;
         auto length = (unsigned)(end - start);
-        Resize(size_ + length);
+        DoResize(size_ + length, URHO3D_ALLOCATION_CALL_SITE);
         MoveRange(pos + length, pos, size_ - pos - length);
         CopyElements(Buffer() + pos, &(*start), length);
 
@@ -931,7 +985,7 @@ public:
         if (pos > size_)
             pos = size_;
         auto length = (unsigned)(end - start);
-        Resize(size_ + length);
+        DoResize(size_ + length, URHO3D_ALLOCATION_CALL_SITE);
         MoveRange(pos + length, pos, size_ - pos - length);
 
         T* destPtr = Buffer() + pos;
@@ -1028,57 +1082,13 @@ public:
     void Clear() { Resize(0); }
 
     /// Resize the vector.
-    void Resize(unsigned newSize)
-    {
-        if (newSize > capacity_)
-        {
-            if (!capacity_)
-                capacity_ = newSize;
-            else
-            {
-                while (capacity_ < newSize)
-                    capacity_ += (capacity_ + 1) >> 1;
-            }
-
-            unsigned char* newBuffer = AllocateBuffer((unsigned)(capacity_ * sizeof(T)));
-            // Move the data into the new buffer and delete the old
-            if (buffer_)
-            {
-                CopyElements(reinterpret_cast<T*>(newBuffer), Buffer(), size_);
-                delete[] buffer_;
-            }
-            buffer_ = newBuffer;
-        }
-
-        size_ = newSize;
-    }
+    void Resize(unsigned newSize) { DoResize(newSize, URHO3D_ALLOCATION_CALL_SITE); }
 
     /// Set new capacity.
-    void Reserve(unsigned newCapacity)
-    {
-        if (newCapacity < size_)
-            newCapacity = size_;
-
-        if (newCapacity != capacity_)
-        {
-            unsigned char* newBuffer = nullptr;
-            capacity_ = newCapacity;
-
-            if (capacity_)
-            {
-                newBuffer = AllocateBuffer((unsigned)(capacity_ * sizeof(T)));
-                // Move the data into the new buffer
-                CopyElements(reinterpret_cast<T*>(newBuffer), Buffer(), size_);
-            }
-
-            // Delete the old buffer
-            delete[] buffer_;
-            buffer_ = newBuffer;
-        }
-    }
+    void Reserve(unsigned newCapacity) { DoReserve(newCapacity, URHO3D_ALLOCATION_CALL_SITE); }
 
     /// Reallocate so that no extra memory is used.
-    void Compact() { Reserve(size_); }
+    void Compact() { DoReserve(size_, URHO3D_ALLOCATION_CALL_SITE); }
 
     /// Return iterator to value, or to the end if not found.
     Iterator Find(const T& value)
@@ -1152,6 +1162,84 @@ public:
     T* Buffer() const { return reinterpret_cast<T*>(buffer_); }
 
 private:
+    /// Add an element at the end, recording an allocation for the given call site.
+    void DoPush(const T& value, void* callSite)
+    {
+        if (size_ < capacity_)
+            ++size_;
+        else
+            DoResize(size_ + 1, callSite);
+        Back() = value;
+    }
+
+    /// Add another vector at the end, recording an allocation for the given call site.
+    void DoPush(const PODVector<T>& vector, void* callSite)
+    {
+        // Obtain the size before resizing, in case the other vector is another reference to this vector
+        unsigned thisSize = size_;
+        unsigned vectorSize = vector.size_;
+        DoResize(thisSize + vectorSize, callSite);
+        CopyElements(Buffer() + thisSize, vector.Buffer(), vectorSize);
+    }
+
+    /// Resize the vector, recording an allocation for the given call site.
+    void DoResize(unsigned newSize, void* callSite)
+    {
+        if (newSize > capacity_)
+        {
+            if (!capacity_)
+                capacity_ = newSize;
+            else
+            {
+                while (capacity_ < newSize)
+                    capacity_ += (capacity_ + 1) >> 1;
+            }
+
+            unsigned char* newBuffer = AllocateBuffer((unsigned)(capacity_ * sizeof(T)), callSite);
+            // Move the data into the new buffer and delete the old
+            if (buffer_)
+            {
+                CopyElements(reinterpret_cast<T*>(newBuffer), Buffer(), size_);
+                if (!externalBuffer_)
+                    delete[] buffer_;
+            }
+            buffer_ = newBuffer;
+            externalBuffer_ = 0;
+        }
+
+        size_ = newSize;
+    }
+
+    /// Set new capacity, recording the allocation for the given call site.
+    void DoReserve(unsigned newCapacity, void* callSite)
+    {
+        if (newCapacity < size_)
+            newCapacity = size_;
+
+        // Do not move out of an external buffer to a smaller one
+        if (externalBuffer_ && newCapacity <= capacity_)
+            return;
+
+        if (newCapacity != capacity_)
+        {
+            unsigned char* newBuffer = nullptr;
+            capacity_ = newCapacity;
+
+            if (capacity_)
+            {
+                newBuffer = AllocateBuffer((unsigned)(capacity_ * sizeof(T)), callSite);
+                // Move the data into the new buffer
+                CopyElements(reinterpret_cast<T*>(newBuffer), Buffer(), size_);
+            }
+
+            // Delete the old buffer
+            if (!externalBuffer_)
+                delete[] buffer_;
+            buffer_ = newBuffer;
+            externalBuffer_ = 0;
+        }
+    }
+
     /// Move a range of elements within the vector.
     void MoveRange(unsigned dest, unsigned src, unsigned count)
     {
@@ -1159,6 +1247,29 @@ private:
             memmove(Buffer() + dest, Buffer() + src, count * sizeof(T));
     }
 
+    /// Move the elements of another vector to this empty vector and leave the other vector empty. Takes over an owned buffer unless the elements fit in this vector's external buffer.
+    void MoveFrom(PODVector<T>& rhs)
+    {
+        assert(!size_);
+        if (!rhs.externalBuffer_ && (!externalBuffer_ || rhs.size_ > capacity_))
+        {
+            if (!externalBuffer_)
+                delete[] buffer_;
+            buffer_ = rhs.buffer_;
+            size_ = rhs.size_;
+            capacity_ = rhs.capacity_;
+            externalBuffer_ = 0;
+            rhs.buffer_ = nullptr;
+            rhs.size_ = 0;
+            rhs.capacity_ = 0;
+        }
+        else
+        {
+            *this = rhs;
+            rhs.Clear();
+        }
+    }
+
     /// Copy elements from one buffer to another.
     static void CopyElements(T* dest, const T* src, unsigned count)
     {
@@ -23,14 +23,20 @@
 #include "../Precompiled.h"
 
 #include "../Container/VectorBase.h"
+#ifdef URHO3D_TRACK_ALLOCATIONS
+#include "../Core/AllocationTracker.h"
+#endif
 
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
-unsigned char* VectorBase::AllocateBuffer(unsigned size)
+unsigned char* VectorBase::AllocateBuffer(unsigned size, void* callSite)
 {
+#ifdef URHO3D_TRACK_ALLOCATIONS
+    AllocationTracker::RecordSourceAllocation(ALLOC_SOURCE_VECTOR, size, callSite);
+#endif
     return new unsigned char[size];
 }
 
@@ -31,6 +31,20 @@
 #include "../Base/Iter.h"
 #include "../Container/Swap.h"
 
+// Call site recorded for container allocations. Taken in the public container functions and passed down, so that allocations
+// are attributed to the code using the container rather than the container internals
+#ifdef URHO3D_TRACK_ALLOCATIONS
+#ifdef _MSC_VER
+#include <intrin.h>
+#define URHO3D_RETURN_ADDRESS _ReturnAddress()
+#else
+#define URHO3D_RETURN_ADDRESS __builtin_return_address(0)
+#endif
+#define URHO3D_ALLOCATION_CALL_SITE URHO3D_RETURN_ADDRESS
+#else
+#define URHO3D_ALLOCATION_CALL_SITE nullptr
+#endif
+
 namespace Urho3D
 {
 
@@ -45,25 +59,34 @@ public:
     VectorBase() noexcept :
         size_(0),
         capacity_(0),
+        externalBuffer_(0),
         buffer_(nullptr)
     {
     }
 
-    /// Swap with another vector.
+    /// Swap with another vector. Swaps the buffer pointers, so the derived vector classes move the elements instead if either uses an external buffer.
     void Swap(VectorBase& rhs)
     {
         Urho3D::Swap(size_, rhs.size_);
-        Urho3D::Swap(capacity_, rhs.capacity_);
+        const unsigned capacity = capacity_;
+        const unsigned externalBuffer = externalBuffer_;
+        capacity_ = rhs.capacity_;
+        externalBuffer_ = rhs.externalBuffer_;
+        rhs.capacity_ = capacity;
+        rhs.externalBuffer_ = externalBuffer;
         Urho3D::Swap(buffer_, rhs.buffer_);
     }
 
 protected:
-    static unsigned char* AllocateBuffer(unsigned size);
+    /// Allocate a buffer. The call site is recorded when tracking allocations.
+    static unsigned char* AllocateBuffer(unsigned size, void* callSite);
 
     /// Size of vector.
     unsigned size_;
     /// Buffer capacity.
-    unsigned capacity_;
+    unsigned capacity_ : 31;
+    /// Whether the buffer is not owned by the vector, such as the inline storage of a small vector or frame allocator memory, and must not be freed.
+    unsigned externalBuffer_ : 1;
     /// Buffer.
     unsigned char* buffer_;
 };
@@ -0,0 +1,562 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/Sort.h"
+#include "../Core/AllocationTracker.h"
+#include "../Core/CoreEvents.h"
+#include "../Core/Mutex.h"
+#include "../IO/Log.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// DebugNew.h is not included, as it would redefine the operator new definitions below
+
+// The global operator new can not be replaced while the MSVC debug heap macros are in use. On Windows a replacement in a DLL would
+// only apply to allocations made inside the DLL, so it is only done when linking statically
+#if defined(URHO3D_TRACK_ALLOCATIONS) && !(defined(_MSC_VER) && defined(_DEBUG)) && (!defined(_WIN32) || defined(URHO3D_STATIC_DEFINE))
+#define URHO3D_TRACK_GLOBAL_NEW
+#endif
+
+namespace Urho3D
+{
+
+#ifdef URHO3D_TRACK_ALLOCATIONS
+
+/// Maximum number of tags, including the default tag.
+static const unsigned MAX_ALLOCATION_TAGS = 64;
+/// Maximum number of threads with their own counters at the same time. Counters of exited threads are reused, further threads share the last counters.
+static const unsigned MAX_ALLOCATION_THREADS = 64;
+/// Size of the call site table of a thread. Must be a power of two.
+static const unsigned CALL_SITE_TABLE_SIZE = 512;
+/// Maximum number of probes to find a call site in the table.
+static const unsigned MAX_CALL_SITE_PROBES = 8;
+
+/// Allocation counters of a call site.
+struct CallSiteCounters
+{
+    /// Return address of the allocating call, null if the entry is unused.
+    std::atomic<void*> address_;
+    /// Number of allocations.
+    std::atomic<unsigned long long> count_;
+    /// Allocated bytes.
+    std::atomic<unsigned long long> bytes_;
+};
+
+/// Allocation counters of a thread. Written by the owning thread and read by the main thread at the end of the frame.
+struct ThreadAllocationCounters
+{
+    /// Number of allocations per tag.
+    std::atomic<unsigned long long> count_[MAX_ALLOCATION_TAGS];
+    /// Allocated bytes per tag.
+    std::atomic<unsigned long long> bytes_[MAX_ALLOCATION_TAGS];
+    /// Freed bytes per tag of the allocation.
+    std::atomic<unsigned long long> freedBytes_[MAX_ALLOCATION_TAGS];
+    /// Number of container allocations per source.
+    std::atomic<unsigned long long> sourceCount_[MAX_ALLOC_SOURCES];
+    /// Container bytes per source.
+    std::atomic<unsigned long long> sourceBytes_[MAX_ALLOC_SOURCES];
+    /// Call site table.
+    CallSiteCounters callSites_[CALL_SITE_TABLE_SIZE];
+    /// Call sites that did not fit in the table.
+    CallSiteCounters otherCallSites_;
+};
+
+/// Counters of the threads. Allocated statically so that counting never allocates.
+static ThreadAllocationCounters threadCounters[MAX_ALLOCATION_THREADS];
+/// Number of counters acquired by threads so far.
+static std::atomic<unsigned> numThreadCounters{0};
+/// Whether the counters at an index have been released by an exited thread and can be acquired again.
+static std::atomic<bool> releasedThreadCounters[MAX_ALLOCATION_THREADS];
+/// Tag names. The default tag has no name.
+static std::atomic<const char*> tagNames[MAX_ALLOCATION_TAGS];
+/// Number of tags, including the default tag.
+static std::atomic<unsigned> numTags{1};
+
+/// Counters of the calling thread.
+static thread_local ThreadAllocationCounters* currentCounters = nullptr;
+/// Tag of the calling thread's allocations.
+static thread_local unsigned currentTag = 0;
+/// Call site of the container allocation the calling thread is about to make with operator new.
+static thread_local void* pendingCallSite = nullptr;
+
+/// Releases the counters of a thread for reuse when the thread exits.
+struct ThreadCountersOwner
+{
+    /// Destruct. Release the counters unless they are the last ones, which may be shared.
+    ~ThreadCountersOwner()
+    {
+        auto index = (unsigned)(currentCounters - threadCounters);
+        // Deallocations after this, for example by other thread-local destructors, are counted in the shared counters
+        currentCounters = &threadCounters[MAX_ALLOCATION_THREADS - 1];
+        if (index < MAX_ALLOCATION_THREADS - 1)
+            releasedThreadCounters[index].store(true, std::memory_order_release);
+    }
+};
+
+static ThreadAllocationCounters* AcquireThreadCounters()
+{
+    // Reuse the counters of an exited thread first. Their totals keep accumulating
+    unsigned numThreads = Min(numThreadCounters.load(std::memory_order_relaxed), MAX_ALLOCATION_THREADS - 1);
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        bool released = true;
+        if (releasedThreadCounters[i].compare_exchange_strong(released, false, std::memory_order_acquire))
+            return &threadCounters[i];
+    }
+
+    unsigned index = numThreadCounters.fetch_add(1, std::memory_order_relaxed);
+    return &threadCounters[Min(index, MAX_ALLOCATION_THREADS - 1)];
+}
+
+static ThreadAllocationCounters* GetThreadCounters()
+{
+    if (!currentCounters)
+    {
+        currentCounters = AcquireThreadCounters();
+        // Constructed on first use in each thread, and destructed when the thread exits
+        static thread_local ThreadCountersOwner owner;
+        (void)owner;
+    }
+
+    return currentCounters;
+}
+
+static void RecordCallSite(ThreadAllocationCounters* counters, void* address, size_t size)
+{
+    unsigned hash = (unsigned)((size_t)address >> 2u) * 2654435761u;
+
+    for (unsigned i = 0; i < MAX_CALL_SITE_PROBES; ++i)
+    {
+        CallSiteCounters& entry = counters->callSites_[(hash + i) & (CALL_SITE_TABLE_SIZE - 1)];
+        void* entryAddress = entry.address_.load(std::memory_order_relaxed);
+        // Claim an unused entry. The last counters may be shared by several threads
+        if (!entryAddress && entry.address_.compare_exchange_strong(entryAddress, address, std::memory_order_relaxed))
+            entryAddress = address;
+
+        if (entryAddress == address)
+        {
+            entry.count_.fetch_add(1, std::memory_order_relaxed);
+            entry.bytes_.fetch_add(size, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    counters->otherCallSites_.count_.fetch_add(1, std::memory_order_relaxed);
+    counters->otherCallSites_.bytes_.fetch_add(size, std::memory_order_relaxed);
+}
+
+#endif
+
+#ifdef URHO3D_TRACK_GLOBAL_NEW
+
+/// Header in front of each allocation made with the global operator new. Aligned to keep the allocation suitably aligned for any type.
+struct alignas(16) AllocationHeader
+{
+    /// Allocation size without the header.
+    size_t size_;
+    /// Tag of the allocation.
+    unsigned tag_;
+};
+
+static void* AllocateTracked(size_t size, void* callSite)
+{
+    auto* header = static_cast<AllocationHeader*>(malloc(sizeof(AllocationHeader) + size));
+    if (!header)
+        return nullptr;
+
+    unsigned tag = currentTag;
+    header->size_ = size;
+    header->tag_ = tag;
+
+    ThreadAllocationCounters* counters = GetThreadCounters();
+    counters->count_[tag].fetch_add(1, std::memory_order_relaxed);
+    counters->bytes_[tag].fetch_add(size, std::memory_order_relaxed);
+
+    // Attribute container buffers to the code that grew the container rather than the container itself
+    if (pendingCallSite)
+    {
+        callSite = pendingCallSite;
+        pendingCallSite = nullptr;
+    }
+    RecordCallSite(counters, callSite, size);
+
+    return header + 1;
+}
+
+static void* AllocateTrackedOrThrow(size_t size, void* callSite)
+{
+    for (;;)
+    {
+        void* ptr = AllocateTracked(size, callSite);
+        if (ptr)
+            return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+static void FreeTracked(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    AllocationHeader* header = static_cast<AllocationHeader*>(ptr) - 1;
+    GetThreadCounters()->freedBytes_[header->tag_].fetch_add(header->size_, std::memory_order_relaxed);
+    free(header);
+}
+
+#endif
+
+AllocationTracker::AllocationTracker(Context* context) :
+    Object(context),
+    liveBytes_(0),
+    logInterval_(0.0f)
+{
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(AllocationTracker, HandleEndFrame));
+}
+
+AllocationTracker::~AllocationTracker() = default;
+
+void AllocationTracker::EndFrame()
+{
+#ifdef URHO3D_TRACK_ALLOCATIONS
+    unsigned numThreads = Min(numThreadCounters.load(std::memory_order_relaxed), MAX_ALLOCATION_THREADS);
+    unsigned tags = Min(numTags.load(std::memory_order_acquire), MAX_ALLOCATION_TAGS);
+
+    AllocationStats tagTotals[MAX_ALLOCATION_TAGS];
+    unsigned long long tagFreedBytes[MAX_ALLOCATION_TAGS] = {};
+    AllocationStats sourceTotals[MAX_ALLOC_SOURCES];
+
+    unsigned oldNumThreads = threadTotalStats_.Size();
+    threadFrameStats_.Resize(numThreads);
+    threadTotalStats_.Resize(numThreads);
+    for (unsigned i = oldNumThreads; i < numThreads; ++i)
+        threadTotalStats_[i] = AllocationStats();
+
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        const ThreadAllocationCounters& counters = threadCounters[i];
+        AllocationStats threadTotal;
+
+        for (unsigned j = 0; j < tags; ++j)
+        {
+            unsigned long long count = counters.count_[j].load(std::memory_order_relaxed);
+            unsigned long long bytes = counters.bytes_[j].load(std::memory_order_relaxed);
+            tagTotals[j].count_ += count;
+            tagTotals[j].bytes_ += bytes;
+            tagFreedBytes[j] += counters.freedBytes_[j].load(std::memory_order_relaxed);
+            threadTotal.count_ += count;
+            threadTotal.bytes_ += bytes;
+        }
+
+        for (unsigned j = 0; j < MAX_ALLOC_SOURCES; ++j)
+        {
+            sourceTotals[j].count_ += counters.sourceCount_[j].load(std::memory_order_relaxed);
+            sourceTotals[j].bytes_ += counters.sourceBytes_[j].load(std::memory_order_relaxed);
+        }
+
+        threadFrameStats_[i].count_ = threadTotal.count_ - threadTotalStats_[i].count_;
+        threadFrameStats_[i].bytes_ = threadTotal.bytes_ - threadTotalStats_[i].bytes_;
+        threadTotalStats_[i] = threadTotal;
+    }
+
+    AllocationStats total;
+    liveBytes_ = 0;
+    tagStats_.Resize(tags);
+    for (unsigned i = 0; i < tags; ++i)
+    {
+        AllocationTagStats& tagStats = tagStats_[i];
+        tagStats.name_ = i ? tagNames[i].load(std::memory_order_relaxed) : "Untagged";
+        tagStats.frame_.count_ = tagTotals[i].count_ - tagStats.total_.count_;
+        tagStats.frame_.bytes_ = tagTotals[i].bytes_ - tagStats.total_.bytes_;
+        tagStats.total_ = tagTotals[i];
+        tagStats.liveBytes_ = (long long)(tagTotals[i].bytes_ - tagFreedBytes[i]);
+
+        total.count_ += tagTotals[i].count_;
+        total.bytes_ += tagTotals[i].bytes_;
+        liveBytes_ += tagStats.liveBytes_;
+    }
+
+    frameStats_.count_ = total.count_ - totalStats_.count_;
+    frameStats_.bytes_ = total.bytes_ - totalStats_.bytes_;
+    totalStats_ = total;
+
+    for (unsigned i = 0; i < MAX_ALLOC_SOURCES; ++i)
+    {
+        frameSourceStats_[i].count_ = sourceTotals[i].count_ - totalSourceStats_[i].count_;
+        frameSourceStats_[i].bytes_ = sourceTotals[i].bytes_ - totalSourceStats_[i].bytes_;
+        totalSourceStats_[i] = sourceTotals[i];
+    }
+#endif
+}
+
+void AllocationTracker::SetLogInterval(float interval)
+{
+    logInterval_ = Max(interval, 0.0f);
+    logTimer_.Reset();
+}
+
+void AllocationTracker::LogReport() const
+{
+    URHO3D_LOGINFO("Allocations:\n" + PrintReport());
+}
+
+String AllocationTracker::PrintReport(unsigned maxCallSites) const
+{
+    static const int LINE_MAX_LENGTH = 256;
+    static const char* sourceNames[] = {"String", "Vector", "AllocatorBlock"};
+
+    char line[LINE_MAX_LENGTH];
+    String output;
+
+    if (!IsEnabled())
+        return "Allocation tracking is not enabled\n";
+
+    sprintf(line, "Frame %llu allocations %llu KB, live %lld KB\n", frameStats_.count_, (frameStats_.bytes_ + 1023) / 1024,
+        liveBytes_ / 1024);
+    output.Append(line);
+    for (unsigned i = 0; i < MAX_ALLOC_SOURCES; ++i)
+    {
+        sprintf(line, "%s %llu allocations %llu KB\n", sourceNames[i], frameSourceStats_[i].count_,
+            (frameSourceStats_[i].bytes_ + 1023) / 1024);
+        output.Append(line);
+    }
+
+    output += "\nTag                         Cnt   Frame KB     Total KB      Live KB\n\n";
+    for (unsigned i = 0; i < tagStats_.Size(); ++i)
+    {
+        const AllocationTagStats& tagStats = tagStats_[i];
+        sprintf(line, "%-24.24s %6llu %10llu %12llu %12lld\n", tagStats.name_ ? tagStats.name_ : "", Min(tagStats.frame_.count_,
+            999999ULL), (tagStats.frame_.bytes_ + 1023) / 1024, (tagStats.total_.bytes_ + 1023) / 1024, tagStats.liveBytes_ / 1024);
+        output.Append(line);
+    }
+
+    output += "\nThread                      Cnt   Frame KB\n\n";
+    for (unsigned i = 0; i < threadFrameStats_.Size(); ++i)
+    {
+        sprintf(line, "%-24u %6llu %10llu\n", i, Min(threadFrameStats_[i].count_, 999999ULL),
+            (threadFrameStats_[i].bytes_ + 1023) / 1024);
+        output.Append(line);
+    }
+
+    PODVector<AllocationCallSite> callSites;
+    GetTopCallSites(callSites, maxCallSites);
+    if (!callSites.Empty())
+    {
+        output += "\nCall site                   Cnt     Total KB\n\n";
+        for (unsigned i = 0; i < callSites.Size(); ++i)
+        {
+            const AllocationCallSite& callSite = callSites[i];
+            if (callSite.address_)
+                sprintf(line, "%-24p %6llu %12llu\n", callSite.address_, Min(callSite.total_.count_, 999999ULL),
+                    (callSite.total_.bytes_ + 1023) / 1024);
+            else
+                sprintf(line, "%-24s %6llu %12llu\n", "Other", Min(callSite.total_.count_, 999999ULL),
+                    (callSite.total_.bytes_ + 1023) / 1024);
+            output.Append(line);
+        }
+    }
+
+    return output;
+}
+
+void AllocationTracker::GetTopCallSites(PODVector<AllocationCallSite>& dest, unsigned maxCount) const
+{
+    dest.Clear();
+
+#ifdef URHO3D_TRACK_ALLOCATIONS
+    HashMap<void*, AllocationStats> callSites;
+    AllocationStats other;
+    unsigned numThreads = Min(numThreadCounters.load(std::memory_order_relaxed), MAX_ALLOCATION_THREADS);
+
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        const ThreadAllocationCounters& counters = threadCounters[i];
+        for (unsigned j = 0; j < CALL_SITE_TABLE_SIZE; ++j)
+        {
+            const CallSiteCounters& entry = counters.callSites_[j];
+            void* address = entry.address_.load(std::memory_order_relaxed);
+            if (!address)
+                continue;
+
+            AllocationStats& stats = callSites[address];
+            stats.count_ += entry.count_.load(std::memory_order_relaxed);
+            stats.bytes_ += entry.bytes_.load(std::memory_order_relaxed);
+        }
+
+        other.count_ += counters.otherCallSites_.count_.load(std::memory_order_relaxed);
+        other.bytes_ += counters.otherCallSites_.bytes_.load(std::memory_order_relaxed);
+    }
+
+    for (HashMap<void*, AllocationStats>::ConstIterator i = callSites.Begin(); i != callSites.End(); ++i)
+    {
+        AllocationCallSite callSite;
+        callSite.address_ = i->first_;
+        callSite.total_ = i->second_;
+        dest.Push(callSite);
+    }
+    if (other.count_)
+    {
+        AllocationCallSite callSite;
+        callSite.address_ = nullptr;
+        callSite.total_ = other;
+        dest.Push(callSite);
+    }
+
+    Sort(dest.Begin(), dest.End(), [](const AllocationCallSite& lhs, const AllocationCallSite& rhs)
+    {
+        return lhs.total_.bytes_ > rhs.total_.bytes_;
+    });
+    if (dest.Size() > maxCount)
+        dest.Resize(maxCount);
+#endif
+}
+
+bool AllocationTracker::IsEnabled()
+{
+#ifdef URHO3D_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+unsigned AllocationTracker::RegisterTag(const char* name)
+{
+#ifdef URHO3D_TRACK_ALLOCATIONS
+    static Mutex tagMutex;
+    MutexLock lock(tagMutex);
+
+    unsigned tags = numTags.load(std::memory_order_relaxed);
+    for (unsigned i = 1; i < tags; ++i)
+    {
+        if (!strcmp(tagNames[i].load(std::memory_order_relaxed), name))
+            return i;
+    }
+
+    // When out of tags, count as untagged
+    if (tags >= MAX_ALLOCATION_TAGS)
+        return 0;
+
+    tagNames[tags].store(name, std::memory_order_relaxed);
+    numTags.store(tags + 1, std::memory_order_release);
+    return tags;
+#else
+    return 0;
+#endif
+}
+
+unsigned AllocationTracker::SetThreadTag(unsigned tag)
+{
+#ifdef URHO3D_TRACK_ALLOCATIONS
+    unsigned previousTag = currentTag;
+    currentTag = tag < MAX_ALLOCATION_TAGS ? tag : 0;
+    return previousTag;
+#else
+    return 0;
+#endif
+}
+
+void AllocationTracker::RecordSourceAllocation(AllocationSource source, unsigned size, void* callSite)
+{
+#ifdef URHO3D_TRACK_ALLOCATIONS
+    ThreadAllocationCounters* counters = GetThreadCounters();
+    counters->sourceCount_[source].fetch_add(1, std::memory_order_relaxed);
+    counters->sourceBytes_[source].fetch_add(size, std::memory_order_relaxed);
+
+#ifdef URHO3D_TRACK_GLOBAL_NEW
+    // String and vector buffers are allocated next with operator new, which records the call site
+    if (source != ALLOC_SOURCE_BLOCK)
+    {
+        pendingCallSite = callSite;
+        return;
+    }
+#endif
+
+    RecordCallSite(counters, callSite, size);
+#endif
+}
+
+void AllocationTracker::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    EndFrame();
+
+    if (logInterval_ > 0.0f && logTimer_.GetMSec(false) >= (unsigned)(logInterval_ * 1000.0f))
+    {
+        logTimer_.Reset();
+        LogReport();
+    }
+}
+
+}
+
+#ifdef URHO3D_TRACK_GLOBAL_NEW
+
+void* operator new(std::size_t size)
+{
+    return Urho3D::AllocateTrackedOrThrow(size, URHO3D_RETURN_ADDRESS);
+}
+
+void* operator new[](std::size_t size)
+{
+    return Urho3D::AllocateTrackedOrThrow(size, URHO3D_RETURN_ADDRESS);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Urho3D::AllocateTracked(size, URHO3D_RETURN_ADDRESS);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Urho3D::AllocateTracked(size, URHO3D_RETURN_ADDRESS);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    Urho3D::FreeTracked(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    Urho3D::FreeTracked(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    Urho3D::FreeTracked(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    Urho3D::FreeTracked(ptr);
+}
+
+#endif
@@ -0,0 +1,179 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Core/Object.h"
+#include "../Core/Timer.h"
+
+namespace Urho3D
+{
+
+/// Default interval in seconds for writing the allocation report to the log in headless mode.
+static const float DEFAULT_ALLOCATION_LOG_INTERVAL = 10.0f;
+
+/// Container allocations counted separately by the allocation tracker.
+enum AllocationSource
+{
+    ALLOC_SOURCE_STRING = 0,
+    ALLOC_SOURCE_VECTOR,
+    ALLOC_SOURCE_BLOCK,
+    MAX_ALLOC_SOURCES
+};
+
+/// Allocation count and size.
+struct AllocationStats
+{
+    /// Number of allocations.
+    unsigned long long count_{};
+    /// Allocated bytes.
+    unsigned long long bytes_{};
+};
+
+/// Allocation statistics of a tag.
+struct AllocationTagStats
+{
+    /// Tag name.
+    const char* name_{};
+    /// Allocations during the last frame.
+    AllocationStats frame_;
+    /// Allocations since the start of the program.
+    AllocationStats total_;
+    /// Allocated bytes not yet freed.
+    long long liveBytes_{};
+};
+
+/// Allocation statistics of a call site.
+struct AllocationCallSite
+{
+    /// Return address of the allocating call.
+    void* address_;
+    /// Allocations since the start of the program.
+    AllocationStats total_;
+};
+
+/// Allocation tracker subsystem. Counts global operator new allocations per thread and per tagged scope, String, vector and AllocatorBlock allocations per source, and allocated bytes per call site. Only counts when the engine is built with URHO3D_TRACK_ALLOCATIONS.
+class URHO3D_API AllocationTracker : public Object
+{
+    URHO3D_OBJECT(AllocationTracker, Object);
+
+public:
+    /// Construct.
+    explicit AllocationTracker(Context* context);
+    /// Destruct.
+    ~AllocationTracker() override;
+
+    /// Update the statistics of the frame that ended. Called automatically at the end of the frame.
+    void EndFrame();
+    /// Set interval in seconds for writing the report to the log, or 0 to disable. The engine sets DEFAULT_ALLOCATION_LOG_INTERVAL in headless mode, where the debug HUD is not available.
+    void SetLogInterval(float interval);
+    /// Write the report to the log.
+    void LogReport() const;
+    /// Return the report of the last frame, the tags, the threads and the top call sites.
+    String PrintReport(unsigned maxCallSites = DEFAULT_REPORT_CALL_SITES) const;
+
+    /// Return allocations during the last frame.
+    const AllocationStats& GetFrameStats() const { return frameStats_; }
+    /// Return container allocations of a source during the last frame.
+    const AllocationStats& GetFrameSourceStats(AllocationSource source) const { return frameSourceStats_[source]; }
+    /// Return allocated bytes not yet freed.
+    long long GetLiveBytes() const { return liveBytes_; }
+    /// Return statistics of the tags.
+    const Vector<AllocationTagStats>& GetTagStats() const { return tagStats_; }
+    /// Return allocations of the threads during the last frame.
+    const PODVector<AllocationStats>& GetThreadFrameStats() const { return threadFrameStats_; }
+    /// Return the call sites that allocated the most bytes.
+    void GetTopCallSites(PODVector<AllocationCallSite>& dest, unsigned maxCount) const;
+    /// Return log interval in seconds.
+    float GetLogInterval() const { return logInterval_; }
+
+    /// Return whether allocation tracking is compiled in.
+    static bool IsEnabled();
+    /// Register a tag by name and return its index. Registering the same name again returns the same index.
+    static unsigned RegisterTag(const char* name);
+    /// Set the tag of the calling thread's allocations. Return the previous tag.
+    static unsigned SetThreadTag(unsigned tag);
+    /// Record a container allocation made from the given call site. Called by String, VectorBase and AllocatorBlock.
+    static void RecordSourceAllocation(AllocationSource source, unsigned size, void* callSite);
+
+    /// Default number of call sites in the report.
+    static const unsigned DEFAULT_REPORT_CALL_SITES = 10;
+
+private:
+    /// Handle the frame end event.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+
+    /// Allocations during the last frame.
+    AllocationStats frameStats_;
+    /// Container allocations by source during the last frame.
+    AllocationStats frameSourceStats_[MAX_ALLOC_SOURCES];
+    /// Allocations until the end of the last frame.
+    AllocationStats totalStats_;
+    /// Container allocations by source until the end of the last frame.
+    AllocationStats totalSourceStats_[MAX_ALLOC_SOURCES];
+    /// Allocated bytes not yet freed at the end of the last frame.
+    long long liveBytes_;
+    /// Tag statistics.
+    Vector<AllocationTagStats> tagStats_;
+    /// Allocations of the threads during the last frame.
+    PODVector<AllocationStats> threadFrameStats_;
+    /// Allocations of the threads until the end of the last frame.
+    PODVector<AllocationStats> threadTotalStats_;
+    /// Log interval in seconds.
+    float logInterval_;
+    /// Log interval timer.
+    Timer logTimer_;
+};
+
+/// Tags the calling thread's allocations during its lifetime.
+class URHO3D_API AllocationScope
+{
+public:
+    /// Construct and set the thread's tag.
+    explicit AllocationScope(unsigned tag) :
+        previousTag_(AllocationTracker::SetThreadTag(tag))
+    {
+    }
+
+    /// Destruct and restore the previous tag.
+    ~AllocationScope()
+    {
+        AllocationTracker::SetThreadTag(previousTag_);
+    }
+
+    /// Prevent copy construction.
+    AllocationScope(const AllocationScope& rhs) = delete;
+    /// Prevent assignment.
+    AllocationScope& operator =(const AllocationScope& rhs) = delete;
+
+private:
+    /// Tag to restore.
+    unsigned previousTag_;
+};
+
+#ifdef URHO3D_TRACK_ALLOCATIONS
+#define URHO3D_ALLOCATION_SCOPE(name) static const unsigned allocationTag_ ## name = Urho3D::AllocationTracker::RegisterTag(#name); Urho3D::AllocationScope allocationScope_ ## name (allocationTag_ ## name)
+#else
+#define URHO3D_ALLOCATION_SCOPE(name)
+#endif
+
+}
@@ -66,6 +66,8 @@ public:
     virtual void Get(const Serializable* ptr, Variant& dest) const = 0;
     /// Set the attribute.
     virtual void Set(Serializable* ptr, const Variant& src) = 0;
+    /// Set the attribute from binary data of a fixed-size attribute type, as written by Serializer::WriteVariantData(), without constructing a Variant. Return false if not supported, in which case Set() must be used.
+    virtual bool SetData(Serializable* ptr, const void* src) { return false; }
 };
 
 /// Description of an automatically serializable variable.
@@ -24,6 +24,8 @@
 
 #include "../Core/Context.h"
 #include "../Core/EventProfiler.h"
+#include "../Core/Profiler.h"
+#include "../Core/Thread.h"
 #include "../IO/Log.h"
 
 #ifndef MINI_URHO
@@ -64,38 +66,56 @@ void EventReceiverGroup::EndSendEvent()
     assert(inSend_ > 0);
     --inSend_;
 
-    if (inSend_ == 0 && dirty_)
-    {
-        /// \todo Could be optimized by erase-swap, but this keeps the receiver order
-        for (unsigned i = receivers_.Size() - 1; i < receivers_.Size(); --i)
-        {
-            if (!receivers_[i])
-                receivers_.Erase(i);
-        }
-
-        dirty_ = false;
-    }
+    if (inSend_ == 0 && numHoles_ * 2 > receivers_.Size())
+        Compact();
 }
 
 void EventReceiverGroup::Add(Object* object)
 {
     if (object)
+    {
+        indices_[object] = receivers_.Size();
         receivers_.Push(object);
+    }
 }
 
 void EventReceiverGroup::Remove(Object* object)
 {
-    if (inSend_ > 0)
+    HashMap<Object*, unsigned>::Iterator i = indices_.Find(object);
+    if (i == indices_.End())
+        return;
+
+    receivers_[i->second_] = nullptr;
+    indices_.Erase(i);
+    ++numHoles_;
+
+    // Removing from the middle of the vector would be linear, so leave a hole and clean up in bulk later
+    if (inSend_ == 0 && numHoles_ * 2 > receivers_.Size())
+        Compact();
+}
+
+void EventReceiverGroup::Compact()
+{
+    if (inSend_ > 0 || !numHoles_)
+        return;
+
+    unsigned dest = 0;
+    for (unsigned i = 0; i < receivers_.Size(); ++i)
     {
-        PODVector<Object*>::Iterator i = receivers_.Find(object);
-        if (i != receivers_.End())
+        Object* receiver = receivers_[i];
+        if (!receiver)
+            continue;
+
+        if (dest != i)
         {
-            (*i) = nullptr;
-            dirty_ = true;
+            receivers_[dest] = receiver;
+            indices_[receiver] = dest;
         }
+        ++dest;
     }
-    else
-        receivers_.Remove(object);
+
+    receivers_.Resize(dest);
+    numHoles_ = 0;
 }
 
 void RemoveNamedAttribute(HashMap<StringHash, Vector<AttributeInfo> >& attributes, StringHash objectType, const char* name)
@@ -120,8 +140,22 @@ void RemoveNamedAttribute(HashMap<StringHash, Vector<AttributeInfo> >& attribute
         attributes.Erase(i);
 }
 
+/// Event posted for deferred sending in the main thread.
+struct PostedEvent
+{
+    /// Sender. Null if destroyed before sending.
+    Object* sender_;
+    /// Event type.
+    StringHash eventType_;
+    /// Event parameters.
+    VariantMap eventData_;
+    /// Next event in the posted event stack.
+    PostedEvent* next_;
+};
+
 Context::Context() :
-    eventHandler_(nullptr)
+    eventHandler_(nullptr),
+    postedEvents_(nullptr)
 {
 #ifdef __ANDROID__
     // Always reset the random seed on Android, as the Urho3D library might not be unloaded between runs
@@ -149,6 +183,12 @@ Context::~Context()
     for (PODVector<VariantMap*>::Iterator i = eventDataMaps_.Begin(); i != eventDataMaps_.End(); ++i)
         delete *i;
     eventDataMaps_.Clear();
+
+    // Delete events that were posted but never sent
+    TakePostedEvents();
+    for (PODVector<PostedEvent*>::Iterator i = pendingPostedEvents_.Begin(); i != pendingPostedEvents_.End(); ++i)
+        delete *i;
+    pendingPostedEvents_.Clear();
 }
 
 SharedPtr<Object> Context::CreateObject(StringHash objectType)
@@ -249,6 +289,35 @@ VariantMap& Context::GetEventDataMap()
     return ret;
 }
 
+void Context::SendPostedEvents()
+{
+    if (!Thread::IsMainThread())
+    {
+        URHO3D_LOGERROR("Posted events can only be sent from the main thread");
+        return;
+    }
+
+    TakePostedEvents();
+    if (pendingPostedEvents_.Empty())
+        return;
+
+    URHO3D_PROFILE(SendPostedEvents);
+
+    // Events posted while sending are left for the next call
+    const unsigned numEvents = pendingPostedEvents_.Size();
+    for (unsigned i = 0; i < numEvents; ++i)
+    {
+        PostedEvent* event = pendingPostedEvents_[i];
+        // Clear the slot first, as more events may be taken during sending when an object is destroyed
+        pendingPostedEvents_[i] = nullptr;
+        if (event->sender_)
+            event->sender_->SendEvent(event->eventType_, event->eventData_);
+        delete event;
+    }
+
+    pendingPostedEvents_.Erase(0, numEvents);
+}
+
 #ifndef MINI_URHO
 bool Context::RequireSDL(unsigned int sdlFlags)
 {
@@ -421,6 +490,17 @@ void Context::AddEventReceiver(Object* receiver, Object* sender, StringHash even
 
 void Context::RemoveEventSender(Object* sender)
 {
+    // Events posted by the sender can no longer be sent
+    if ((!pendingPostedEvents_.Empty() || postedEvents_.load(std::memory_order_relaxed)) && Thread::IsMainThread())
+    {
+        TakePostedEvents();
+        for (PODVector<PostedEvent*>::Iterator i = pendingPostedEvents_.Begin(); i != pendingPostedEvents_.End(); ++i)
+        {
+            if (*i && (*i)->sender_ == sender)
+                (*i)->sender_ = nullptr;
+        }
+    }
+
     HashMap<Object*, HashMap<StringHash, SharedPtr<EventReceiverGroup> > >::Iterator i = specificEventReceivers_.Find(sender);
     if (i != specificEventReceivers_.End())
     {
@@ -451,6 +531,37 @@ void Context::RemoveEventReceiver(Object* receiver, Object* sender, StringHash e
         group->Remove(receiver);
 }
 
+void Context::PostEvent(Object* sender, StringHash eventType, VariantMap&& eventData)
+{
+    auto* event = new PostedEvent();
+    event->sender_ = sender;
+    event->eventType_ = eventType;
+    event->eventData_ = std::move(eventData);
+
+    event->next_ = postedEvents_.load(std::memory_order_relaxed);
+    while (!postedEvents_.compare_exchange_weak(event->next_, event, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+void Context::TakePostedEvents()
+{
+    // Only the main thread takes events, and it takes the whole stack at once, so there is no ABA problem
+    PostedEvent* event = postedEvents_.exchange(nullptr, std::memory_order_acquire);
+    if (!event)
+        return;
+
+    // The stack holds the most recent event first, so reverse to restore posting order
+    const unsigned start = pendingPostedEvents_.Size();
+    while (event)
+    {
+        pendingPostedEvents_.Push(event);
+        event = event->next_;
+    }
+    for (unsigned i = start, j = pendingPostedEvents_.Size() - 1; i < j; ++i, --j)
+        Swap(pendingPostedEvents_[i], pendingPostedEvents_[j]);
+}
+
 void Context::BeginSendEvent(Object* sender, StringHash eventType)
 {
 #ifdef URHO3D_PROFILING
@@ -26,9 +26,13 @@
 #include "../Core/Attribute.h"
 #include "../Core/Object.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
+struct PostedEvent;
+
 /// Tracking structure for event receivers.
 class URHO3D_API EventReceiverGroup : public RefCounted
 {
@@ -36,7 +40,7 @@ public:
     /// Construct.
     EventReceiverGroup() :
         inSend_(0),
-        dirty_(false)
+        numHoles_(0)
     {
     }
 
@@ -49,17 +53,23 @@ public:
     /// Add receiver. Same receiver must not be double-added!
     void Add(Object* object);
 
-    /// Remove receiver. Leave holes during send, which requires later cleanup.
+    /// Remove receiver. Leaves a hole, which is cleaned up once holes make up half of the receivers and no send is in progress.
     void Remove(Object* object);
 
-    /// Receivers. May contain holes during sending.
+    /// Remove holes while keeping the receiver order. Does nothing while a send is in progress. Call before inspecting the receivers outside of sending.
+    void Compact();
+
+    /// Receivers. May contain holes.
     PODVector<Object*> receivers_;
 
 private:
+
+    /// Receiver indices for constant time removal.
+    HashMap<Object*, unsigned> indices_;
     /// "In send" recursion counter.
     unsigned inSend_;
-    /// Cleanup required flag.
-    bool dirty_;
+    /// Number of holes in the receivers.
+    unsigned numHoles_;
 };
 
 /// Urho3D execution context. Provides access to subsystems, object factories and attributes, and event receivers.
@@ -98,6 +108,8 @@ public:
     void UpdateAttributeDefaultValue(StringHash objectType, const char* name, const Variant& defaultValue);
     /// Return a preallocated map for event data. Used for optimization to avoid constant re-allocation of event data maps.
     VariantMap& GetEventDataMap();
+    /// Send events posted from any thread since the last call. Must be called from the main thread. Called by Engine once per frame.
+    void SendPostedEvents();
     /// Initialises the specified SDL systems, if not already. Returns true if successful. This call must be matched with ReleaseSDL() when SDL functions are no longer required, even if this call fails.
     bool RequireSDL(unsigned int sdlFlags);
     /// Indicate that you are done with using SDL. Must be called after using RequireSDL().
@@ -221,6 +233,10 @@ private:
 
     /// Set current event handler. Called by Object.
     void SetEventHandler(EventHandler* handler) { eventHandler_ = handler; }
+    /// Queue an event for deferred sending. Can be called from any thread.
+    void PostEvent(Object* sender, StringHash eventType, VariantMap&& eventData);
+    /// Move events from the lock-free posted event stack to the pending events in posting order. Called from the main thread.
+    void TakePostedEvents();
 
     /// Object factories.
     HashMap<StringHash, SharedPtr<ObjectFactory> > factories_;
@@ -240,6 +256,10 @@ private:
     PODVector<VariantMap*> eventDataMaps_;
     /// Active event handler. Not stored in a stack for performance reasons; is needed only in esoteric cases.
     EventHandler* eventHandler_;
+    /// Events posted from any thread, most recent first. Pushed without locking.
+    std::atomic<PostedEvent*> postedEvents_;
+    /// Posted events waiting to be sent, in posting order. Accessed only from the main thread.
+    PODVector<PostedEvent*> pendingPostedEvents_;
     /// Object categories.
     HashMap<String, Vector<StringHash> > objectCategories_;
     /// Variant map for global variables that can persist throughout application execution.
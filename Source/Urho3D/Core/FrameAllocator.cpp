@@ -0,0 +1,198 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/CoreEvents.h"
+#include "../Core/FrameAllocator.h"
+
+#include <atomic>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Next frame allocator ID.
+static std::atomic<unsigned> nextAllocatorID{1};
+/// ID of the frame allocator the calling thread used last.
+static thread_local unsigned threadAllocatorID = 0;
+/// Arena of the calling thread in the frame allocator it used last.
+static thread_local FrameAllocatorArena* threadArena = nullptr;
+
+FrameAllocatorArena::~FrameAllocatorArena()
+{
+    for (unsigned i = 0; i < blocks_.Size(); ++i)
+        delete[] blocks_[i];
+}
+
+FrameAllocator::FrameAllocator(Context* context) :
+    Object(context),
+    id_(nextAllocatorID++),
+    blockSize_(DEFAULT_BLOCK_SIZE),
+    lastFrameSize_(0),
+    peakFrameSize_(0)
+{
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(FrameAllocator, HandleEndFrame));
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    for (unsigned i = 0; i < arenas_.Size(); ++i)
+        delete arenas_[i];
+}
+
+void* FrameAllocator::Allocate(unsigned size, unsigned alignment)
+{
+    assert(alignment && !(alignment & (alignment - 1)));
+
+    FrameAllocatorArena* arena = GetThreadArena();
+
+    // Align the address rather than the offset, so that alignments larger than the block's own are also honored
+    if (!arena->blocks_.Empty())
+    {
+        auto base = (size_t)arena->blocks_.Back();
+        auto start = (unsigned)(((base + arena->offset_ + alignment - 1) & ~(size_t)(alignment - 1)) - base);
+        if (start + size <= arena->blockSize_)
+        {
+            arena->used_ += start + size - arena->offset_;
+            arena->offset_ = start + size;
+            return arena->blocks_.Back() + start;
+        }
+    }
+
+    // Last block is full, allocate a new block at least double the size
+    unsigned newBlockSize = Max(arena->blockSize_ * 2, blockSize_);
+    while (newBlockSize < size + alignment)
+        newBlockSize *= 2;
+
+    auto* block = new unsigned char[newBlockSize];
+    arena->blocks_.Push(block);
+    arena->blockSize_ = newBlockSize;
+    arena->capacity_ += newBlockSize;
+
+    auto base = (size_t)block;
+    auto start = (unsigned)(((base + alignment - 1) & ~(size_t)(alignment - 1)) - base);
+    arena->used_ += start + size;
+    arena->offset_ = start + size;
+    return block + start;
+}
+
+void FrameAllocator::Reset()
+{
+    MutexLock lock(arenasMutex_);
+
+    unsigned frameSize = 0;
+    for (unsigned i = 0; i < arenas_.Size(); ++i)
+    {
+        FrameAllocatorArena* arena = arenas_[i];
+        frameSize += arena->used_;
+
+        // If the frame needed several blocks, replace them with one block large enough for all, so that the next frame does not need to grow
+        if (arena->blocks_.Size() > 1)
+        {
+            for (unsigned j = 0; j < arena->blocks_.Size(); ++j)
+                delete[] arena->blocks_[j];
+            arena->blocks_.Clear();
+            arena->blocks_.Push(new unsigned char[arena->capacity_]);
+            arena->blockSize_ = arena->capacity_;
+        }
+
+        arena->offset_ = 0;
+        arena->used_ = 0;
+    }
+
+    lastFrameSize_ = frameSize;
+    peakFrameSize_ = Max(peakFrameSize_, frameSize);
+}
+
+void FrameAllocator::SetBlockSize(unsigned size)
+{
+    blockSize_ = Max(size, 1U);
+}
+
+unsigned FrameAllocator::GetUsedSize() const
+{
+    MutexLock lock(arenasMutex_);
+
+    unsigned size = 0;
+    for (unsigned i = 0; i < arenas_.Size(); ++i)
+        size += arenas_[i]->used_;
+    return size;
+}
+
+unsigned FrameAllocator::GetNumArenas() const
+{
+    MutexLock lock(arenasMutex_);
+
+    return arenas_.Size();
+}
+
+unsigned FrameAllocator::GetReservedSize() const
+{
+    MutexLock lock(arenasMutex_);
+
+    unsigned size = 0;
+    for (unsigned i = 0; i < arenas_.Size(); ++i)
+        size += arenas_[i]->capacity_;
+    return size;
+}
+
+FrameAllocatorArena* FrameAllocator::GetThreadArena()
+{
+    if (threadAllocatorID != id_)
+    {
+        MutexLock lock(arenasMutex_);
+
+        // The thread may have used this allocator before switching to another one
+        ThreadID threadID = Thread::GetCurrentThreadID();
+        FrameAllocatorArena* arena = nullptr;
+        for (unsigned i = 0; i < arenas_.Size(); ++i)
+        {
+            if (arenas_[i]->threadID_ == threadID)
+            {
+                arena = arenas_[i];
+                break;
+            }
+        }
+
+        if (!arena)
+        {
+            arena = new FrameAllocatorArena();
+            arena->threadID_ = threadID;
+            arenas_.Push(arena);
+        }
+
+        threadAllocatorID = id_;
+        threadArena = arena;
+    }
+
+    return threadArena;
+}
+
+void FrameAllocator::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    Reset();
+}
+
+}
@@ -0,0 +1,204 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Core/Mutex.h"
+#include "../Core/Object.h"
+#include "../Core/Thread.h"
+
+namespace Urho3D
+{
+
+/// Linear allocation arena of one thread.
+struct FrameAllocatorArena
+{
+    /// Construct.
+    FrameAllocatorArena() = default;
+    /// Destruct. Free the memory blocks.
+    ~FrameAllocatorArena();
+
+    /// Owning thread.
+    ThreadID threadID_{};
+    /// Memory blocks. Allocation happens from the last block.
+    PODVector<unsigned char*> blocks_;
+    /// Size of the last block.
+    unsigned blockSize_{};
+    /// Offset of the next free byte in the last block.
+    unsigned offset_{};
+    /// Total size of the memory blocks.
+    unsigned capacity_{};
+    /// Bytes allocated during the frame, including alignment padding.
+    unsigned used_{};
+};
+
+/// Frame allocator subsystem. Allocates temporary memory that is released all at once at the end of the frame, using a linear arena for each thread.
+class URHO3D_API FrameAllocator : public Object
+{
+    URHO3D_OBJECT(FrameAllocator, Object);
+
+public:
+    /// Construct.
+    explicit FrameAllocator(Context* context);
+    /// Destruct.
+    ~FrameAllocator() override;
+
+    /// Allocate uninitialized memory from the calling thread's arena. The memory is valid until the end of the frame. Can be called from worker threads; arenas are kept until the allocator is destroyed, so avoid short-lived threads.
+    void* Allocate(unsigned size, unsigned alignment = DEFAULT_ALIGNMENT);
+    /// Allocate an uninitialized array of POD type from the calling thread's arena.
+    template <class T> T* AllocateArray(unsigned count)
+    {
+        return static_cast<T*>(Allocate(count * (unsigned)sizeof(T), (unsigned)alignof(T)));
+    }
+
+    /// Release the memory allocated during the frame and update the usage statistics. Called automatically at the end of the frame, when no worker threads may be using the memory.
+    void Reset();
+    /// Set the initial block size of new thread arenas.
+    void SetBlockSize(unsigned size);
+
+    /// Return the initial block size of new thread arenas.
+    unsigned GetBlockSize() const { return blockSize_; }
+    /// Return bytes allocated so far during the frame by all threads.
+    unsigned GetUsedSize() const;
+    /// Return bytes allocated during the previous frame by all threads.
+    unsigned GetLastFrameSize() const { return lastFrameSize_; }
+    /// Return the highest number of bytes allocated during a single frame.
+    unsigned GetPeakFrameSize() const { return peakFrameSize_; }
+    /// Return total size of the memory blocks reserved by all threads.
+    unsigned GetReservedSize() const;
+    /// Return number of thread arenas.
+    unsigned GetNumArenas() const;
+
+    /// Default initial block size.
+    static const unsigned DEFAULT_BLOCK_SIZE = 64 * 1024;
+    /// Default alignment of allocations.
+    static const unsigned DEFAULT_ALIGNMENT = 16;
+
+private:
+    /// Return the arena of the calling thread, creating it if necessary.
+    FrameAllocatorArena* GetThreadArena();
+    /// Handle the frame end event.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+
+    /// Thread arenas.
+    PODVector<FrameAllocatorArena*> arenas_;
+    /// Mutex for registering thread arenas.
+    mutable Mutex arenasMutex_;
+    /// Unique ID for the threads to recognize the allocator they last used. Never reused, unlike the address.
+    unsigned id_;
+    /// Initial block size of new thread arenas.
+    unsigned blockSize_;
+    /// Bytes allocated during the previous frame.
+    unsigned lastFrameSize_;
+    /// Highest number of bytes allocated during a frame.
+    unsigned peakFrameSize_;
+};
+
+/// %Vector template class for POD types that grows into memory from a FrameAllocator. The elements are only valid until the end of the frame. Growing through the PODVector base class, or without an allocator, falls back to heap memory.
+template <class T> class FramePODVector : public PODVector<T>
+{
+public:
+    /// Construct empty without an allocator.
+    FramePODVector() noexcept :
+        allocator_(nullptr)
+    {
+    }
+
+    /// Construct empty with an allocator.
+    explicit FramePODVector(FrameAllocator* allocator) noexcept :
+        allocator_(allocator)
+    {
+    }
+
+    /// Construct from another vector, using the same allocator.
+    FramePODVector(const FramePODVector<T>& vector) :
+        allocator_(vector.allocator_)
+    {
+        *this = vector;
+    }
+
+    /// Assign from another vector.
+    FramePODVector<T>& operator =(const FramePODVector<T>& rhs)
+    {
+        if (&rhs != this)
+        {
+            Resize(rhs.Size());
+            if (rhs.Size())
+                memcpy(this->Buffer(), rhs.Buffer(), rhs.Size() * sizeof(T));
+        }
+        return *this;
+    }
+
+    /// Add an element at the end.
+    void Push(const T& value)
+    {
+        if (this->size_ >= this->capacity_)
+            Grow(this->size_ + 1);
+        ++this->size_;
+        this->Back() = value;
+    }
+
+    /// Resize the vector.
+    void Resize(unsigned newSize)
+    {
+        if (newSize > this->capacity_)
+            Grow(newSize);
+        this->size_ = newSize;
+    }
+
+    /// Set the allocator. Existing elements are not moved.
+    void SetAllocator(FrameAllocator* allocator) { allocator_ = allocator; }
+
+    /// Return the allocator.
+    FrameAllocator* GetAllocator() const { return allocator_; }
+
+private:
+    /// Grow the buffer to hold at least the given number of elements.
+    void Grow(unsigned minCapacity)
+    {
+        unsigned newCapacity = this->capacity_ ? this->capacity_ : 1;
+        while (newCapacity < minCapacity)
+            newCapacity += (newCapacity + 1) >> 1u;
+
+        if (!allocator_)
+        {
+            PODVector<T>::Reserve(newCapacity);
+            return;
+        }
+
+        T* newBuffer = allocator_->AllocateArray<T>(newCapacity);
+        if (this->size_)
+            memcpy(newBuffer, this->Buffer(), this->size_ * sizeof(T));
+        // The old buffer is either owned by the vector, or arena memory that is released at the end of the frame
+        if (!this->externalBuffer_)
+            delete[] this->buffer_;
+
+        this->buffer_ = reinterpret_cast<unsigned char*>(newBuffer);
+        this->capacity_ = newCapacity;
+        this->externalBuffer_ = 1;
+    }
+
+    /// Allocator to grow into.
+    FrameAllocator* allocator_;
+};
+
+}
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/FlatHashSet.h"
 #include "../Core/Context.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/Thread.h"
@@ -93,38 +94,16 @@ void Object::OnEvent(Object* sender, StringHash eventType, VariantMap& eventData
 
     // Make a copy of the context pointer in case the object is destroyed during event handler invocation
     Context* context = context_;
-    EventHandler* specific = nullptr;
-    EventHandler* nonSpecific = nullptr;
 
-    EventHandler* handler = eventHandlers_.First();
-    while (handler)
-    {
-        if (handler->GetEventType() == eventType)
-        {
-            if (!handler->GetSender())
-                nonSpecific = handler;
-            else if (handler->GetSender() == sender)
-            {
-                specific = handler;
-                break;
-            }
-        }
-        handler = eventHandlers_.Next(handler);
-    }
-
-    // Specific event handlers have priority, so if found, invoke first
-    if (specific)
-    {
-        context->SetEventHandler(specific);
-        specific->Invoke(eventData);
-        context->SetEventHandler(nullptr);
-        return;
-    }
+    // Specific event handlers have priority, so if found, invoke instead of the non-specific handler
+    EventHandler* handler = FindSpecificEventHandler(sender, eventType);
+    if (!handler)
+        handler = FindEventHandler(eventType);
 
-    if (nonSpecific)
+    if (handler)
     {
-        context->SetEventHandler(nonSpecific);
-        nonSpecific->Invoke(eventData);
+        context->SetEventHandler(handler);
+        handler->Invoke(eventData);
         context->SetEventHandler(nullptr);
     }
 }
@@ -145,17 +124,16 @@ void Object::SubscribeToEvent(StringHash eventType, EventHandler* handler)
         return;
 
     handler->SetSenderAndEventType(nullptr, eventType);
-    // Remove old event handler first
-    EventHandler* previous;
-    EventHandler* oldHandler = FindSpecificEventHandler(nullptr, eventType, &previous);
-    if (oldHandler)
+    // Replace old event handler if exists
+    FlatHashMap<StringHash, EventHandler*>::Iterator i = eventHandlers_.Find(eventType);
+    if (i != eventHandlers_.End())
     {
-        eventHandlers_.Erase(oldHandler, previous);
-        eventHandlers_.InsertFront(handler);
+        delete i->second_;
+        i->second_ = handler;
     }
     else
     {
-        eventHandlers_.InsertFront(handler);
+        eventHandlers_.Insert(MakePair(eventType, handler));
         context_->AddEventReceiver(this, eventType);
     }
 }
@@ -170,17 +148,17 @@ void Object::SubscribeToEvent(Object* sender, StringHash eventType, EventHandler
     }
 
     handler->SetSenderAndEventType(sender, eventType);
-    // Remove old event handler first
-    EventHandler* previous;
-    EventHandler* oldHandler = FindSpecificEventHandler(sender, eventType, &previous);
-    if (oldHandler)
+    // Replace old event handler if exists
+    FlatHashMap<StringHash, EventHandler*>& senderHandlers = specificEventHandlers_[sender];
+    FlatHashMap<StringHash, EventHandler*>::Iterator i = senderHandlers.Find(eventType);
+    if (i != senderHandlers.End())
     {
-        eventHandlers_.Erase(oldHandler, previous);
-        eventHandlers_.InsertFront(handler);
+        delete i->second_;
+        i->second_ = handler;
     }
     else
     {
-        eventHandlers_.InsertFront(handler);
+        senderHandlers.Insert(MakePair(eventType, handler));
         context_->AddEventReceiver(this, sender, eventType);
     }
 }
@@ -197,20 +175,29 @@ void Object::SubscribeToEvent(Object* sender, StringHash eventType, const std::f
 
 void Object::UnsubscribeFromEvent(StringHash eventType)
 {
-    for (;;)
+    FlatHashMap<StringHash, EventHandler*>::Iterator i = eventHandlers_.Find(eventType);
+    if (i != eventHandlers_.End())
     {
-        EventHandler* previous;
-        EventHandler* handler = FindEventHandler(eventType, &previous);
-        if (handler)
+        context_->RemoveEventReceiver(this, eventType);
+        delete i->second_;
+        eventHandlers_.Erase(i);
+    }
+
+    for (FlatHashMap<Object*, FlatHashMap<StringHash, EventHandler*> >::Iterator j = specificEventHandlers_.Begin();
+        j != specificEventHandlers_.End();)
+    {
+        FlatHashMap<StringHash, EventHandler*>::Iterator k = j->second_.Find(eventType);
+        if (k != j->second_.End())
         {
-            if (handler->GetSender())
-                context_->RemoveEventReceiver(this, handler->GetSender(), eventType);
-            else
-                context_->RemoveEventReceiver(this, eventType);
-            eventHandlers_.Erase(handler, previous);
+            context_->RemoveEventReceiver(this, j->first_, eventType);
+            delete k->second_;
+            j->second_.Erase(k);
         }
+
+        if (j->second_.Empty())
+            j = specificEventHandlers_.Erase(j);
         else
-            break;
+            ++j;
     }
 }
 
@@ -219,12 +206,18 @@ void Object::UnsubscribeFromEvent(Object* sender, StringHash eventType)
     if (!sender)
         return;
 
-    EventHandler* previous;
-    EventHandler* handler = FindSpecificEventHandler(sender, eventType, &previous);
-    if (handler)
+    FlatHashMap<Object*, FlatHashMap<StringHash, EventHandler*> >::Iterator i = specificEventHandlers_.Find(sender);
+    if (i == specificEventHandlers_.End())
+        return;
+
+    FlatHashMap<StringHash, EventHandler*>::Iterator j = i->second_.Find(eventType);
+    if (j != i->second_.End())
     {
-        context_->RemoveEventReceiver(this, handler->GetSender(), eventType);
-        eventHandlers_.Erase(handler, previous);
+        context_->RemoveEventReceiver(this, sender, eventType);
+        delete j->second_;
+        i->second_.Erase(j);
+        if (i->second_.Empty())
+            specificEventHandlers_.Erase(i);
     }
 }
 
@@ -233,60 +226,74 @@ void Object::UnsubscribeFromEvents(Object* sender)
     if (!sender)
         return;
 
-    for (;;)
+    FlatHashMap<Object*, FlatHashMap<StringHash, EventHandler*> >::Iterator i = specificEventHandlers_.Find(sender);
+    if (i == specificEventHandlers_.End())
+        return;
+
+    for (FlatHashMap<StringHash, EventHandler*>::Iterator j = i->second_.Begin(); j != i->second_.End(); ++j)
     {
-        EventHandler* previous;
-        EventHandler* handler = FindSpecificEventHandler(sender, &previous);
-        if (handler)
-        {
-            context_->RemoveEventReceiver(this, handler->GetSender(), handler->GetEventType());
-            eventHandlers_.Erase(handler, previous);
-        }
-        else
-            break;
+        context_->RemoveEventReceiver(this, sender, j->first_);
+        delete j->second_;
     }
+    specificEventHandlers_.Erase(i);
 }
 
 void Object::UnsubscribeFromAllEvents()
 {
-    for (;;)
+    for (FlatHashMap<StringHash, EventHandler*>::Iterator i = eventHandlers_.Begin(); i != eventHandlers_.End(); ++i)
+    {
+        context_->RemoveEventReceiver(this, i->first_);
+        delete i->second_;
+    }
+    eventHandlers_.Clear();
+
+    for (FlatHashMap<Object*, FlatHashMap<StringHash, EventHandler*> >::Iterator i = specificEventHandlers_.Begin();
+        i != specificEventHandlers_.End(); ++i)
     {
-        EventHandler* handler = eventHandlers_.First();
-        if (handler)
+        for (FlatHashMap<StringHash, EventHandler*>::Iterator j = i->second_.Begin(); j != i->second_.End(); ++j)
         {
-            if (handler->GetSender())
-                context_->RemoveEventReceiver(this, handler->GetSender(), handler->GetEventType());
-            else
-                context_->RemoveEventReceiver(this, handler->GetEventType());
-            eventHandlers_.Erase(handler);
+            context_->RemoveEventReceiver(this, i->first_, j->first_);
+            delete j->second_;
         }
-        else
-            break;
     }
+    specificEventHandlers_.Clear();
 }
 
 void Object::UnsubscribeFromAllEventsExcept(const PODVector<StringHash>& exceptions, bool onlyUserData)
 {
-    EventHandler* handler = eventHandlers_.First();
-    EventHandler* previous = nullptr;
-
-    while (handler)
+    for (FlatHashMap<StringHash, EventHandler*>::Iterator i = eventHandlers_.Begin(); i != eventHandlers_.End();)
     {
-        EventHandler* next = eventHandlers_.Next(handler);
+        EventHandler* handler = i->second_;
+        if ((!onlyUserData || handler->GetUserData()) && !exceptions.Contains(i->first_))
+        {
+            context_->RemoveEventReceiver(this, i->first_);
+            delete handler;
+            i = eventHandlers_.Erase(i);
+        }
+        else
+            ++i;
+    }
 
-        if ((!onlyUserData || handler->GetUserData()) && !exceptions.Contains(handler->GetEventType()))
+    for (FlatHashMap<Object*, FlatHashMap<StringHash, EventHandler*> >::Iterator i = specificEventHandlers_.Begin();
+        i != specificEventHandlers_.End();)
+    {
+        for (FlatHashMap<StringHash, EventHandler*>::Iterator j = i->second_.Begin(); j != i->second_.End();)
         {
-            if (handler->GetSender())
-                context_->RemoveEventReceiver(this, handler->GetSender(), handler->GetEventType());
+            EventHandler* handler = j->second_;
+            if ((!onlyUserData || handler->GetUserData()) && !exceptions.Contains(j->first_))
+            {
+                context_->RemoveEventReceiver(this, i->first_, j->first_);
+                delete handler;
+                j = i->second_.Erase(j);
+            }
             else
-                context_->RemoveEventReceiver(this, handler->GetEventType());
-
-            eventHandlers_.Erase(handler, previous);
+                ++j;
         }
-        else
-            previous = handler;
 
-        handler = next;
+        if (i->second_.Empty())
+            i = specificEventHandlers_.Erase(i);
+        else
+            ++i;
     }
 }
 
@@ -301,7 +308,7 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
 {
     if (!Thread::IsMainThread())
     {
-        URHO3D_LOGERROR("Sending events is only supported from the main thread");
+        URHO3D_LOGERROR("Sending events is only supported from the main thread, use PostEvent() from other threads");
         return;
     }
 
@@ -311,7 +318,7 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
     // Make a weak pointer to self to check for destruction during event handling
     WeakPtr<Object> self(this);
     Context* context = context_;
-    HashSet<Object*> processed;
+    FlatHashSet<Object*> processed;
 
     context->BeginSendEvent(this, eventType);
 
@@ -398,6 +405,16 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
     context->EndSendEvent();
 }
 
+void Object::PostEvent(StringHash eventType)
+{
+    context_->PostEvent(this, eventType, VariantMap());
+}
+
+void Object::PostEvent(StringHash eventType, VariantMap&& eventData)
+{
+    context_->PostEvent(this, eventType, std::move(eventData));
+}
+
 VariantMap& Object::GetEventDataMap() const
 {
     return context_->GetEventDataMap();
@@ -435,7 +452,17 @@ EventHandler* Object::GetEventHandler() const
 
 bool Object::HasSubscribedToEvent(StringHash eventType) const
 {
-    return FindEventHandler(eventType) != nullptr;
+    if (FindEventHandler(eventType))
+        return true;
+
+    for (FlatHashMap<Object*, FlatHashMap<StringHash, EventHandler*> >::ConstIterator i = specificEventHandlers_.Begin();
+        i != specificEventHandlers_.End(); ++i)
+    {
+        if (i->second_.Contains(eventType))
+            return true;
+    }
+
+    return false;
 }
 
 bool Object::HasSubscribedToEvent(Object* sender, StringHash eventType) const
@@ -458,79 +485,34 @@ const String& Object::GetCategory() const
     return String::EMPTY;
 }
 
-EventHandler* Object::FindEventHandler(StringHash eventType, EventHandler** previous) const
+EventHandler* Object::FindEventHandler(StringHash eventType) const
 {
-    EventHandler* handler = eventHandlers_.First();
-    if (previous)
-        *previous = nullptr;
-
-    while (handler)
-    {
-        if (handler->GetEventType() == eventType)
-            return handler;
-        if (previous)
-            *previous = handler;
-        handler = eventHandlers_.Next(handler);
-    }
-
-    return nullptr;
+    FlatHashMap<StringHash, EventHandler*>::ConstIterator i = eventHandlers_.Find(eventType);
+    return i != eventHandlers_.End() ? i->second_ : nullptr;
 }
 
-EventHandler* Object::FindSpecificEventHandler(Object* sender, EventHandler** previous) const
+EventHandler* Object::FindSpecificEventHandler(Object* sender, StringHash eventType) const
 {
-    EventHandler* handler = eventHandlers_.First();
-    if (previous)
-        *previous = nullptr;
+    if (specificEventHandlers_.Empty())
+        return nullptr;
 
-    while (handler)
-    {
-        if (handler->GetSender() == sender)
-            return handler;
-        if (previous)
-            *previous = handler;
-        handler = eventHandlers_.Next(handler);
-    }
-
-    return nullptr;
-}
-
-EventHandler* Object::FindSpecificEventHandler(Object* sender, StringHash eventType, EventHandler** previous) const
-{
-    EventHandler* handler = eventHandlers_.First();
-    if (previous)
-        *previous = nullptr;
-
-    while (handler)
-    {
-        if (handler->GetSender() == sender && handler->GetEventType() == eventType)
-            return handler;
-        if (previous)
-            *previous = handler;
-        handler = eventHandlers_.Next(handler);
-    }
+    FlatHashMap<Object*, FlatHashMap<StringHash, EventHandler*> >::ConstIterator i = specificEventHandlers_.Find(sender);
+    if (i == specificEventHandlers_.End())
+        return nullptr;
 
-    return nullptr;
+    FlatHashMap<StringHash, EventHandler*>::ConstIterator j = i->second_.Find(eventType);
+    return j != i->second_.End() ? j->second_ : nullptr;
 }
 
 void Object::RemoveEventSender(Object* sender)
 {
-    EventHandler* handler = eventHandlers_.First();
-    EventHandler* previous = nullptr;
+    FlatHashMap<Object*, FlatHashMap<StringHash, EventHandler*> >::Iterator i = specificEventHandlers_.Find(sender);
+    if (i == specificEventHandlers_.End())
+        return;
 
-    while (handler)
-    {
-        if (handler->GetSender() == sender)
-        {
-            EventHandler* next = eventHandlers_.Next(handler);
-            eventHandlers_.Erase(handler, previous);
-            handler = next;
-        }
-        else
-        {
-            previous = handler;
-            handler = eventHandlers_.Next(handler);
-        }
-    }
+    for (FlatHashMap<StringHash, EventHandler*>::Iterator j = i->second_.Begin(); j != i->second_.End(); ++j)
+        delete j->second_;
+    specificEventHandlers_.Erase(i);
 }
 
 StringHashRegister& GetEventNameRegister()
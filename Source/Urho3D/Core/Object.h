@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Container/FlatHashMap.h"
 #include "../Container/LinkedList.h"
 #include "../Core/StringHashRegister.h"
 #include "../Core/Variant.h"
@@ -139,6 +140,10 @@ public:
     {
         SendEvent(eventType, GetEventDataMap().Populate(args...));
     }
+    /// Post event to be sent from the main thread on the next frame. Can be called from any thread. The object must not be destroyed outside the main thread while it has events pending.
+    void PostEvent(StringHash eventType);
+    /// Post event with parameters to be sent from the main thread on the next frame. The parameters are moved, not copied. Can be called from any thread.
+    void PostEvent(StringHash eventType, VariantMap&& eventData);
 
     /// Return execution context.
     Context* GetContext() const { return context_; }
@@ -160,7 +165,7 @@ public:
     bool HasSubscribedToEvent(Object* sender, StringHash eventType) const;
 
     /// Return whether has subscribed to any event.
-    bool HasEventHandlers() const { return !eventHandlers_.Empty(); }
+    bool HasEventHandlers() const { return !eventHandlers_.Empty() || !specificEventHandlers_.Empty(); }
 
     /// Template version of returning a subsystem.
     template <class T> T* GetSubsystem() const;
@@ -177,17 +182,17 @@ protected:
     Context* context_;
 
 private:
-    /// Find the first event handler with no specific sender.
-    EventHandler* FindEventHandler(StringHash eventType, EventHandler** previous = nullptr) const;
-    /// Find the first event handler with specific sender.
-    EventHandler* FindSpecificEventHandler(Object* sender, EventHandler** previous = nullptr) const;
-    /// Find the first event handler with specific sender and event type.
-    EventHandler* FindSpecificEventHandler(Object* sender, StringHash eventType, EventHandler** previous = nullptr) const;
+    /// Find the event handler with no specific sender.
+    EventHandler* FindEventHandler(StringHash eventType) const;
+    /// Find the event handler with specific sender and event type.
+    EventHandler* FindSpecificEventHandler(Object* sender, StringHash eventType) const;
     /// Remove event handlers related to a specific sender.
     void RemoveEventSender(Object* sender);
 
-    /// Event handlers. Sender is null for non-specific handlers.
-    LinkedList<EventHandler> eventHandlers_;
+    /// Event handlers with no specific sender, indexed by event type. Owned by the object.
+    FlatHashMap<StringHash, EventHandler*> eventHandlers_;
+    /// Event handlers for specific senders, indexed by sender and event type. Owned by the object.
+    FlatHashMap<Object*, FlatHashMap<StringHash, EventHandler*> > specificEventHandlers_;
 
     /// Block object from sending and receiving any events.
     bool blockEvents_;
@@ -358,9 +363,14 @@ private:
 /// Get register of event names.
 URHO3D_API StringHashRegister& GetEventNameRegister();
 
-/// Describe an event's hash ID and begin a namespace in which to define its parameters.
-#define URHO3D_EVENT(eventID, eventName) static const Urho3D::StringHash eventID(Urho3D::GetEventNameRegister().RegisterString(#eventName)); namespace eventName
-/// Describe an event's parameter hash ID. Should be used inside an event namespace.
+#ifdef URHO3D_PROFILING
+/// Describe an event's hash ID and begin a namespace in which to define its parameters. The hash is calculated at compile time and the name is registered for the event profiler.
+#define URHO3D_EVENT(eventID, eventName) static const Urho3D::StringHash eventID(#eventName); static const Urho3D::StringHash eventID##_NAME_REGISTERED(Urho3D::GetEventNameRegister().RegisterString(eventID, #eventName)); namespace eventName
+#else
+/// Describe an event's hash ID and begin a namespace in which to define its parameters. The hash is calculated at compile time.
+#define URHO3D_EVENT(eventID, eventName) static const Urho3D::StringHash eventID(#eventName); namespace eventName
+#endif
+/// Describe an event's parameter hash ID. Should be used inside an event namespace. The hash is calculated at compile time.
 #define URHO3D_PARAM(paramID, paramName) static const Urho3D::StringHash paramID(#paramName)
 /// Convenience macro to construct an EventHandler that points to a receiver object and its member function.
 #define URHO3D_HANDLER(className, function) (new Urho3D::EventHandlerImpl<className>(this, &className::function))
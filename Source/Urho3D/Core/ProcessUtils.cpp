@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/Sort.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/StringUtils.h"
 #include "../IO/FileSystem.h"
@@ -62,6 +63,9 @@ extern "C" unsigned SDL_TVOS_GetActiveProcessorCount();
 #ifndef _WIN32
 #include <unistd.h>
 #endif
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#include <sched.h>
+#endif
 
 #if defined(__EMSCRIPTEN__) && defined(__EMSCRIPTEN_PTHREADS__)
 #include <emscripten/threading.h>
@@ -495,6 +499,151 @@ unsigned GetNumLogicalCPUs()
 #endif
 }
 
+static bool CompareLogicalCPUs(const LogicalCPU& lhs, const LogicalCPU& rhs)
+{
+    if (lhs.package_ != rhs.package_)
+        return lhs.package_ < rhs.package_;
+    else if (lhs.core_ != rhs.core_)
+        return lhs.core_ < rhs.core_;
+    else
+        return lhs.index_ < rhs.index_;
+}
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+/// Parse a CPU list such as "0-3,5,7-8" as used in sysfs.
+static void ParseCPUList(const char* list, PODVector<unsigned>& dest)
+{
+    const char* ptr = list;
+    for (;;)
+    {
+        char* end;
+        unsigned long first = strtoul(ptr, &end, 10);
+        if (end == ptr)
+            break;
+        unsigned long last = first;
+        ptr = end;
+        if (*ptr == '-')
+        {
+            last = strtoul(ptr + 1, &end, 10);
+            if (end == ptr + 1)
+                break;
+            ptr = end;
+        }
+
+        for (unsigned long i = first; i <= last && i < CPU_SETSIZE; ++i)
+            dest.Push((unsigned)i);
+
+        if (*ptr != ',')
+            break;
+        ++ptr;
+    }
+}
+#endif
+
+PODVector<LogicalCPU> GetCPUTopology()
+{
+    PODVector<LogicalCPU> cpus;
+
+#if defined(_WIN32)
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    PODVector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (infos.Empty() || !GetLogicalProcessorInformation(&infos[0], &length))
+        return cpus;
+
+    // Only the first processor group of 64 logical CPUs is reported, matching Thread::SetCurrentThreadAffinity()
+    unsigned core = 0;
+    for (unsigned i = 0; i < infos.Size(); ++i)
+    {
+        if (infos[i].Relationship != RelationProcessorCore)
+            continue;
+
+        for (unsigned j = 0; j < sizeof(ULONG_PTR) * 8; ++j)
+        {
+            if (!(infos[i].ProcessorMask & ((ULONG_PTR)1 << j)))
+                continue;
+
+            LogicalCPU cpu;
+            cpu.index_ = j;
+            cpu.core_ = core;
+            cpu.package_ = 0;
+            for (unsigned k = 0; k < infos.Size(); ++k)
+            {
+                if (infos[k].Relationship == RelationProcessorPackage)
+                {
+                    if (infos[k].ProcessorMask & ((ULONG_PTR)1 << j))
+                        break;
+                    ++cpu.package_;
+                }
+            }
+            cpus.Push(cpu);
+        }
+        ++core;
+    }
+#elif defined(__linux__) && !defined(__EMSCRIPTEN__)
+    // CPU indices can have gaps, for example when CPUs have been taken offline, so they are read from the online list
+    // instead of assuming that they are below the CPU count
+    PODVector<unsigned> indices;
+    FILE* fp = fopen("/sys/devices/system/cpu/online", "r");
+    if (fp)
+    {
+        char buffer[1024];
+        if (fgets(buffer, sizeof buffer, fp))
+            ParseCPUList(buffer, indices);
+        fclose(fp);
+    }
+
+    // Leave out the CPUs the calling thread is not allowed to run on, for example outside the process' cpuset, as pinning
+    // threads to them would fail
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool hasAllowed = sched_getaffinity(0, sizeof allowed, &allowed) == 0;
+    if (indices.Empty() && hasAllowed)
+    {
+        for (unsigned i = 0; i < CPU_SETSIZE; ++i)
+        {
+            if (CPU_ISSET(i, &allowed))
+                indices.Push(i);
+        }
+    }
+
+    for (unsigned j = 0; j < indices.Size(); ++j)
+    {
+        unsigned i = indices[j];
+        if (hasAllowed && (i >= CPU_SETSIZE || !CPU_ISSET(i, &allowed)))
+            continue;
+
+        LogicalCPU cpu;
+        cpu.index_ = i;
+        int coreID = -1, packageID = -1;
+
+        fp = fopen(ToString("/sys/devices/system/cpu/cpu%u/topology/core_id", i).CString(), "r");
+        if (!fp)
+            continue;
+        if (fscanf(fp, "%d", &coreID) != 1)                         // NOLINT(cert-err34-c)
+            coreID = -1;
+        fclose(fp);
+
+        fp = fopen(ToString("/sys/devices/system/cpu/cpu%u/topology/physical_package_id", i).CString(), "r");
+        if (fp)
+        {
+            if (fscanf(fp, "%d", &packageID) != 1)                  // NOLINT(cert-err34-c)
+                packageID = -1;
+            fclose(fp);
+        }
+
+        if (coreID < 0)
+            continue;
+        cpu.core_ = (unsigned)coreID;
+        cpu.package_ = packageID >= 0 ? (unsigned)packageID : 0;
+        cpus.Push(cpu);
+    }
+#endif
+
+    Sort(cpus.Begin(), cpus.End(), CompareLogicalCPUs);
+    return cpus;
+}
+
 void SetMiniDumpDir(const String& pathName)
 {
     miniDumpDir = AddTrailingSlash(pathName);
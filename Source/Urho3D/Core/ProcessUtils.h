@@ -31,6 +31,17 @@ namespace Urho3D
 
 class Mutex;
 
+/// Logical CPU and the physical core it belongs to.
+struct LogicalCPU
+{
+    /// Logical CPU index, as used for thread affinity.
+    unsigned index_;
+    /// Physical core ID, unique within the package.
+    unsigned core_;
+    /// Package (socket) ID.
+    unsigned package_;
+};
+
 /// Initialize the FPU to round-to-nearest, single precision mode.
 URHO3D_API void InitFPU();
 /// Display an error dialog with the specified title and message.
@@ -67,6 +78,8 @@ URHO3D_API String GetPlatform();
 URHO3D_API unsigned GetNumPhysicalCPUs();
 /// Return the number of logical CPUs (different from physical if hyperthreading is used).
 URHO3D_API unsigned GetNumLogicalCPUs();
+/// Return the online logical CPUs the calling thread is allowed to run on, ordered by package and physical core, so that the logical CPUs of a physical core are consecutive. Return empty if the topology can not be queried on the platform.
+URHO3D_API PODVector<LogicalCPU> GetCPUTopology();
 /// Set minidump write location as an absolute path. If empty, uses default (UserProfile/AppData/Roaming/urho3D/crashdumps) Minidumps are only supported on MSVC compiler.
 URHO3D_API void SetMiniDumpDir(const String& pathName);
 /// Return minidump write location.
@@ -22,7 +22,9 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/HashMap.h"
 #include "../Core/Profiler.h"
+#include "../IO/Serializer.h"
 
 #include <cstdio>
 
@@ -31,19 +33,51 @@
 namespace Urho3D
 {
 
+/// Next profiler ID.
+static std::atomic<unsigned> nextProfilerID{1};
+/// ID of the profiler the calling thread used last.
+static thread_local unsigned threadProfilerID = 0;
+/// Profiling data of the calling thread in the profiler it used last.
+static thread_local ProfilerThread* threadData = nullptr;
+
+/// Append a string to JSON output, escaping as necessary.
+static void AppendJSONString(String& output, const char* str)
+{
+    output += '"';
+    for (; *str; ++str)
+    {
+        if (*str == '"' || *str == '\\')
+            output += '\\';
+        output += *str;
+    }
+    output += '"';
+}
+
 Profiler::Profiler(Context* context) :
     Object(context),
     current_(nullptr),
     root_(nullptr),
-    intervalFrames_(0)
+    intervalFrames_(0),
+    mainThread_(nullptr),
+    id_(nextProfilerID++),
+    frameNumber_(0),
+    intervalNumber_(0),
+    capturing_(false),
+    captureNumber_(0),
+    maxCaptureEvents_(0)
 {
     current_ = root_ = new ProfilerBlock(nullptr, "RunFrame");
+    mainThread_ = new ProfilerThread("Main", nullptr);
+    threads_.Push(mainThread_);
 }
 
 Profiler::~Profiler()
 {
     delete root_;
     root_ = nullptr;
+
+    for (PODVector<ProfilerThread*>::Iterator i = threads_.Begin(); i != threads_.End(); ++i)
+        delete *i;
 }
 
 void Profiler::BeginFrame()
@@ -52,6 +86,9 @@ void Profiler::BeginFrame()
     if (root_->count_)
         EndFrame();
 
+    if (capturing_)
+        captureFrames_.Push(captureTimer_.GetUSec(false));
+
     root_->Begin();
 }
 
@@ -61,12 +98,130 @@ void Profiler::EndFrame()
     ++intervalFrames_;
     root_->EndFrame();
     current_ = root_;
+    ++frameNumber_;
 }
 
 void Profiler::BeginInterval()
 {
     root_->BeginInterval();
     intervalFrames_ = 0;
+    ++intervalNumber_;
+}
+
+void Profiler::BeginCapture(unsigned maxEventsPerThread)
+{
+    // Each thread discards its previous capture and reallocates its blocks on its own when it next records
+    capturing_ = false;
+    maxCaptureEvents_ = maxEventsPerThread;
+    captureFrames_.Clear();
+    captureTimer_.Reset();
+    ++captureNumber_;
+    capturing_ = true;
+}
+
+void Profiler::EndCapture()
+{
+    capturing_ = false;
+}
+
+bool Profiler::SaveChromeTrace(Serializer& dest) const
+{
+    static const int LINE_MAX_LENGTH = 256;
+
+    char line[LINE_MAX_LENGTH];
+    String output = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    MutexLock lock(threadsMutex_);
+
+    for (unsigned i = 0; i < threads_.Size(); ++i)
+    {
+        output += "{\"ph\":\"M\",\"pid\":0,\"tid\":" + String(i) + ",\"name\":\"thread_name\",\"args\":{\"name\":";
+        AppendJSONString(output, threads_[i]->name_.CString());
+        output += "}},\n";
+    }
+
+    // Frame markers as global instant events
+    for (unsigned i = 0; i < captureFrames_.Size(); ++i)
+    {
+        sprintf(line, "{\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":%lld,\"name\":\"Frame %u\"},\n",
+            captureFrames_[i], i);
+        output.Append(line);
+    }
+
+    for (unsigned i = 0; i < threads_.Size(); ++i)
+    {
+        const ProfilerThread* thread = threads_[i];
+        unsigned numEvents = GetNumCapturedEvents(thread);
+
+        for (unsigned j = 0; j < numEvents; ++j)
+        {
+            const ProfilerEvent& event = thread->events_[j];
+            sprintf(line, "{\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%lld,\"dur\":%lld,\"name\":", i, event.startTime_,
+                event.duration_);
+            output.Append(line);
+            AppendJSONString(output, event.name_);
+            output += "},\n";
+        }
+    }
+
+    // Remove the trailing separator. There is always at least the main thread name
+    output.Resize(output.Length() - 2);
+    output += "\n]}\n";
+
+    return dest.Write(output.CString(), output.Length()) == output.Length();
+}
+
+bool Profiler::SaveCapture(Serializer& dest) const
+{
+    MutexLock lock(threadsMutex_);
+
+    // Collect the block names to a table so that each event stores only an index
+    HashMap<String, unsigned> nameIndices;
+    Vector<String> names;
+    for (unsigned i = 0; i < threads_.Size(); ++i)
+    {
+        const ProfilerThread* thread = threads_[i];
+        unsigned numEvents = GetNumCapturedEvents(thread);
+
+        for (unsigned j = 0; j < numEvents; ++j)
+        {
+            String name(thread->events_[j].name_);
+            if (!nameIndices.Contains(name))
+            {
+                nameIndices[name] = names.Size();
+                names.Push(name);
+            }
+        }
+    }
+
+    bool success = true;
+    success &= dest.WriteFileID("UPRF");
+    success &= dest.WriteVLE(names.Size());
+    for (unsigned i = 0; i < names.Size(); ++i)
+        success &= dest.WriteString(names[i]);
+
+    success &= dest.WriteVLE(captureFrames_.Size());
+    for (unsigned i = 0; i < captureFrames_.Size(); ++i)
+        success &= dest.WriteInt64(captureFrames_[i]);
+
+    success &= dest.WriteVLE(threads_.Size());
+    for (unsigned i = 0; i < threads_.Size(); ++i)
+    {
+        const ProfilerThread* thread = threads_[i];
+        unsigned numEvents = GetNumCapturedEvents(thread);
+
+        success &= dest.WriteString(thread->name_);
+        success &= dest.WriteVLE(numEvents);
+        for (unsigned j = 0; j < numEvents; ++j)
+        {
+            const ProfilerEvent& event = thread->events_[j];
+            success &= dest.WriteVLE(nameIndices[String(event.name_)]);
+            success &= dest.WriteInt64(event.startTime_);
+            success &= dest.WriteVLE((unsigned)event.duration_);
+        }
+    }
+
+    return success;
 }
 
 const String& Profiler::PrintData(bool showUnused, bool showTotal, unsigned maxDepth) const
@@ -86,6 +241,11 @@ const String& Profiler::PrintData(bool showUnused, bool showTotal, unsigned maxD
 
     PrintData(root_, output, 0, maxDepth, showUnused, showTotal);
 
+    // Worker threads only add children to their trees while holding the mutex
+    MutexLock lock(threadsMutex_);
+    for (unsigned i = 1; i < threads_.Size(); ++i)
+        PrintData(threads_[i]->root_, output, 0, maxDepth, showUnused, showTotal);
+
     return output;
 }
 
@@ -141,4 +301,132 @@ void Profiler::PrintData(ProfilerBlock* block, String& output, unsigned depth, u
         PrintData(*i, output, depth, maxDepth, showUnused, showTotal);
 }
 
+void Profiler::BeginThreadBlock(const char* name)
+{
+    ProfilerThread* thread = GetThreadData();
+    ProfilerBlock* root = thread->root_;
+
+    // When beginning a top-level block, bring the thread's tree up to date with the frames and intervals of the main thread.
+    // This way only the owning thread modifies its tree
+    if (thread->current_ == root)
+    {
+        unsigned frameNumber = frameNumber_;
+        if (thread->frameNumber_ != frameNumber)
+        {
+            root->EndFrame();
+            thread->frameNumber_ = frameNumber;
+        }
+
+        unsigned intervalNumber = intervalNumber_;
+        if (thread->intervalNumber_ != intervalNumber)
+        {
+            root->BeginInterval();
+            thread->intervalNumber_ = intervalNumber;
+        }
+    }
+
+    ProfilerBlock* block = thread->current_->FindChild(name);
+    if (!block)
+    {
+        MutexLock lock(threadsMutex_);
+        block = thread->current_->GetChild(name);
+    }
+
+    thread->current_ = block;
+    block->Begin();
+}
+
+void Profiler::EndThreadBlock()
+{
+    ProfilerThread* thread = GetThreadData();
+    ProfilerBlock* block = thread->current_;
+    ProfilerBlock* root = thread->root_;
+    if (block == root)
+        return;
+
+    long long time = block->End();
+    if (capturing_)
+        RecordEvent(thread, block->name_, time);
+
+    // Accumulate the top-level blocks to the root block to show the busy time of the thread
+    thread->current_ = block->parent_;
+    if (thread->current_ == root)
+    {
+        if (time > root->maxTime_)
+            root->maxTime_ = time;
+        root->time_ += time;
+        ++root->count_;
+    }
+}
+
+ProfilerThread* Profiler::GetThreadData()
+{
+    if (threadProfilerID != id_)
+    {
+        MutexLock lock(threadsMutex_);
+
+        // The thread may have used this profiler before switching to another one. The main thread has no data of its own
+        ThreadID threadID = Thread::GetCurrentThreadID();
+        ProfilerThread* thread = nullptr;
+        for (unsigned i = 1; i < threads_.Size(); ++i)
+        {
+            if (threads_[i]->threadID_ == threadID)
+            {
+                thread = threads_[i];
+                break;
+            }
+        }
+
+        if (!thread)
+        {
+            String name = "Thread " + String(threads_.Size());
+            thread = new ProfilerThread(name, new ProfilerBlock(nullptr, name.CString()));
+            thread->frameNumber_ = frameNumber_;
+            thread->intervalNumber_ = intervalNumber_;
+            thread->threadID_ = threadID;
+            threads_.Push(thread);
+        }
+
+        threadProfilerID = id_;
+        threadData = thread;
+    }
+
+    return threadData;
+}
+
+void Profiler::RecordEvent(ProfilerThread* thread, const char* name, long long duration)
+{
+    // On the first block of a new capture, reallocate in the owning thread. Saving skips the thread until the capture number is published
+    unsigned captureNumber = captureNumber_.load(std::memory_order_acquire);
+    if (thread->captureNumber_.load(std::memory_order_relaxed) != captureNumber)
+    {
+        unsigned maxEvents = maxCaptureEvents_;
+        if (thread->events_.Size() != maxEvents)
+            thread->events_.Resize(maxEvents);
+        thread->numEvents_.store(0, std::memory_order_relaxed);
+        thread->captureNumber_.store(captureNumber, std::memory_order_release);
+    }
+
+    unsigned index = thread->numEvents_.load(std::memory_order_relaxed);
+    if (index >= thread->events_.Size())
+        return;
+
+    ProfilerEvent& event = thread->events_[index];
+    event.name_ = name;
+    event.startTime_ = captureTimer_.GetUSec(false) - duration;
+    event.duration_ = duration;
+
+    // Publish the event for saving the capture
+    thread->numEvents_.store(index + 1, std::memory_order_release);
+}
+
+unsigned Profiler::GetNumCapturedEvents(const ProfilerThread* thread) const
+{
+    // A thread that has not recorded since the capture began may be reallocating its blocks, and has none in this capture
+    if (thread->captureNumber_.load(std::memory_order_acquire) != captureNumber_)
+        return 0;
+
+    return thread->numEvents_.load(std::memory_order_acquire);
+}
+
 }
@@ -23,12 +23,20 @@
 #pragma once
 
 #include "../Container/Str.h"
+#include "../Core/Mutex.h"
 #include "../Core/Thread.h"
 #include "../Core/Timer.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
+class Serializer;
+
+/// Default maximum number of captured profiling blocks per thread.
+static const unsigned DEFAULT_MAX_CAPTURE_EVENTS = 256 * 1024;
+
 /// Profiling data for one block in the profiling tree.
 class URHO3D_API ProfilerBlock
 {
@@ -77,13 +85,14 @@ public:
         ++count_;
     }
 
-    /// End timing.
-    void End()
+    /// End timing. Return the duration in microseconds.
+    long long End()
     {
         long long time = timer_.GetUSec(false);
         if (time > maxTime_)
             maxTime_ = time;
         time_ += time;
+        return time;
     }
 
     /// End profiling frame and update interval and total values.
@@ -119,15 +128,24 @@ public:
             (*i)->BeginInterval();
     }
 
-    /// Return child block with the specified name.
-    ProfilerBlock* GetChild(const char* name)
+    /// Return child block with the specified name, or null if does not exist.
+    ProfilerBlock* FindChild(const char* name) const
     {
-        for (PODVector<ProfilerBlock*>::Iterator i = children_.Begin(); i != children_.End(); ++i)
+        for (PODVector<ProfilerBlock*>::ConstIterator i = children_.Begin(); i != children_.End(); ++i)
         {
             if (!String::Compare((*i)->name_, name, true))
                 return *i;
         }
 
+        return nullptr;
+    }
+
+    /// Return child block with the specified name. Create if does not exist.
+    ProfilerBlock* GetChild(const char* name)
+    {
+        if (ProfilerBlock* block = FindChild(name))
+            return block;
+
         auto* newBlock = new ProfilerBlock(this, name);
         children_.Push(newBlock);
 
@@ -168,6 +186,56 @@ public:
     unsigned totalCount_;
 };
 
+/// Captured profiling block for the timeline.
+struct ProfilerEvent
+{
+    /// Block name. Points to the name of the block in the profiling tree.
+    const char* name_;
+    /// Start time in microseconds since the capture began.
+    long long startTime_;
+    /// Duration in microseconds.
+    long long duration_;
+};
+
+/// Profiling data of one thread. Only the owning thread records into it, so no locking is needed.
+struct URHO3D_API ProfilerThread
+{
+    /// Construct with name and root block. The root block is owned if not null.
+    ProfilerThread(const String& name, ProfilerBlock* root) :
+        name_(name),
+        root_(root),
+        current_(root),
+        frameNumber_(0),
+        intervalNumber_(0)
+    {
+    }
+
+    /// Destruct. Free the block tree.
+    ~ProfilerThread()
+    {
+        delete root_;
+    }
+
+    /// Thread name.
+    String name_;
+    /// Root block of the thread's profiling tree. Null for the main thread, which uses the profiler's own tree.
+    ProfilerBlock* root_;
+    /// Current profiling block.
+    ProfilerBlock* current_;
+    /// Captured blocks. Reallocated by the owning thread when it records the first block of a new capture, so that no other thread may be writing to them.
+    PODVector<ProfilerEvent> events_;
+    /// Number of captured blocks.
+    std::atomic<unsigned> numEvents_{};
+    /// Capture number the captured blocks belong to.
+    std::atomic<unsigned> captureNumber_{};
+    /// Profiler frame number the tree has been updated to.
+    unsigned frameNumber_;
+    /// Profiler interval number the tree has been updated to.
+    unsigned intervalNumber_;
+    /// ID of the thread the data belongs to.
+    ThreadID threadID_{};
+};
+
 /// Hierarchical performance profiler subsystem.
 class URHO3D_API Profiler : public Object
 {
@@ -182,9 +250,11 @@ public:
     /// Begin timing a profiling block.
     void BeginBlock(const char* name)
     {
-        // Profiler supports only the main thread currently
         if (!Thread::IsMainThread())
+        {
+            BeginThreadBlock(name);
             return;
+        }
 
         current_ = current_->GetChild(name);
         current_->Begin();
@@ -194,9 +264,14 @@ public:
     void EndBlock()
     {
         if (!Thread::IsMainThread())
+        {
+            EndThreadBlock();
             return;
+        }
 
-        current_->End();
+        long long time = current_->End();
+        if (capturing_)
+            RecordEvent(mainThread_, current_->name_, time);
         if (current_->parent_)
             current_ = current_->parent_;
     }
@@ -207,6 +282,14 @@ public:
     void EndFrame();
     /// Begin a new interval.
     void BeginInterval();
+    /// Begin capturing a timeline of the profiling blocks of all threads, up to the specified number of blocks per thread. Call from the main thread.
+    void BeginCapture(unsigned maxEventsPerThread = DEFAULT_MAX_CAPTURE_EVENTS);
+    /// End capturing the timeline.
+    void EndCapture();
+    /// Save the captured timeline as Chrome Trace Event JSON, which can be viewed in chrome://tracing or Perfetto. Return true if successful.
+    bool SaveChromeTrace(Serializer& dest) const;
+    /// Save the captured timeline in a compact binary format. Return true if successful.
+    bool SaveCapture(Serializer& dest) const;
 
     /// Return profiling data as text output. This method is not thread-safe.
     const String& PrintData(bool showUnused = false, bool showTotal = false, unsigned maxDepth = M_MAX_UNSIGNED) const;
@@ -214,10 +297,22 @@ public:
     const ProfilerBlock* GetCurrentBlock() { return current_; }
     /// Return the root profiling block.
     const ProfilerBlock* GetRootBlock() { return root_; }
+    /// Return whether the timeline is being captured.
+    bool IsCapturing() const { return capturing_; }
 
 protected:
     /// Return profiling data as text output for a specified profiling block.
     void PrintData(ProfilerBlock* block, String& output, unsigned depth, unsigned maxDepth, bool showUnused, bool showTotal) const;
+    /// Begin timing a profiling block in a worker thread.
+    void BeginThreadBlock(const char* name);
+    /// End timing the current profiling block in a worker thread.
+    void EndThreadBlock();
+    /// Return the profiling data of the calling worker thread, registering it on first use.
+    ProfilerThread* GetThreadData();
+    /// Record a finished block to the thread's captured timeline.
+    void RecordEvent(ProfilerThread* thread, const char* name, long long duration);
+    /// Return number of blocks a thread has captured in the current capture.
+    unsigned GetNumCapturedEvents(const ProfilerThread* thread) const;
 
     /// Current profiling block.
     ProfilerBlock* current_;
@@ -225,6 +320,28 @@ protected:
     ProfilerBlock* root_;
     /// Frames in the current interval.
     unsigned intervalFrames_;
+    /// Per-thread profiling data. The first is the main thread.
+    PODVector<ProfilerThread*> threads_;
+    /// Main thread profiling data.
+    ProfilerThread* mainThread_;
+    /// Mutex for registering threads.
+    mutable Mutex threadsMutex_;
+    /// Unique ID for the threads to recognize the profiler they last used. Never reused, unlike the address.
+    unsigned id_;
+    /// Frame counter for worker threads to finish their frames.
+    std::atomic<unsigned> frameNumber_;
+    /// Interval counter for worker threads to begin new intervals.
+    std::atomic<unsigned> intervalNumber_;
+    /// Timeline capture flag.
+    std::atomic<bool> capturing_;
+    /// Capture counter for threads to reallocate their captured blocks.
+    std::atomic<unsigned> captureNumber_;
+    /// Maximum number of captured blocks per thread.
+    std::atomic<unsigned> maxCaptureEvents_;
+    /// Timer for the captured timeline.
+    HiresTimer captureTimer_;
+    /// Frame start times in the captured timeline.
+    PODVector<long long> captureFrames_;
 };
 
 /// Helper class for automatically beginning and ending a profiling block.
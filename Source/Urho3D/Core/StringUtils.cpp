@@ -24,6 +24,8 @@
 
 #include "../Core/StringUtils.h"
 
+#include <clocale>
+#include <cmath>
 #include <cstdio>
 
 #include "../DebugNew.h"
@@ -36,6 +38,166 @@ static const String base64_chars =
     "abcdefghijklmnopqrstuvwxyz"
     "0123456789+/";
 
+static const double powersOfTen[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/// Largest power of ten that is exactly representable as a double.
+static const int MAX_EXACT_POWER_OF_TEN = 22;
+/// Most significant digits that are guaranteed to fit exactly in the mantissa of a double.
+static const int MAX_EXACT_DIGITS = 15;
+/// Most decimal digits of a 64-bit signed integer that can not overflow.
+static const int MAX_INT64_DIGITS = 18;
+
+static inline bool IsSpaceChar(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static inline bool IsDecimalChar(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/// Multiply a double by a power of ten.
+static double ScaleByPowerOfTen(double value, int exponent)
+{
+    while (exponent > MAX_EXACT_POWER_OF_TEN)
+    {
+        value *= powersOfTen[MAX_EXACT_POWER_OF_TEN];
+        exponent -= MAX_EXACT_POWER_OF_TEN;
+    }
+    while (exponent < -MAX_EXACT_POWER_OF_TEN)
+    {
+        value /= powersOfTen[MAX_EXACT_POWER_OF_TEN];
+        exponent += MAX_EXACT_POWER_OF_TEN;
+    }
+
+    return exponent >= 0 ? value * powersOfTen[exponent] : value / powersOfTen[-exponent];
+}
+
+/// Parse a decimal integer of at most 18 digits. Return false if the runtime library has to parse it instead.
+static bool ParseShortDecimal(const char* source, long long& value, char** end)
+{
+    const char* ptr = source;
+    while (IsSpaceChar(*ptr))
+        ++ptr;
+
+    bool negative = false;
+    if (*ptr == '-' || *ptr == '+')
+        negative = *ptr++ == '-';
+    if (!IsDecimalChar(*ptr))
+        return false;
+
+    long long result = 0;
+    int digits = 0;
+    while (IsDecimalChar(*ptr))
+    {
+        if (++digits > MAX_INT64_DIGITS)
+            return false;
+        result = result * 10 + (*ptr++ - '0');
+    }
+
+    value = negative ? -result : result;
+    if (end)
+        *end = const_cast<char*>(ptr);
+    return true;
+}
+
+/// Parse a decimal integer in the int range, or fall back to strtol.
+static int ParseDecimalInt(const char* source, char** end)
+{
+    long long value;
+    if (ParseShortDecimal(source, value, end) && value >= M_MIN_INT && value <= M_MAX_INT)
+        return (int)value;
+
+    return (int)strtol(source, end, 10);
+}
+
+/// Write decimal digits of an unsigned integer backwards from the end of a buffer. Return pointer to the first digit.
+static char* WriteDigitsBackwards(char* bufferEnd, unsigned long long value)
+{
+    do
+    {
+        *--bufferEnd = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    return bufferEnd;
+}
+
+/// Write a float given as significant decimal digits and the decimal exponent of the first digit, using the same notation as printf's %g.
+static unsigned WriteDecimalFloat(char* dest, bool negative, unsigned long long significand, int exponent)
+{
+    char digitBuffer[24];
+    char* digits = WriteDigitsBackwards(digitBuffer + sizeof digitBuffer, significand);
+    auto numDigits = (int)(digitBuffer + sizeof digitBuffer - digits);
+    char* ptr = dest;
+
+    if (negative)
+        *ptr++ = '-';
+
+    if (exponent >= -4 && exponent < Max(numDigits, 6))
+    {
+        if (exponent < 0)
+        {
+            *ptr++ = '0';
+            *ptr++ = '.';
+            for (int i = -1; i > exponent; --i)
+                *ptr++ = '0';
+            for (int i = 0; i < numDigits; ++i)
+                *ptr++ = digits[i];
+        }
+        else
+        {
+            for (int i = 0; i <= exponent; ++i)
+                *ptr++ = i < numDigits ? digits[i] : '0';
+            if (numDigits > exponent + 1)
+            {
+                *ptr++ = '.';
+                for (int i = exponent + 1; i < numDigits; ++i)
+                    *ptr++ = digits[i];
+            }
+        }
+    }
+    else
+    {
+        *ptr++ = digits[0];
+        if (numDigits > 1)
+        {
+            *ptr++ = '.';
+            for (int i = 1; i < numDigits; ++i)
+                *ptr++ = digits[i];
+        }
+        *ptr++ = 'e';
+        *ptr++ = exponent < 0 ? '-' : '+';
+        unsigned absExponent = (unsigned)Abs(exponent);
+        if (absExponent < 10)
+            *ptr++ = '0';
+        char exponentBuffer[8];
+        char* exponentDigits = WriteDigitsBackwards(exponentBuffer + sizeof exponentBuffer, absExponent);
+        while (exponentDigits < exponentBuffer + sizeof exponentBuffer)
+            *ptr++ = *exponentDigits++;
+    }
+
+    *ptr = 0;
+    return (unsigned)(ptr - dest);
+}
+
+/// Parse a decimal number that can not be converted exactly by the fast path with strtod, substituting the decimal point of the C locale.
+static double ParseLongDecimal(const char* start, const char* end)
+{
+    const char* decimalPoint = localeconv()->decimal_point;
+    if (!strcmp(decimalPoint, "."))
+        return strtod(start, nullptr);
+
+    String number(start, (unsigned)(end - start));
+    number.Replace(".", decimalPoint);
+    return strtod(number.CString(), nullptr);
+}
+
 unsigned CountElements(const char* buffer, char separator)
 {
     if (!buffer)
@@ -122,6 +284,9 @@ int ToInt(const char* source, int base)
     if (base < 2 || base > 36)
         base = 0;
 
+    if (base == 10)
+        return ParseDecimalInt(source, nullptr);
+
     return (int)strtol(source, nullptr, base);
 }
 
@@ -134,6 +299,10 @@ long long ToInt64(const char* source, int base)
     if (base < 2 || base > 36)
         base = 0;
 
+    long long value;
+    if (base == 10 && ParseShortDecimal(source, value, nullptr))
+        return value;
+
     return strtoll(source, nullptr, base);
 }
 
@@ -156,6 +325,10 @@ unsigned long long ToUInt64(const char* source, int base)
     if (base < 2 || base > 36)
         base = 0;
 
+    long long value;
+    if (base == 10 && ParseShortDecimal(source, value, nullptr) && value >= 0)
+        return (unsigned long long)value;
+
     return strtoull(source, nullptr, base);
 }
 
@@ -172,6 +345,10 @@ unsigned ToUInt(const char* source, int base)
     if (base < 2 || base > 36)
         base = 0;
 
+    long long value;
+    if (base == 10 && ParseShortDecimal(source, value, nullptr) && value >= 0 && value <= M_MAX_UNSIGNED)
+        return (unsigned)value;
+
     return (unsigned)strtoul(source, nullptr, base);
 }
 
@@ -185,7 +362,7 @@ float ToFloat(const char* source)
     if (!source)
         return 0;
 
-    return (float)strtod(source, nullptr);
+    return (float)ParseDouble(source);
 }
 
 double ToDouble(const String& source)
@@ -198,7 +375,191 @@ double ToDouble(const char* source)
     if (!source)
         return 0;
 
-    return strtod(source, nullptr);
+    return ParseDouble(source);
+}
+
+double ParseDouble(const char* source, char** end)
+{
+    const char* ptr = source;
+    while (IsSpaceChar(*ptr))
+        ++ptr;
+
+    bool negative = false;
+    if (*ptr == '-' || *ptr == '+')
+        negative = *ptr++ == '-';
+
+    const char* number = ptr;
+    unsigned long long significand = 0;
+    int numDigits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+
+    // Accumulate significant digits, leading zeros excluded
+    while (IsDecimalChar(*ptr))
+    {
+        anyDigits = true;
+        if ((significand || *ptr != '0') && ++numDigits <= MAX_EXACT_DIGITS)
+            significand = significand * 10 + (*ptr - '0');
+        else if (numDigits > MAX_EXACT_DIGITS)
+            ++exponent;
+        ++ptr;
+    }
+
+    // Leave hexadecimal numbers to the runtime library
+    if (anyDigits && !significand && (*ptr == 'x' || *ptr == 'X'))
+        return strtod(source, end);
+
+    if (*ptr == '.')
+    {
+        ++ptr;
+        while (IsDecimalChar(*ptr))
+        {
+            anyDigits = true;
+            if ((significand || *ptr != '0') && ++numDigits <= MAX_EXACT_DIGITS)
+            {
+                significand = significand * 10 + (*ptr - '0');
+                --exponent;
+            }
+            else if (numDigits <= MAX_EXACT_DIGITS)
+                --exponent;
+            ++ptr;
+        }
+    }
+
+    // Infinity, NaN or not a number at all
+    if (!anyDigits)
+        return strtod(source, end);
+
+    if (*ptr == 'e' || *ptr == 'E')
+    {
+        const char* exponentPtr = ptr + 1;
+        bool negativeExponent = false;
+        if (*exponentPtr == '-' || *exponentPtr == '+')
+            negativeExponent = *exponentPtr++ == '-';
+
+        // The exponent is only part of the number if it has digits
+        if (IsDecimalChar(*exponentPtr))
+        {
+            int exponentValue = 0;
+            while (IsDecimalChar(*exponentPtr))
+            {
+                if (exponentValue < 100000)
+                    exponentValue = exponentValue * 10 + (*exponentPtr - '0');
+                ++exponentPtr;
+            }
+            exponent += negativeExponent ? -exponentValue : exponentValue;
+            ptr = exponentPtr;
+        }
+    }
+
+    // Both the significand and the power of ten are exact doubles, so a single multiplication or division rounds correctly
+    double value;
+    if (!significand)
+        value = 0.0;
+    else if (numDigits <= MAX_EXACT_DIGITS && exponent >= -MAX_EXACT_POWER_OF_TEN && exponent <= MAX_EXACT_POWER_OF_TEN)
+        value = exponent >= 0 ? (double)significand * powersOfTen[exponent] : (double)significand / powersOfTen[-exponent];
+    else if (numDigits <= MAX_EXACT_DIGITS && exponent > MAX_EXACT_POWER_OF_TEN && exponent - MAX_EXACT_POWER_OF_TEN + numDigits <= MAX_EXACT_DIGITS)
+        value = (double)(significand * (unsigned long long)powersOfTen[exponent - MAX_EXACT_POWER_OF_TEN]) * powersOfTen[MAX_EXACT_POWER_OF_TEN];
+    else
+        value = ParseLongDecimal(number, ptr);
+
+    if (end)
+        *end = const_cast<char*>(ptr);
+    return negative ? -value : value;
+}
+
+unsigned FormatFloat(char* dest, float value)
+{
+    if (IsNaN(value))
+    {
+        strcpy(dest, "nan");
+        return 3;
+    }
+
+    bool negative = std::signbit(value);
+    if (IsInf(value))
+    {
+        strcpy(dest, negative ? "-inf" : "inf");
+        return negative ? 4 : 3;
+    }
+    if (value == 0.0f)
+    {
+        strcpy(dest, negative ? "-0" : "0");
+        return negative ? 2 : 1;
+    }
+
+    double absValue = Abs((double)value);
+    auto exponent = (int)floor(log10(absValue));
+    double normalized = ScaleByPowerOfTen(absValue, -exponent);
+    if (normalized >= 10.0)
+        ++exponent;
+    else if (normalized < 1.0)
+        --exponent;
+
+    // Find the least number of significant digits that parses back to the same float. 9 digits are always enough
+    for (int precision = 1;; ++precision)
+    {
+        auto significand = (unsigned long long)floor(ScaleByPowerOfTen(absValue, precision - 1 - exponent) + 0.5);
+        int significandExponent = exponent;
+        if (significand >= (unsigned long long)powersOfTen[precision])
+        {
+            significand /= 10;
+            ++significandExponent;
+        }
+
+        // When parsing the digits back is exact, check the round trip without writing them, same as in ParseDouble
+        int powerOfTen = significandExponent - precision + 1;
+        bool exactParse = powerOfTen >= -MAX_EXACT_POWER_OF_TEN && powerOfTen <= MAX_EXACT_POWER_OF_TEN;
+        if (exactParse && precision < 9)
+        {
+            double parsed = powerOfTen >= 0 ? (double)significand * powersOfTen[powerOfTen] : (double)significand / powersOfTen[-powerOfTen];
+            if ((float)parsed != (float)absValue)
+                continue;
+        }
+
+        while (significand % 10 == 0)
+            significand /= 10;
+
+        unsigned length = WriteDecimalFloat(dest, negative, significand, significandExponent);
+        if (exactParse || precision >= 9 || (float)ParseDouble(dest) == value)
+            return length;
+    }
+}
+
+unsigned FormatFloats(char* dest, const float* values, unsigned count)
+{
+    char* ptr = dest;
+    *ptr = 0;
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (i)
+            *ptr++ = ' ';
+        ptr += FormatFloat(ptr, values[i]);
+    }
+
+    return (unsigned)(ptr - dest);
+}
+
+unsigned FormatInt(char* dest, long long value)
+{
+    if (value < 0)
+    {
+        *dest = '-';
+        return FormatUInt(dest + 1, 0ULL - (unsigned long long)value) + 1;
+    }
+    else
+        return FormatUInt(dest, (unsigned long long)value);
+}
+
+unsigned FormatUInt(char* dest, unsigned long long value)
+{
+    char buffer[24];
+    char* digits = WriteDigitsBackwards(buffer + sizeof buffer, value);
+    auto length = (unsigned)(buffer + sizeof buffer - digits);
+    memcpy(dest, digits, length);
+    dest[length] = 0;
+    return length;
 }
 
 Color ToColor(const String& source)
@@ -215,11 +576,11 @@ Color ToColor(const char* source)
         return ret;
 
     auto* ptr = (char*)source;
-    ret.r_ = (float)strtod(ptr, &ptr);
-    ret.g_ = (float)strtod(ptr, &ptr);
-    ret.b_ = (float)strtod(ptr, &ptr);
+    ret.r_ = (float)ParseDouble(ptr, &ptr);
+    ret.g_ = (float)ParseDouble(ptr, &ptr);
+    ret.b_ = (float)ParseDouble(ptr, &ptr);
     if (elements > 3)
-        ret.a_ = (float)strtod(ptr, &ptr);
+        ret.a_ = (float)ParseDouble(ptr, &ptr);
 
     return ret;
 }
@@ -238,10 +599,10 @@ IntRect ToIntRect(const char* source)
         return ret;
 
     auto* ptr = (char*)source;
-    ret.left_ = (int)strtol(ptr, &ptr, 10);
-    ret.top_ = (int)strtol(ptr, &ptr, 10);
-    ret.right_ = (int)strtol(ptr, &ptr, 10);
-    ret.bottom_ = (int)strtol(ptr, &ptr, 10);
+    ret.left_ = ParseDecimalInt(ptr, &ptr);
+    ret.top_ = ParseDecimalInt(ptr, &ptr);
+    ret.right_ = ParseDecimalInt(ptr, &ptr);
+    ret.bottom_ = ParseDecimalInt(ptr, &ptr);
 
     return ret;
 }
@@ -260,8 +621,8 @@ IntVector2 ToIntVector2(const char* source)
         return ret;
 
     auto* ptr = (char*)source;
-    ret.x_ = (int)strtol(ptr, &ptr, 10);
-    ret.y_ = (int)strtol(ptr, &ptr, 10);
+    ret.x_ = ParseDecimalInt(ptr, &ptr);
+    ret.y_ = ParseDecimalInt(ptr, &ptr);
 
     return ret;
 }
@@ -280,9 +641,9 @@ IntVector3 ToIntVector3(const char* source)
         return ret;
 
     auto* ptr = (char*)source;
-    ret.x_ = (int)strtol(ptr, &ptr, 10);
-    ret.y_ = (int)strtol(ptr, &ptr, 10);
-    ret.z_ = (int)strtol(ptr, &ptr, 10);
+    ret.x_ = ParseDecimalInt(ptr, &ptr);
+    ret.y_ = ParseDecimalInt(ptr, &ptr);
+    ret.z_ = ParseDecimalInt(ptr, &ptr);
 
     return ret;
 }
@@ -301,10 +662,10 @@ Rect ToRect(const char* source)
         return ret;
 
     auto* ptr = (char*)source;
-    ret.min_.x_ = (float)strtod(ptr, &ptr);
-    ret.min_.y_ = (float)strtod(ptr, &ptr);
-    ret.max_.x_ = (float)strtod(ptr, &ptr);
-    ret.max_.y_ = (float)strtod(ptr, &ptr);
+    ret.min_.x_ = (float)ParseDouble(ptr, &ptr);
+    ret.min_.y_ = (float)ParseDouble(ptr, &ptr);
+    ret.max_.x_ = (float)ParseDouble(ptr, &ptr);
+    ret.max_.y_ = (float)ParseDouble(ptr, &ptr);
 
     return ret;
 }
@@ -325,9 +686,9 @@ Quaternion ToQuaternion(const char* source)
     {
         // 3 coords specified: conversion from Euler angles
         float x, y, z;
-        x = (float)strtod(ptr, &ptr);
-        y = (float)strtod(ptr, &ptr);
-        z = (float)strtod(ptr, &ptr);
+        x = (float)ParseDouble(ptr, &ptr);
+        y = (float)ParseDouble(ptr, &ptr);
+        z = (float)ParseDouble(ptr, &ptr);
 
         return Quaternion(x, y, z);
     }
@@ -335,10 +696,10 @@ Quaternion ToQuaternion(const char* source)
     {
         // 4 coords specified: full quaternion
         Quaternion ret;
-        ret.w_ = (float)strtod(ptr, &ptr);
-        ret.x_ = (float)strtod(ptr, &ptr);
-        ret.y_ = (float)strtod(ptr, &ptr);
-        ret.z_ = (float)strtod(ptr, &ptr);
+        ret.w_ = (float)ParseDouble(ptr, &ptr);
+        ret.x_ = (float)ParseDouble(ptr, &ptr);
+        ret.y_ = (float)ParseDouble(ptr, &ptr);
+        ret.z_ = (float)ParseDouble(ptr, &ptr);
 
         return ret;
     }
@@ -358,8 +719,8 @@ Vector2 ToVector2(const char* source)
         return ret;
 
     auto* ptr = (char*)source;
-    ret.x_ = (float)strtod(ptr, &ptr);
-    ret.y_ = (float)strtod(ptr, &ptr);
+    ret.x_ = (float)ParseDouble(ptr, &ptr);
+    ret.y_ = (float)ParseDouble(ptr, &ptr);
 
     return ret;
 }
@@ -378,9 +739,9 @@ Vector3 ToVector3(const char* source)
         return ret;
 
     auto* ptr = (char*)source;
-    ret.x_ = (float)strtod(ptr, &ptr);
-    ret.y_ = (float)strtod(ptr, &ptr);
-    ret.z_ = (float)strtod(ptr, &ptr);
+    ret.x_ = (float)ParseDouble(ptr, &ptr);
+    ret.y_ = (float)ParseDouble(ptr, &ptr);
+    ret.z_ = (float)ParseDouble(ptr, &ptr);
 
     return ret;
 }
@@ -402,23 +763,23 @@ Vector4 ToVector4(const char* source, bool allowMissingCoords)
         if (elements < 4)
             return ret;
 
-        ret.x_ = (float)strtod(ptr, &ptr);
-        ret.y_ = (float)strtod(ptr, &ptr);
-        ret.z_ = (float)strtod(ptr, &ptr);
-        ret.w_ = (float)strtod(ptr, &ptr);
+        ret.x_ = (float)ParseDouble(ptr, &ptr);
+        ret.y_ = (float)ParseDouble(ptr, &ptr);
+        ret.z_ = (float)ParseDouble(ptr, &ptr);
+        ret.w_ = (float)ParseDouble(ptr, &ptr);
 
         return ret;
     }
     else
     {
         if (elements > 0)
-            ret.x_ = (float)strtod(ptr, &ptr);
+            ret.x_ = (float)ParseDouble(ptr, &ptr);
         if (elements > 1)
-            ret.y_ = (float)strtod(ptr, &ptr);
+            ret.y_ = (float)ParseDouble(ptr, &ptr);
         if (elements > 2)
-            ret.z_ = (float)strtod(ptr, &ptr);
+            ret.z_ = (float)ParseDouble(ptr, &ptr);
         if (elements > 3)
-            ret.w_ = (float)strtod(ptr, &ptr);
+            ret.w_ = (float)ParseDouble(ptr, &ptr);
 
         return ret;
     }
@@ -486,15 +847,15 @@ Matrix3 ToMatrix3(const char* source)
         return ret;
 
     auto* ptr = (char*)source;
-    ret.m00_ = (float)strtod(ptr, &ptr);
-    ret.m01_ = (float)strtod(ptr, &ptr);
-    ret.m02_ = (float)strtod(ptr, &ptr);
-    ret.m10_ = (float)strtod(ptr, &ptr);
-    ret.m11_ = (float)strtod(ptr, &ptr);
-    ret.m12_ = (float)strtod(ptr, &ptr);
-    ret.m20_ = (float)strtod(ptr, &ptr);
-    ret.m21_ = (float)strtod(ptr, &ptr);
-    ret.m22_ = (float)strtod(ptr, &ptr);
+    ret.m00_ = (float)ParseDouble(ptr, &ptr);
+    ret.m01_ = (float)ParseDouble(ptr, &ptr);
+    ret.m02_ = (float)ParseDouble(ptr, &ptr);
+    ret.m10_ = (float)ParseDouble(ptr, &ptr);
+    ret.m11_ = (float)ParseDouble(ptr, &ptr);
+    ret.m12_ = (float)ParseDouble(ptr, &ptr);
+    ret.m20_ = (float)ParseDouble(ptr, &ptr);
+    ret.m21_ = (float)ParseDouble(ptr, &ptr);
+    ret.m22_ = (float)ParseDouble(ptr, &ptr);
 
     return ret;
 }
@@ -513,18 +874,18 @@ Matrix3x4 ToMatrix3x4(const char* source)
         return ret;
 
     auto* ptr = (char*)source;
-    ret.m00_ = (float)strtod(ptr, &ptr);
-    ret.m01_ = (float)strtod(ptr, &ptr);
-    ret.m02_ = (float)strtod(ptr, &ptr);
-    ret.m03_ = (float)strtod(ptr, &ptr);
-    ret.m10_ = (float)strtod(ptr, &ptr);
-    ret.m11_ = (float)strtod(ptr, &ptr);
-    ret.m12_ = (float)strtod(ptr, &ptr);
-    ret.m13_ = (float)strtod(ptr, &ptr);
-    ret.m20_ = (float)strtod(ptr, &ptr);
-    ret.m21_ = (float)strtod(ptr, &ptr);
-    ret.m22_ = (float)strtod(ptr, &ptr);
-    ret.m23_ = (float)strtod(ptr, &ptr);
+    ret.m00_ = (float)ParseDouble(ptr, &ptr);
+    ret.m01_ = (float)ParseDouble(ptr, &ptr);
+    ret.m02_ = (float)ParseDouble(ptr, &ptr);
+    ret.m03_ = (float)ParseDouble(ptr, &ptr);
+    ret.m10_ = (float)ParseDouble(ptr, &ptr);
+    ret.m11_ = (float)ParseDouble(ptr, &ptr);
+    ret.m12_ = (float)ParseDouble(ptr, &ptr);
+    ret.m13_ = (float)ParseDouble(ptr, &ptr);
+    ret.m20_ = (float)ParseDouble(ptr, &ptr);
+    ret.m21_ = (float)ParseDouble(ptr, &ptr);
+    ret.m22_ = (float)ParseDouble(ptr, &ptr);
+    ret.m23_ = (float)ParseDouble(ptr, &ptr);
 
     return ret;
 }
@@ -543,22 +904,22 @@ Matrix4 ToMatrix4(const char* source)
         return ret;
 
     auto* ptr = (char*)source;
-    ret.m00_ = (float)strtod(ptr, &ptr);
-    ret.m01_ = (float)strtod(ptr, &ptr);
-    ret.m02_ = (float)strtod(ptr, &ptr);
-    ret.m03_ = (float)strtod(ptr, &ptr);
-    ret.m10_ = (float)strtod(ptr, &ptr);
-    ret.m11_ = (float)strtod(ptr, &ptr);
-    ret.m12_ = (float)strtod(ptr, &ptr);
-    ret.m13_ = (float)strtod(ptr, &ptr);
-    ret.m20_ = (float)strtod(ptr, &ptr);
-    ret.m21_ = (float)strtod(ptr, &ptr);
-    ret.m22_ = (float)strtod(ptr, &ptr);
-    ret.m23_ = (float)strtod(ptr, &ptr);
-    ret.m30_ = (float)strtod(ptr, &ptr);
-    ret.m31_ = (float)strtod(ptr, &ptr);
-    ret.m32_ = (float)strtod(ptr, &ptr);
-    ret.m33_ = (float)strtod(ptr, &ptr);
+    ret.m00_ = (float)ParseDouble(ptr, &ptr);
+    ret.m01_ = (float)ParseDouble(ptr, &ptr);
+    ret.m02_ = (float)ParseDouble(ptr, &ptr);
+    ret.m03_ = (float)ParseDouble(ptr, &ptr);
+    ret.m10_ = (float)ParseDouble(ptr, &ptr);
+    ret.m11_ = (float)ParseDouble(ptr, &ptr);
+    ret.m12_ = (float)ParseDouble(ptr, &ptr);
+    ret.m13_ = (float)ParseDouble(ptr, &ptr);
+    ret.m20_ = (float)ParseDouble(ptr, &ptr);
+    ret.m21_ = (float)ParseDouble(ptr, &ptr);
+    ret.m22_ = (float)ParseDouble(ptr, &ptr);
+    ret.m23_ = (float)ParseDouble(ptr, &ptr);
+    ret.m30_ = (float)ParseDouble(ptr, &ptr);
+    ret.m31_ = (float)ParseDouble(ptr, &ptr);
+    ret.m32_ = (float)ParseDouble(ptr, &ptr);
+    ret.m33_ = (float)ParseDouble(ptr, &ptr);
 
     return ret;
 }
@@ -39,6 +39,16 @@ URHO3D_API float ToFloat(const char* source);
 URHO3D_API double ToDouble(const String& source);
 /// Parse a double from a C string.
 URHO3D_API double ToDouble(const char* source);
+/// Parse a double from a C string like strtod, but always using '.' as the decimal separator regardless of the C locale. Optionally return a pointer to the first character after the number.
+URHO3D_API double ParseDouble(const char* source, char** end = nullptr);
+/// Write the shortest decimal representation of a float that parses back to the same value, regardless of the C locale. The destination must hold at least FLOAT_CONVERSION_LENGTH characters. Return the length without the null terminator.
+URHO3D_API unsigned FormatFloat(char* dest, float value);
+/// Write space-separated shortest decimal representations of floats. The destination must hold at least count * FLOAT_CONVERSION_LENGTH characters. Return the length without the null terminator.
+URHO3D_API unsigned FormatFloats(char* dest, const float* values, unsigned count);
+/// Write a signed integer in decimal. Return the length without the null terminator.
+URHO3D_API unsigned FormatInt(char* dest, long long value);
+/// Write an unsigned integer in decimal. Return the length without the null terminator.
+URHO3D_API unsigned FormatUInt(char* dest, unsigned long long value);
 /// Parse an integer from a string. Assumed to be decimal by default (base 10). Use base 0 to autodetect from string.
 URHO3D_API int ToInt(const String& source, int base = 10);
 /// Parse an integer from a C string. Assumed to be decimal by default (base 10). Use base 0 to autodetect from string.
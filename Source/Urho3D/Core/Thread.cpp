@@ -29,6 +29,9 @@
 #else
 #include <pthread.h>
 #endif
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#include <sched.h>
+#endif
 
 #include "../DebugNew.h"
 
@@ -36,11 +39,24 @@ namespace Urho3D
 {
 
 #ifdef URHO3D_THREADING
+
+static void InitThread(Thread* thread)
+{
+    if (!thread->GetThreadName().Empty())
+        Thread::SetCurrentThreadName(thread->GetThreadName());
+    if (!thread->GetThreadAffinity().Empty())
+        Thread::SetCurrentThreadAffinity(thread->GetThreadAffinity());
+}
+
 #ifdef _WIN32
 
+/// SetThreadDescription function, only available since Windows 10.
+using SetThreadDescriptionFunction = HRESULT (WINAPI*)(HANDLE, PCWSTR);
+
 static DWORD WINAPI ThreadFunctionStatic(void* data)
 {
     Thread* thread = static_cast<Thread*>(data);
+    InitThread(thread);
     thread->ThreadFunction();
     return 0;
 }
@@ -50,6 +66,7 @@ static DWORD WINAPI ThreadFunctionStatic(void* data)
 static void* ThreadFunctionStatic(void* data)
 {
     auto* thread = static_cast<Thread*>(data);
+    InitThread(thread);
     thread->ThreadFunction();
     pthread_exit((void*)nullptr);
     return nullptr;
@@ -129,6 +146,56 @@ void Thread::SetPriority(int priority)
 #endif // URHO3D_THREADING
 }
 
+void Thread::SetCurrentThreadName(const String& name)
+{
+#ifdef URHO3D_THREADING
+#ifdef _WIN32
+    auto setThreadDescription = (SetThreadDescriptionFunction)GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription");
+    if (setThreadDescription)
+        setThreadDescription(GetCurrentThread(), WString(name).CString());
+#elif defined(__APPLE__)
+    pthread_setname_np(name.CString());
+#elif defined(__linux__) && !defined(__EMSCRIPTEN__)
+    // Linux limits the name to 16 bytes including the terminator
+    pthread_setname_np(pthread_self(), name.Substring(0, 15).CString());
+#endif
+#endif // URHO3D_THREADING
+}
+
+bool Thread::SetCurrentThreadAffinity(const PODVector<unsigned>& cpus)
+{
+#ifdef URHO3D_THREADING
+#ifdef _WIN32
+    // Only the first processor group of 64 logical CPUs is supported
+    DWORD_PTR mask = 0;
+    for (unsigned i = 0; i < cpus.Size(); ++i)
+    {
+        if (cpus[i] < sizeof(DWORD_PTR) * 8)
+            mask |= (DWORD_PTR)1 << cpus[i];
+    }
+    return mask && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__) && !defined(__EMSCRIPTEN__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    bool anySet = false;
+    for (unsigned i = 0; i < cpus.Size(); ++i)
+    {
+        if (cpus[i] < CPU_SETSIZE)
+        {
+            CPU_SET(cpus[i], &set);
+            anySet = true;
+        }
+    }
+    return anySet && sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    // Not supported, for example Apple platforms only take affinity hints
+    return false;
+#endif
+#else
+    return false;
+#endif // URHO3D_THREADING
+}
+
 void Thread::SetMainThread()
 {
     mainThreadID = GetCurrentThreadID();
@@ -22,11 +22,7 @@
 
 #pragma once
 
-#ifdef URHO3D_IS_BUILDING
-#include "Urho3D.h"
-#else
-#include <Urho3D/Urho3D.h>
-#endif
+#include "../Container/Str.h"
 
 #ifndef _WIN32
 #include <pthread.h>
@@ -56,10 +52,22 @@ public:
     void Stop();
     /// Set thread priority. The thread must have been started first.
     void SetPriority(int priority);
+    /// Set the name shown by debuggers and tools such as top and perf. Takes effect when the thread is started. Truncated to 15 characters on Linux.
+    void SetThreadName(const String& name) { threadName_ = name; }
+    /// Set the logical CPUs the thread may run on, or empty to allow all (default). Takes effect when the thread is started.
+    void SetThreadAffinity(const PODVector<unsigned>& cpus) { threadAffinity_ = cpus; }
 
     /// Return whether thread exists.
     bool IsStarted() const { return handle_ != nullptr; }
+    /// Return the name.
+    const String& GetThreadName() const { return threadName_; }
+    /// Return the logical CPUs the thread may run on. Empty if not restricted.
+    const PODVector<unsigned>& GetThreadAffinity() const { return threadAffinity_; }
 
+    /// Set the name of the calling thread.
+    static void SetCurrentThreadName(const String& name);
+    /// Restrict the calling thread to the logical CPUs. On Linux, threads it creates afterward inherit the restriction. Return true if successful.
+    static bool SetCurrentThreadAffinity(const PODVector<unsigned>& cpus);
     /// Set the current thread as the main thread.
     static void SetMainThread();
     /// Return the current thread's ID.
@@ -72,6 +80,10 @@ protected:
     void* handle_;
     /// Running flag.
     volatile bool shouldRun_;
+    /// Name.
+    String threadName_;
+    /// Logical CPUs the thread may run on.
+    PODVector<unsigned> threadAffinity_;
 
     /// Main thread's thread ID.
     static ThreadID mainThreadID;
@@ -140,6 +140,58 @@ Variant& Variant::operator =(const Variant& rhs)
     return *this;
 }
 
+Variant& Variant::operator =(Variant&& rhs) noexcept
+{
+    if (&rhs == this)
+        return *this;
+
+    switch (rhs.GetType())
+    {
+    case VAR_STRING:
+        SetType(VAR_STRING);
+        value_.string_ = std::move(rhs.value_.string_);
+        break;
+
+    case VAR_BUFFER:
+        SetType(VAR_BUFFER);
+        value_.buffer_ = std::move(rhs.value_.buffer_);
+        break;
+
+    case VAR_RESOURCEREF:
+        SetType(VAR_RESOURCEREF);
+        value_.resourceRef_.type_ = rhs.value_.resourceRef_.type_;
+        value_.resourceRef_.name_ = std::move(rhs.value_.resourceRef_.name_);
+        break;
+
+    case VAR_RESOURCEREFLIST:
+        SetType(VAR_RESOURCEREFLIST);
+        value_.resourceRefList_.type_ = rhs.value_.resourceRefList_.type_;
+        value_.resourceRefList_.names_ = std::move(rhs.value_.resourceRefList_.names_);
+        break;
+
+    case VAR_VARIANTVECTOR:
+        SetType(VAR_VARIANTVECTOR);
+        value_.variantVector_ = std::move(rhs.value_.variantVector_);
+        break;
+
+    case VAR_STRINGVECTOR:
+        SetType(VAR_STRINGVECTOR);
+        value_.stringVector_ = std::move(rhs.value_.stringVector_);
+        break;
+
+    case VAR_VARIANTMAP:
+        SetType(VAR_VARIANTMAP);
+        value_.variantMap_ = std::move(rhs.value_.variantMap_);
+        break;
+
+    default:
+        *this = static_cast<const Variant&>(rhs);
+        break;
+    }
+
+    return *this;
+}
+
 Variant& Variant::operator =(const VectorBuffer& rhs)
 {
     SetType(VAR_BUFFER);
@@ -550,6 +550,12 @@ public:
         *this = value;
     }
 
+    /// Move-construct from another variant.
+    Variant(Variant&& value) noexcept
+    {
+        *this = std::move(value);
+    }
+
     /// Destruct.
     ~Variant()
     {
@@ -564,6 +570,8 @@ public:
 
     /// Assign from another variant.
     Variant& operator =(const Variant& rhs);
+    /// Move-assign from another variant. Values that allocate memory are moved, others are copied.
+    Variant& operator =(Variant&& rhs) noexcept;
 
     /// Assign from an integer.
     Variant& operator =(int rhs)
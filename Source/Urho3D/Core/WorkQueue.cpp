@@ -31,6 +31,9 @@
 namespace Urho3D
 {
 
+/// Number of work items per thread when splitting a range, so that threads which finish early can steal the rest.
+static const unsigned WORK_ITEMS_PER_THREAD = 4;
+
 /// Worker thread managed by the work queue.
 class WorkerThread : public Thread, public RefCounted
 {
@@ -40,6 +43,7 @@ public:
         owner_(owner),
         index_(index)
     {
+        SetThreadName(ToString("Worker %u", index));
     }
 
     /// Process work items until stopped.
@@ -60,8 +64,64 @@ private:
     unsigned index_;
 };
 
+/// Work item deque owned by one thread. The owner takes items from it, while idle threads may steal from it.
+struct WorkItemDeque
+{
+    /// Insert an item, keeping the deque sorted by descending priority.
+    void Push(WorkItem* item)
+    {
+        MutexLock lock(mutex_);
+
+        List<WorkItem*>::Iterator i = items_.Begin();
+        while (i != items_.End() && (*i)->priority_ > item->priority_)
+            ++i;
+        items_.Insert(i, item);
+        size_ = items_.Size();
+    }
+
+    /// Take the front item if it has at least the specified priority. Return null if not available.
+    WorkItem* Pop(unsigned priority)
+    {
+        // Check the size first to avoid locking empty deques while stealing
+        if (!size_)
+            return nullptr;
+
+        MutexLock lock(mutex_);
+
+        if (items_.Empty() || items_.Front()->priority_ < priority)
+            return nullptr;
+
+        WorkItem* item = items_.Front();
+        items_.PopFront();
+        size_ = items_.Size();
+        return item;
+    }
+
+    /// Remove an item if it has not been taken yet. Return true if successfully removed.
+    bool Remove(WorkItem* item)
+    {
+        MutexLock lock(mutex_);
+
+        List<WorkItem*>::Iterator i = items_.Find(item);
+        if (i == items_.End())
+            return false;
+
+        items_.Erase(i);
+        size_ = items_.Size();
+        return true;
+    }
+
+    /// Prioritized work items.
+    List<WorkItem*> items_;
+    /// Number of items, readable without locking.
+    std::atomic<unsigned> size_{};
+    /// Deque mutex. Only contended by the owner, the main thread when adding work, and stealing threads.
+    Mutex mutex_;
+};
+
 WorkQueue::WorkQueue(Context* context) :
     Object(context),
+    nextDeque_(0),
     shutDown_(false),
     pausing_(false),
     paused_(false),
@@ -70,6 +130,9 @@ WorkQueue::WorkQueue(Context* context) :
     lastSize_(0),
     maxNonThreadedWorkMs_(5)
 {
+    // The main thread deque is used when there are no worker threads
+    deques_.Push(new WorkItemDeque());
+
     SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(WorkQueue, HandleBeginFrame));
 }
 
@@ -81,9 +144,22 @@ WorkQueue::~WorkQueue()
 
     for (unsigned i = 0; i < threads_.Size(); ++i)
         threads_[i]->Stop();
+
+    for (unsigned i = 0; i < deques_.Size(); ++i)
+        delete deques_[i];
 }
 
 void WorkQueue::CreateThreads(unsigned numThreads)
+{
+    CreateThreadsInternal(numThreads, PODVector<unsigned>());
+}
+
+void WorkQueue::CreateThreads(const PODVector<unsigned>& cpus)
+{
+    CreateThreadsInternal(cpus.Size(), cpus);
+}
+
+void WorkQueue::CreateThreadsInternal(unsigned numThreads, const PODVector<unsigned>& cpus)
 {
 #ifdef URHO3D_THREADING
     // Other subsystems may initialize themselves according to the number of threads.
@@ -94,9 +170,19 @@ void WorkQueue::CreateThreads(unsigned numThreads)
     // Start threads in paused mode
     Pause();
 
+    // Create the deques before any thread starts stealing from them
+    for (unsigned i = 0; i < numThreads; ++i)
+        deques_.Push(new WorkItemDeque());
+
     for (unsigned i = 0; i < numThreads; ++i)
     {
         SharedPtr<WorkerThread> thread(new WorkerThread(this, i + 1));
+        if (!cpus.Empty())
+        {
+            PODVector<unsigned> affinity;
+            affinity.Push(cpus[i]);
+            thread->SetThreadAffinity(affinity);
+        }
         thread->Run();
         threads_.Push(thread);
     }
@@ -137,57 +223,71 @@ void WorkQueue::AddWorkItem(const SharedPtr<WorkItem>& item)
     // Clear completed flag in case item is reused
     workItems_.Push(item);
     item->completed_ = false;
+    item->queued_ = true;
 
-    // Make sure worker threads' list is safe to modify
-    if (threads_.Size() && !paused_)
-        queueMutex_.Acquire();
+    // Release the count held until the item is added. If dependencies are still running, the last one to complete queues the item
+    if (--item->pendingDependencies_)
+        return;
 
-    // Find position for new item
-    if (queue_.Empty())
-        queue_.Push(item);
-    else
+    // Distribute items to the worker deques in round-robin fashion. Idle workers will steal to balance the load
+    if (threads_.Size())
     {
-        bool inserted = false;
+        nextDeque_ = nextDeque_ % threads_.Size() + 1;
+        deques_[nextDeque_]->Push(item);
+        Resume();
+    }
+    else
+        deques_[0]->Push(item);
+}
 
-        for (List<WorkItem*>::Iterator i = queue_.Begin(); i != queue_.End(); ++i)
-        {
-            if ((*i)->priority_ <= item->priority_)
-            {
-                queue_.Insert(i, item);
-                inserted = true;
-                break;
-            }
-        }
+void WorkQueue::AddDependency(const SharedPtr<WorkItem>& item, const SharedPtr<WorkItem>& dependency)
+{
+    if (!item || !dependency || item == dependency)
+    {
+        URHO3D_LOGERROR("Invalid work item dependency");
+        return;
+    }
 
-        if (!inserted)
-            queue_.Push(item);
+    if (item->queued_)
+    {
+        URHO3D_LOGERROR("Can not add dependency to a work item that has already been added");
+        return;
     }
 
-    if (threads_.Size())
+    // The dependents of an added item may be accessed by a worker thread at any time. A dependency that has already completed
+    // in this submission does not need to be waited on. The completed flag of an item that is not added is left over from its
+    // previous submission, so it is waited on when added again
+    if (dependency->queued_)
     {
-        queueMutex_.Release();
-        paused_ = false;
+        if (!dependency->completed_)
+            URHO3D_LOGERROR("Can not add dependency on a work item that has already been added");
+        return;
     }
+
+    // Lower priority dependencies could be left unexecuted when completing the higher priority work
+    assert(dependency->priority_ >= item->priority_);
+
+    dependency->dependents_.Push(item.Get());
+    ++item->pendingDependencies_;
 }
 
 bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
 {
-    if (!item)
+    if (!item || item->pendingDependencies_ || !item->dependents_.Empty())
         return false;
 
-    MutexLock lock(queueMutex_);
-
     // Can only remove successfully if the item was not yet taken by threads for execution
-    List<WorkItem*>::Iterator i = queue_.Find(item.Get());
-    if (i != queue_.End())
+    List<SharedPtr<WorkItem> >::Iterator j = workItems_.Find(item);
+    if (j != workItems_.End())
     {
-        List<SharedPtr<WorkItem> >::Iterator j = workItems_.Find(item);
-        if (j != workItems_.End())
+        for (unsigned i = 0; i < deques_.Size(); ++i)
         {
-            queue_.Erase(i);
-            ReturnToPool(item);
-            workItems_.Erase(j);
-            return true;
+            if (deques_[i]->Remove(item.Get()))
+            {
+                ReturnToPool(item);
+                workItems_.Erase(j);
+                return true;
+            }
         }
     }
 
@@ -196,23 +296,12 @@ bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
 
 unsigned WorkQueue::RemoveWorkItems(const Vector<SharedPtr<WorkItem> >& items)
 {
-    MutexLock lock(queueMutex_);
     unsigned removed = 0;
 
     for (Vector<SharedPtr<WorkItem> >::ConstIterator i = items.Begin(); i != items.End(); ++i)
     {
-        List<WorkItem*>::Iterator j = queue_.Find(i->Get());
-        if (j != queue_.End())
-        {
-            List<SharedPtr<WorkItem> >::Iterator k = workItems_.Find(*i);
-            if (k != workItems_.End())
-            {
-                queue_.Erase(j);
-                ReturnToPool(*k);
-                workItems_.Erase(k);
-                ++removed;
-            }
-        }
+        if (RemoveWorkItem(*i))
+            ++removed;
     }
 
     return removed;
@@ -250,49 +339,53 @@ void WorkQueue::Complete(unsigned priority)
         Resume();
 
         // Take work items also in the main thread until queue empty or no high-priority items anymore
-        while (!queue_.Empty())
-        {
-            queueMutex_.Acquire();
-            if (!queue_.Empty() && queue_.Front()->priority_ >= priority)
-            {
-                WorkItem* item = queue_.Front();
-                queue_.PopFront();
-                queueMutex_.Release();
-                item->workFunction_(item, 0);
-                item->completed_ = true;
-            }
-            else
-            {
-                queueMutex_.Release();
-                break;
-            }
-        }
+        while (WorkItem* item = PopWorkItem(0, priority))
+            ExecuteItem(item, 0);
 
-        // Wait for threaded work to complete
+        // Wait for threaded work to complete. Help with items whose dependencies completed in the meanwhile
         while (!IsCompleted(priority))
         {
+            if (WorkItem* item = PopWorkItem(0, priority))
+                ExecuteItem(item, 0);
         }
 
         // If no work at all remaining, pause worker threads by leaving the mutex locked
-        if (queue_.Empty())
+        if (!HasQueuedItems())
             Pause();
     }
     else
     {
         // No worker threads: ensure all high-priority items are completed in the main thread
-        while (!queue_.Empty() && queue_.Front()->priority_ >= priority)
-        {
-            WorkItem* item = queue_.Front();
-            queue_.PopFront();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
-        }
+        while (WorkItem* item = PopWorkItem(0, priority))
+            ExecuteItem(item, 0);
     }
 
     PurgeCompleted(priority);
     completing_ = false;
 }
 
+void WorkQueue::AddRangeWorkItemsInternal(void* begin, unsigned count, unsigned elementSize,
+    void (*workFunction)(const WorkItem*, unsigned), void* aux, unsigned minGrainSize, unsigned priority)
+{
+    if (!count)
+        return;
+
+    unsigned maxItems = threads_.Size() ? (threads_.Size() + 1) * WORK_ITEMS_PER_THREAD : 1;
+    unsigned numItems = Clamp(count / Max(minGrainSize, 1U), 1U, maxItems);
+    auto* start = static_cast<unsigned char*>(begin);
+
+    for (unsigned i = 0; i < numItems; ++i)
+    {
+        SharedPtr<WorkItem> item = GetFreeItem();
+        item->priority_ = priority;
+        item->workFunction_ = workFunction;
+        item->aux_ = aux;
+        item->start_ = start + (size_t)count * i / numItems * elementSize;
+        item->end_ = start + (size_t)count * (i + 1) / numItems * elementSize;
+        AddWorkItem(item);
+    }
+}
+
 bool WorkQueue::IsCompleted(unsigned priority) const
 {
     for (List<SharedPtr<WorkItem> >::ConstIterator i = workItems_.Begin(); i != workItems_.End(); ++i)
@@ -317,21 +410,19 @@ void WorkQueue::ProcessItems(unsigned threadIndex)
             Time::Sleep(0);
         else
         {
-            queueMutex_.Acquire();
-            if (!queue_.Empty())
+            WorkItem* item = PopWorkItem(threadIndex, 0);
+            if (item)
             {
                 wasActive = true;
 
-                WorkItem* item = queue_.Front();
-                queue_.PopFront();
-                queueMutex_.Release();
-                item->workFunction_(item, threadIndex);
-                item->completed_ = true;
+                ExecuteItem(item, threadIndex);
             }
             else
             {
                 wasActive = false;
 
+                // Block here while the main thread holds the pause mutex
+                queueMutex_.Acquire();
                 queueMutex_.Release();
                 Time::Sleep(0);
             }
@@ -339,6 +430,45 @@ void WorkQueue::ProcessItems(unsigned threadIndex)
     }
 }
 
+void WorkQueue::ExecuteItem(WorkItem* item, unsigned threadIndex)
+{
+    item->workFunction_(item, threadIndex);
+
+    // Queue the dependents to this thread's own deque before signaling completion, so that waiting for completion can not
+    // miss them. The dependents list is not modified while the item is queued, so no locking is needed
+    for (PODVector<WorkItem*>::ConstIterator i = item->dependents_.Begin(); i != item->dependents_.End(); ++i)
+    {
+        if (--(*i)->pendingDependencies_ == 0)
+            deques_[threadIndex]->Push(*i);
+    }
+
+    item->completed_ = true;
+}
+
+WorkItem* WorkQueue::PopWorkItem(unsigned threadIndex, unsigned priority)
+{
+    // Own deque first, then steal from the others starting from the next thread so that thieves spread out
+    unsigned numDeques = deques_.Size();
+    for (unsigned i = 0; i < numDeques; ++i)
+    {
+        if (WorkItem* item = deques_[(threadIndex + i) % numDeques]->Pop(priority))
+            return item;
+    }
+
+    return nullptr;
+}
+
+bool WorkQueue::HasQueuedItems() const
+{
+    for (unsigned i = 0; i < deques_.Size(); ++i)
+    {
+        if (deques_[i]->size_)
+            return true;
+    }
+
+    return false;
+}
+
 void WorkQueue::PurgeCompleted(unsigned priority)
 {
     // Purge completed work items and send completion events. Do not signal items lower than priority threshold,
@@ -379,6 +509,11 @@ void WorkQueue::PurgePool()
 
 void WorkQueue::ReturnToPool(SharedPtr<WorkItem>& item)
 {
+    // Dependencies are declared again each time an item is added
+    item->pendingDependencies_ = 1;
+    item->dependents_.Clear();
+    item->queued_ = false;
+
     // Check if this was a pooled item and set it to usable
     if (item->pooled_)
     {
@@ -401,18 +536,19 @@ void WorkQueue::ReturnToPool(SharedPtr<WorkItem>& item)
 void WorkQueue::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
     // If no worker threads, complete low-priority work here
-    if (threads_.Empty() && !queue_.Empty())
+    if (threads_.Empty() && HasQueuedItems())
     {
         URHO3D_PROFILE(CompleteWorkNonthreaded);
 
         HiresTimer timer;
 
-        while (!queue_.Empty() && timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
+        while (timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
         {
-            WorkItem* item = queue_.Front();
-            queue_.PopFront();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
+            WorkItem* item = PopWorkItem(0, 0);
+            if (!item)
+                break;
+
+            ExecuteItem(item, 0);
         }
     }
 
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "../Container/List.h"
+#include "../Container/Sort.h"
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
 
@@ -38,6 +39,10 @@ URHO3D_EVENT(E_WORKITEMCOMPLETED, WorkItemCompleted)
 }
 
 class WorkerThread;
+struct WorkItemDeque;
+
+/// Minimum number of elements per chunk in a parallel sort.
+static const unsigned MIN_PARALLEL_SORT_CHUNK = 1024;
 
 /// Work queue item.
 struct WorkItem : public RefCounted
@@ -62,8 +67,45 @@ public:
 
 private:
     bool pooled_{};
+    /// Whether has been added to the work queue and not yet purged.
+    bool queued_{};
+    /// Number of dependencies that have not completed yet, plus one until the item is added. The item is queued for execution by whichever decrement reaches zero.
+    std::atomic<unsigned> pendingDependencies_{1};
+    /// Items which depend on this item.
+    PODVector<WorkItem*> dependents_;
 };
 
+/// Parallel sort pass: either sort a chunk, or merge two sorted consecutive chunks.
+template <class T, class U> struct ParallelSortTask
+{
+    /// Range start.
+    RandomAccessIterator<T> begin_;
+    /// Start of the second sorted chunk when merging. Equal to the range end when sorting.
+    RandomAccessIterator<T> middle_;
+    /// Range end.
+    RandomAccessIterator<T> end_;
+    /// Temporary buffer position corresponding to the range start.
+    RandomAccessIterator<T> buffer_;
+    /// Compare function.
+    U* compare_;
+};
+
+/// Parallel sort work function.
+template <class T, class U> void ParallelSortWork(const WorkItem* item, unsigned /*threadIndex*/)
+{
+    auto* task = reinterpret_cast<ParallelSortTask<T, U>*>(item->start_);
+
+    if (task->middle_ == task->end_)
+        Sort(task->begin_, task->end_, *task->compare_);
+    else
+    {
+        Merge(task->begin_, task->middle_, task->end_, task->buffer_, *task->compare_);
+        RandomAccessIterator<T> src = task->buffer_;
+        for (RandomAccessIterator<T> dest = task->begin_; dest != task->end_; ++dest, ++src)
+            *dest = *src;
+    }
+}
+
 /// Work queue subsystem for multithreading.
 class URHO3D_API WorkQueue : public Object
 {
@@ -79,11 +121,15 @@ public:
 
     /// Create worker threads. Can only be called once.
     void CreateThreads(unsigned numThreads);
+    /// Create one worker thread pinned to each of the logical CPUs. Can only be called once.
+    void CreateThreads(const PODVector<unsigned>& cpus);
     /// Get pointer to an usable WorkItem from the item pool. Allocate one if no more free items.
     SharedPtr<WorkItem> GetFreeItem();
-    /// Add a work item and resume worker threads.
+    /// Add a work item and resume worker threads. If the item has dependencies, it will be queued for execution once they have all completed.
     void AddWorkItem(const SharedPtr<WorkItem>& item);
-    /// Remove a work item before it has started executing. Return true if successfully removed.
+    /// Declare that a work item can start executing only after another item has completed. Must be called before the item is added, and before the dependency is added unless it has already completed, in which case the dependency is ignored. The dependency must have at least the same priority as the item.
+    void AddDependency(const SharedPtr<WorkItem>& item, const SharedPtr<WorkItem>& dependency);
+    /// Remove a work item before it has started executing. Items with dependencies or dependents can not be removed. Return true if successfully removed.
     bool RemoveWorkItem(SharedPtr<WorkItem> item);
     /// Remove a number of work items before they have started executing. Return the number of items successfully removed.
     unsigned RemoveWorkItems(const Vector<SharedPtr<WorkItem> >& items);
@@ -94,6 +140,79 @@ public:
     /// Finish all queued work which has at least the specified priority. Main thread will also execute priority work. Pause worker threads if no more work remains.
     void Complete(unsigned priority);
 
+    /// Split a range of elements into work items for the work function, which receives a subrange in start_ and end_. Several items are created per thread so that idle threads can steal work when the cost per element varies, but each item has at least minGrainSize elements. Call Complete() to finish the work.
+    template <class T> void AddRangeWorkItems(RandomAccessIterator<T> begin, RandomAccessIterator<T> end,
+        void (*workFunction)(const WorkItem*, unsigned), void* aux = nullptr, unsigned minGrainSize = 1, unsigned priority = M_MAX_UNSIGNED)
+    {
+        AddRangeWorkItemsInternal(begin.ptr_, (unsigned)(end - begin), sizeof(T), workFunction, aux, minGrainSize, priority);
+    }
+
+    /// Process a range of elements with the work function in the worker threads and the main thread, and wait for completion. Must be called from the main thread.
+    template <class T> void ParallelFor(RandomAccessIterator<T> begin, RandomAccessIterator<T> end,
+        void (*workFunction)(const WorkItem*, unsigned), void* aux = nullptr, unsigned minGrainSize = 1)
+    {
+        AddRangeWorkItems(begin, end, workFunction, aux, minGrainSize);
+        Complete(M_MAX_UNSIGNED);
+    }
+
+    /// Sort a range using a compare function. Chunks are sorted in the worker threads and then merged pairwise, each merge depending on the two chunks instead of waiting for a whole pass. Small ranges are sorted directly. Must be called from the main thread.
+    template <class T, class U> void ParallelSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end, U compare)
+    {
+        auto count = (unsigned)(end - begin);
+        unsigned numChunks = 1;
+        while (numChunks <= threads_.Size() && count / (numChunks * 2) >= MIN_PARALLEL_SORT_CHUNK)
+            numChunks *= 2;
+
+        if (numChunks == 1)
+        {
+            Sort(begin, end, compare);
+            return;
+        }
+
+        Vector<T> buffer(count);
+        PODVector<ParallelSortTask<T, U> > tasks(numChunks * 2 - 1);
+        Vector<SharedPtr<WorkItem> > items(numChunks * 2 - 1);
+
+        // Leaf tasks sort the chunks
+        for (unsigned i = 0; i < numChunks; ++i)
+        {
+            ParallelSortTask<T, U>& task = tasks[i];
+            task.begin_ = begin + (int)((unsigned long long)count * i / numChunks);
+            task.end_ = task.middle_ = begin + (int)((unsigned long long)count * (i + 1) / numChunks);
+        }
+
+        // Each merge task combines two consecutive tasks of the previous level, the last one the whole range
+        for (unsigned i = numChunks, j = 0; i < tasks.Size(); ++i, j += 2)
+        {
+            ParallelSortTask<T, U>& task = tasks[i];
+            task.begin_ = tasks[j].begin_;
+            task.middle_ = tasks[j].end_;
+            task.end_ = tasks[j + 1].end_;
+        }
+
+        for (unsigned i = 0; i < tasks.Size(); ++i)
+        {
+            tasks[i].buffer_ = buffer.Begin() + (tasks[i].begin_ - begin);
+            tasks[i].compare_ = &compare;
+
+            items[i] = GetFreeItem();
+            items[i]->priority_ = M_MAX_UNSIGNED;
+            items[i]->workFunction_ = ParallelSortWork<T, U>;
+            items[i]->start_ = &tasks[i];
+        }
+
+        for (unsigned i = numChunks, j = 0; i < tasks.Size(); ++i, j += 2)
+        {
+            AddDependency(items[i], items[j]);
+            AddDependency(items[i], items[j + 1]);
+        }
+
+        for (unsigned i = 0; i < items.Size(); ++i)
+            AddWorkItem(items[i]);
+
+        Complete(M_MAX_UNSIGNED);
+    }
+
     /// Set the pool telerance before it starts deleting pool items.
     void SetTolerance(int tolerance) { tolerance_ = tolerance; }
 
@@ -115,8 +234,19 @@ public:
     int GetNonThreadedWorkMs() const { return maxNonThreadedWorkMs_; }
 
 private:
+    /// Create worker threads, pinned to the logical CPUs if not empty.
+    void CreateThreadsInternal(unsigned numThreads, const PODVector<unsigned>& cpus);
     /// Process work items until shut down. Called by the worker threads.
     void ProcessItems(unsigned threadIndex);
+    /// Split a range of elements into work items and add them.
+    void AddRangeWorkItemsInternal(void* begin, unsigned count, unsigned elementSize, void (*workFunction)(const WorkItem*, unsigned),
+        void* aux, unsigned minGrainSize, unsigned priority);
+    /// Execute a work item, then queue its dependents whose dependencies have all completed.
+    void ExecuteItem(WorkItem* item, unsigned threadIndex);
+    /// Take the highest priority item from the thread's own deque, or steal one from the other deques. Only items with at least the specified priority are taken. Return null if none found.
+    WorkItem* PopWorkItem(unsigned threadIndex, unsigned priority);
+    /// Return whether any deque still has queued items.
+    bool HasQueuedItems() const;
     /// Purge completed work items which have at least the specified priority, and send completion events as necessary.
     void PurgeCompleted(unsigned priority);
     /// Purge the pool to reduce allocation where its unneeded.
@@ -132,15 +262,17 @@ private:
     List<SharedPtr<WorkItem> > poolItems_;
     /// Work item collection. Accessed only by the main thread.
     List<SharedPtr<WorkItem> > workItems_;
-    /// Work item prioritized queue for worker threads. Pointers are guaranteed to be valid (point to workItems).
-    List<WorkItem*> queue_;
-    /// Worker queue mutex.
+    /// Per-thread prioritized work item deques, indexed by thread index (0 = main thread). Pointers are guaranteed to be valid (point to workItems).
+    PODVector<WorkItemDeque*> deques_;
+    /// Index of the next worker deque to receive a work item.
+    unsigned nextDeque_;
+    /// Pause mutex. Held by the main thread while paused to prevent idle worker threads using up CPU time.
     Mutex queueMutex_;
     /// Shutting down flag.
     std::atomic<bool> shutDown_;
-    /// Pausing flag. Indicates the worker threads should not contend for the queue mutex.
+    /// Pausing flag. Indicates the worker threads should not contend for the pause mutex.
     std::atomic<bool> pausing_;
-    /// Paused flag. Indicates the queue mutex being locked to prevent worker threads using up CPU time.
+    /// Paused flag. Indicates the pause mutex being locked to prevent worker threads using up CPU time.
     bool paused_;
     /// Completing work in the main thread flag.
     bool completing_;
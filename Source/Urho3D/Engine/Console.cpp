@@ -312,9 +312,12 @@ bool Console::PopulateInterpreter()
     interpreters_->RemoveAllItems();
 
     EventReceiverGroup* group = context_->GetEventReceivers(E_CONSOLECOMMAND);
-    if (!group || group->receivers_.Empty())
+    if (!group)
         return false;
 
+    // Unsubscribed interpreters may have left holes
+    group->Compact();
+
     Vector<String> names;
     for (unsigned i = 0; i < group->receivers_.Size(); ++i)
     {
@@ -322,6 +325,8 @@ bool Console::PopulateInterpreter()
         if (receiver)
             names.Push(receiver->GetTypeName());
     }
+    if (names.Empty())
+        return false;
     Sort(names.Begin(), names.End());
 
     unsigned selection = M_MAX_UNSIGNED;
@@ -22,9 +22,11 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/AllocationTracker.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
 #include "../Core/EventProfiler.h"
+#include "../Core/FrameAllocator.h"
 #include "../Core/Context.h"
 #include "../Engine/DebugHud.h"
 #include "../Engine/Engine.h"
@@ -151,6 +153,21 @@ void DebugHud::Update()
             renderer->GetNumShadowMaps(true),
             renderer->GetNumOccluders(true));
 
+        auto* frameAllocator = GetSubsystem<FrameAllocator>();
+        if (frameAllocator)
+        {
+            stats.AppendWithFormat("\nFrame memory %u KB (peak %u KB)", (frameAllocator->GetLastFrameSize() + 1023) / 1024,
+                (frameAllocator->GetPeakFrameSize() + 1023) / 1024);
+        }
+
+        auto* allocationTracker = GetSubsystem<AllocationTracker>();
+        if (allocationTracker)
+        {
+            const AllocationStats& frameStats = allocationTracker->GetFrameStats();
+            stats.AppendWithFormat("\nAllocations %u (%u KB)", (unsigned)frameStats.count_,
+                (unsigned)((frameStats.bytes_ + 1023) / 1024));
+        }
+
         if (!appStats_.Empty())
         {
             stats.Append("\n");
@@ -202,7 +219,13 @@ void DebugHud::Update()
     }
 
     if (memoryText_->IsVisible())
-        memoryText_->SetText(GetSubsystem<ResourceCache>()->PrintMemoryUsage());
+    {
+        String memory = GetSubsystem<ResourceCache>()->PrintMemoryUsage();
+        auto* allocationTracker = GetSubsystem<AllocationTracker>();
+        if (allocationTracker)
+            memory += "\n" + allocationTracker->PrintReport();
+        memoryText_->SetText(memory);
+    }
 }
 
 void DebugHud::SetDefaultStyle(XMLFile* style)
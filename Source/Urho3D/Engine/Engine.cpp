@@ -23,10 +23,13 @@
 #include "../Precompiled.h"
 
 #include "../Audio/Audio.h"
+#include "../Core/AllocationTracker.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/EventProfiler.h"
+#include "../Core/FrameAllocator.h"
 #include "../Core/ProcessUtils.h"
+#include "../Core/Thread.h"
 #include "../Core/WorkQueue.h"
 #include "../Engine/Console.h"
 #include "../Engine/DebugHud.h"
@@ -35,6 +38,7 @@
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
 #include "../Input/Input.h"
+#include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../IO/PackageFile.h"
@@ -92,6 +96,31 @@ namespace Urho3D
 
 extern const char* logLevelPrefixes[];
 
+#ifdef URHO3D_THREADING
+/// Assign the logical CPUs of the first reserved physical cores to the main thread, and the given number of logical CPUs of each remaining physical core to worker threads.
+static void AssignThreadCPUs(PODVector<unsigned>& mainCPUs, PODVector<unsigned>& workerCPUs, unsigned reservedCores, unsigned threadsPerCore)
+{
+    PODVector<LogicalCPU> topology = GetCPUTopology();
+    unsigned coreIndex = 0;
+    unsigned threadsOnCore = 0;
+
+    for (unsigned i = 0; i < topology.Size(); ++i)
+    {
+        // The logical CPUs of a physical core are consecutive
+        if (i && (topology[i].core_ != topology[i - 1].core_ || topology[i].package_ != topology[i - 1].package_))
+        {
+            ++coreIndex;
+            threadsOnCore = 0;
+        }
+
+        if (coreIndex < reservedCores)
+            mainCPUs.Push(topology[i].index_);
+        else if (threadsOnCore++ < threadsPerCore)
+            workerCPUs.Push(topology[i].index_);
+    }
+}
+#endif
+
 Engine::Engine(Context* context) :
     Object(context),
     timeStep_(0.0f),
@@ -121,6 +150,10 @@ Engine::Engine(Context* context) :
     // Create subsystems which do not depend on engine initialization or startup parameters
     context_->RegisterSubsystem(new Time(context_));
     context_->RegisterSubsystem(new WorkQueue(context_));
+    context_->RegisterSubsystem(new FrameAllocator(context_));
+#ifdef URHO3D_TRACK_ALLOCATIONS
+    context_->RegisterSubsystem(new AllocationTracker(context_));
+#endif
 #ifdef URHO3D_PROFILING
     context_->RegisterSubsystem(new Profiler(context_));
 #endif
@@ -158,7 +191,13 @@ Engine::Engine(Context* context) :
     SubscribeToEvent(E_EXITREQUESTED, URHO3D_HANDLER(Engine, HandleExitRequested));
 }
 
-Engine::~Engine() = default;
+Engine::~Engine()
+{
+#ifdef URHO3D_PROFILING
+    if (!profilerCaptureFileName_.Empty())
+        SaveProfilerCapture(profilerCaptureFileName_);
+#endif
+}
 
 bool Engine::Initialize(const VariantMap& parameters)
 {
@@ -170,6 +209,12 @@ bool Engine::Initialize(const VariantMap& parameters)
     // Set headless mode
     headless_ = GetParameter(parameters, EP_HEADLESS, false).GetBool();
 
+#ifdef URHO3D_TRACK_ALLOCATIONS
+    // Without the debug HUD, report allocations to the log
+    if (headless_)
+        GetSubsystem<AllocationTracker>()->SetLogInterval(DEFAULT_ALLOCATION_LOG_INTERVAL);
+#endif
+
     // Register the rest of the subsystems
     if (!headless_)
     {
@@ -205,14 +250,45 @@ bool Engine::Initialize(const VariantMap& parameters)
         SetMaxFps(0);
 
     // Set amount of worker threads according to the available physical CPU cores. Using also hyperthreaded cores results in
-    // unpredictable extra synchronization overhead. Also reserve one core for the main thread
+    // unpredictable extra synchronization overhead, so by default one thread per physical core is created. Also reserve cores
+    // for the main thread and the threads it starts, such as audio
 #ifdef URHO3D_THREADING
-    unsigned numThreads = GetParameter(parameters, EP_WORKER_THREADS, true).GetBool() ? GetNumPhysicalCPUs() - 1 : 0;
-    if (numThreads)
+    if (GetParameter(parameters, EP_WORKER_THREADS, true).GetBool())
     {
-        GetSubsystem<WorkQueue>()->CreateThreads(numThreads);
+        auto* workQueue = GetSubsystem<WorkQueue>();
+        auto reservedCores = (unsigned)Max(GetParameter(parameters, EP_RESERVED_CORES, 1).GetInt(), 0);
+        auto threadsPerCore = (unsigned)Max(GetParameter(parameters, EP_WORKER_THREADS_PER_CORE, 1).GetInt(), 1);
+        bool pinned = false;
+
+        if (GetParameter(parameters, EP_THREAD_AFFINITY, false).GetBool())
+        {
+            PODVector<unsigned> mainCPUs;
+            PODVector<unsigned> workerCPUs;
+            AssignThreadCPUs(mainCPUs, workerCPUs, reservedCores, threadsPerCore);
+
+            // Pin the main thread before the audio thread is started, so that it inherits the reserved cores where supported
+            if (!mainCPUs.Empty() && !Thread::SetCurrentThreadAffinity(mainCPUs))
+                URHO3D_LOGWARNING("Could not set main thread affinity");
+            if (!workerCPUs.Empty())
+            {
+                workQueue->CreateThreads(workerCPUs);
+                pinned = true;
+            }
+            else if (mainCPUs.Empty())
+                URHO3D_LOGWARNING("CPU topology not available, worker threads are not pinned");
+        }
+
+        if (!pinned)
+        {
+            unsigned numCores = GetNumPhysicalCPUs();
+            threadsPerCore = Min(threadsPerCore, Max(GetNumLogicalCPUs() / Max(numCores, 1U), 1U));
+            if (numCores > reservedCores)
+                workQueue->CreateThreads((numCores - reservedCores) * threadsPerCore);
+        }
 
-        URHO3D_LOGINFOF("Created %u worker thread%s", numThreads, numThreads > 1 ? "s" : "");
+        unsigned numThreads = workQueue->GetNumThreads();
+        if (numThreads)
+            URHO3D_LOGINFOF("Created %u worker thread%s%s", numThreads, numThreads > 1 ? "s" : "", pinned ? " pinned to logical CPUs" : "");
     }
 #endif
 
@@ -310,6 +386,13 @@ bool Engine::Initialize(const VariantMap& parameters)
         context_->RegisterSubsystem(new EventProfiler(context_));
         EventProfiler::SetActive(true);
     }
+
+    // Capture the profiler timeline from startup and save it on exit, useful for headless runs
+    if (HasParameter(parameters, EP_PROFILER_CAPTURE))
+    {
+        profilerCaptureFileName_ = GetParameter(parameters, EP_PROFILER_CAPTURE).GetString();
+        GetSubsystem<Profiler>()->BeginCapture();
+    }
 #endif
     frameTimer_.Reset();
 
@@ -496,6 +579,9 @@ void Engine::RunFrame()
 
     time->BeginFrame(timeStep_);
 
+    // Deliver events posted from other threads (or deferred by the main thread) since the previous frame
+    context_->SendPostedEvents();
+
     // If pause when minimized -mode is in use, stop updates and audio as necessary
     if (pauseMinimized_ && input->IsMinimized())
     {
@@ -615,6 +701,31 @@ void Engine::DumpProfiler()
 #endif
 }
 
+bool Engine::SaveProfilerCapture(const String& fileName)
+{
+#ifdef URHO3D_PROFILING
+    auto* profiler = GetSubsystem<Profiler>();
+    if (!profiler)
+        return false;
+
+    profiler->EndCapture();
+
+    File file(context_, fileName, FILE_WRITE);
+    if (!file.IsOpen())
+        return false;
+
+    bool success = GetExtension(fileName) == ".json" ? profiler->SaveChromeTrace(file) : profiler->SaveCapture(file);
+    if (success)
+        URHO3D_LOGINFO("Saved profiler capture to " + fileName);
+    else
+        URHO3D_LOGERROR("Failed to save profiler capture to " + fileName);
+
+    return success;
+#else
+    return false;
+#endif
+}
+
 void Engine::DumpResources(bool dumpFileName)
 {
 #ifdef URHO3D_LOGGING
@@ -628,10 +739,10 @@ void Engine::DumpResources(bool dumpFileName)
         URHO3D_LOGRAW("Used resources:\n");
         for (HashMap<StringHash, ResourceGroup>::ConstIterator i = resourceGroups.Begin(); i != resourceGroups.End(); ++i)
         {
-            const HashMap<StringHash, SharedPtr<Resource> >& resources = i->second_.resources_;
+            const FlatHashMap<StringHash, SharedPtr<Resource> >& resources = i->second_.resources_;
             if (dumpFileName)
             {
-                for (HashMap<StringHash, SharedPtr<Resource> >::ConstIterator j = resources.Begin(); j != resources.End(); ++j)
+                for (FlatHashMap<StringHash, SharedPtr<Resource> >::ConstIterator j = resources.Begin(); j != resources.End(); ++j)
                     URHO3D_LOGRAW(j->second_->GetName() + "\n");
             }
         }
@@ -684,6 +795,7 @@ void Engine::DumpMemory()
 void Engine::Update()
 {
     URHO3D_PROFILE(Update);
+    URHO3D_ALLOCATION_SCOPE(Update);
 
     // Logic update event
     using namespace Update;
@@ -708,6 +820,7 @@ void Engine::Render()
         return;
 
     URHO3D_PROFILE(Render);
+    URHO3D_ALLOCATION_SCOPE(Render);
 
     // If device is lost, BeginFrame will fail and we skip rendering
     auto* graphics = GetSubsystem<Graphics>();
@@ -842,6 +955,18 @@ VariantMap Engine::ParseParameters(const Vector<String>& arguments)
                 ret[EP_LOW_QUALITY_SHADOWS] = true;
             else if (argument == "nothreads")
                 ret[EP_WORKER_THREADS] = false;
+            else if (argument == "threadspercore" && !value.Empty())
+            {
+                ret[EP_WORKER_THREADS_PER_CORE] = ToInt(value);
+                ++i;
+            }
+            else if (argument == "reservedcores" && !value.Empty())
+            {
+                ret[EP_RESERVED_CORES] = ToInt(value);
+                ++i;
+            }
+            else if (argument == "affinity")
+                ret[EP_THREAD_AFFINITY] = true;
             else if (argument == "v")
                 ret[EP_VSYNC] = true;
             else if (argument == "t")
@@ -923,6 +1048,11 @@ VariantMap Engine::ParseParameters(const Vector<String>& arguments)
                 ret[EP_DUMP_SHADERS] = value;
                 ++i;
             }
+            else if (argument == "pc" && !value.Empty())
+            {
+                ret[EP_PROFILER_CAPTURE] = value;
+                ++i;
+            }
             else if (argument == "mq" && !value.Empty())
             {
                 ret[EP_MATERIAL_QUALITY] = ToInt(value);
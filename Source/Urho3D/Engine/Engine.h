@@ -70,6 +70,8 @@ public:
     void Exit();
     /// Dump profiling information to the log.
     void DumpProfiler();
+    /// Save the timeline captured by the profiler to a file: Chrome Trace Event JSON if the extension is .json, otherwise the binary capture format. Return true if successful.
+    bool SaveProfilerCapture(const String& fileName);
     /// Dump information of all resources to the log.
     void DumpResources(bool dumpFileName = false);
     /// Dump information of all memory allocations to the log. Supported in MSVC debug mode only.
@@ -145,6 +147,10 @@ private:
 #ifdef URHO3D_TESTING
     /// Time out counter for testing.
     long long timeOut_;
+#endif
+#ifdef URHO3D_PROFILING
+    /// File to save the profiler capture to on exit.
+    String profilerCaptureFileName_;
 #endif
     /// Auto-exit flag.
     bool autoExit_;
@@ -46,8 +46,10 @@ static const String EP_MONITOR = "Monitor";
 static const String EP_MULTI_SAMPLE = "MultiSample";
 static const String EP_ORIENTATIONS = "Orientations";
 static const String EP_PACKAGE_CACHE_DIR = "PackageCacheDir";
+static const String EP_PROFILER_CAPTURE = "ProfilerCapture";
 static const String EP_RENDER_PATH = "RenderPath";
 static const String EP_REFRESH_RATE = "RefreshRate";
+static const String EP_RESERVED_CORES = "ReservedCores";
 static const String EP_RESOURCE_PACKAGES = "ResourcePackages";
 static const String EP_RESOURCE_PATHS = "ResourcePaths";
 static const String EP_RESOURCE_PREFIX_PATHS = "ResourcePrefixPaths";
@@ -61,6 +63,7 @@ static const String EP_SOUND_STEREO = "SoundStereo";
 static const String EP_TEXTURE_ANISOTROPY = "TextureAnisotropy";
 static const String EP_TEXTURE_FILTER_MODE = "TextureFilterMode";
 static const String EP_TEXTURE_QUALITY = "TextureQuality";
+static const String EP_THREAD_AFFINITY = "ThreadAffinity";
 static const String EP_TIME_OUT = "TimeOut";
 static const String EP_TOUCH_EMULATION = "TouchEmulation";
 static const String EP_TRIPLE_BUFFER = "TripleBuffer";
@@ -73,5 +76,6 @@ static const String EP_WINDOW_RESIZABLE = "WindowResizable";
 static const String EP_WINDOW_TITLE = "WindowTitle";
 static const String EP_WINDOW_WIDTH = "WindowWidth";
 static const String EP_WORKER_THREADS = "WorkerThreads";
+static const String EP_WORKER_THREADS_PER_CORE = "WorkerThreadsPerCore";
 
 }
@@ -38,6 +38,7 @@
 #include "../Graphics/Octree.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../IO/Log.h"
+#include "../Math/TransformArrays.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/ResourceEvents.h"
 #include "../Scene/Scene.h"
@@ -396,6 +397,7 @@ void AnimatedModel::SetModel(Model* model, bool createBones)
 
         // Reserve space for skinning matrices
         skinMatrices_.Resize(skeleton_.GetNumBones());
+        skinOffsetMatrices_.Resize(skeleton_.GetNumBones());
         SetGeometryBoneMappings();
 
         // Enable skinning in batches
@@ -911,6 +913,10 @@ void AnimatedModel::UpdateBoneBoundingBox()
         boneBoundingBox_.Clear();
         Matrix3x4 inverseNodeTransform = node_->GetWorldTransform().Inverse();
 
+        // Gather the hitboxes to transform them in one batch
+        SmallVector<BoundingBox, 32> hitBoxes;
+        SmallPODVector<Matrix3x4, 32> hitBoxTransforms;
+
         const Vector<Bone>& bones = skeleton_.GetBones();
         for (Vector<Bone>::ConstIterator i = bones.Begin(); i != bones.End(); ++i)
         {
@@ -921,10 +927,21 @@ void AnimatedModel::UpdateBoneBoundingBox()
             // Use hitbox if available. If not, use only half of the sphere radius
             /// \todo The sphere radius should be multiplied with bone scale
             if (i->collisionMask_ & BONECOLLISION_BOX)
-                boneBoundingBox_.Merge(i->boundingBox_.Transformed(inverseNodeTransform * boneNode->GetWorldTransform()));
+            {
+                hitBoxes.Push(i->boundingBox_);
+                hitBoxTransforms.Push(boneNode->GetWorldTransform());
+            }
             else if (i->collisionMask_ & BONECOLLISION_SPHERE)
                 boneBoundingBox_.Merge(Sphere(inverseNodeTransform * boneNode->GetWorldPosition(), i->radius_ * 0.5f));
         }
+
+        if (hitBoxes.Size())
+        {
+            MultiplyMatrices(&hitBoxTransforms[0], inverseNodeTransform, &hitBoxTransforms[0], hitBoxTransforms.Size());
+            TransformBoundingBoxes(&hitBoxes[0], &hitBoxes[0], &hitBoxTransforms[0], hitBoxes.Size());
+            for (unsigned i = 0; i < hitBoxes.Size(); ++i)
+                boneBoundingBox_.Merge(hitBoxes[i]);
+        }
     }
 
     boneBoundingBoxDirty_ = false;
@@ -1307,30 +1324,31 @@ void AnimatedModel::UpdateSkinning()
     // Use model's world transform in case a bone is missing
     const Matrix3x4& worldTransform = node_->GetWorldTransform();
 
-    // Skinning with global matrices only
-    if (!geometrySkinMatrices_.Size())
+    // Gather the bone transforms and offset matrices to multiply them in one batch
+    for (unsigned i = 0; i < bones.Size(); ++i)
     {
-        for (unsigned i = 0; i < bones.Size(); ++i)
+        const Bone& bone = bones[i];
+        if (bone.node_)
         {
-            const Bone& bone = bones[i];
-            if (bone.node_)
-                skinMatrices_[i] = bone.node_->GetWorldTransform() * bone.offsetMatrix_;
-            else
-                skinMatrices_[i] = worldTransform;
+            skinMatrices_[i] = bone.node_->GetWorldTransform();
+            skinOffsetMatrices_[i] = bone.offsetMatrix_;
+        }
+        else
+        {
+            skinMatrices_[i] = worldTransform;
+            skinOffsetMatrices_[i] = Matrix3x4::IDENTITY;
         }
     }
+
+    if (bones.Size())
+        MultiplyMatrices(&skinMatrices_[0], &skinMatrices_[0], &skinOffsetMatrices_[0], bones.Size());
+
     // Skinning with per-geometry matrices
-    else
+    if (geometrySkinMatrices_.Size())
     {
+        // Copy the skin matrices to per-geometry matrices as needed
         for (unsigned i = 0; i < bones.Size(); ++i)
         {
-            const Bone& bone = bones[i];
-            if (bone.node_)
-                skinMatrices_[i] = bone.node_->GetWorldTransform() * bone.offsetMatrix_;
-            else
-                skinMatrices_[i] = worldTransform;
-
-            // Copy the skin matrix to per-geometry matrices as needed
             for (unsigned j = 0; j < geometrySkinMatrixPtrs_[i].Size(); ++j)
                 *geometrySkinMatrixPtrs_[i][j] = skinMatrices_[i];
         }
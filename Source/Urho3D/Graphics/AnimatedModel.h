@@ -219,6 +219,8 @@ private:
     Vector<SharedPtr<AnimationState> > animationStates_;
     /// Skinning matrices.
     PODVector<Matrix3x4> skinMatrices_;
+    /// Bone offset matrices gathered for calculating the skinning matrices.
+    PODVector<Matrix3x4> skinOffsetMatrices_;
     /// Mapping of subgeometry bone indices, used if more bones than skinning shader can manage.
     Vector<PODVector<unsigned> > geometryBoneMappings_;
     /// Subgeometry skinning matrices, used if more bones than skinning shader can manage.
@@ -40,44 +40,50 @@
 namespace Urho3D
 {
 
-inline bool CompareBatchesState(Batch* lhs, Batch* rhs)
+inline bool CompareInstancesFrontToBack(const InstanceData& lhs, const InstanceData& rhs)
 {
-    if (lhs->renderOrder_ != rhs->renderOrder_)
-        return lhs->renderOrder_ < rhs->renderOrder_;
-    else if (lhs->sortKey_ != rhs->sortKey_)
-        return lhs->sortKey_ < rhs->sortKey_;
-    else
-        return lhs->distance_ < rhs->distance_;
+    return lhs.distance_ < rhs.distance_;
 }
 
-inline bool CompareBatchesFrontToBack(Batch* lhs, Batch* rhs)
+/// Return an unsigned sort key that orders the same as the distance.
+inline unsigned GetDistanceSortKey(float distance)
 {
-    if (lhs->renderOrder_ != rhs->renderOrder_)
-        return lhs->renderOrder_ < rhs->renderOrder_;
-    else if (lhs->distance_ != rhs->distance_)
-        return lhs->distance_ < rhs->distance_;
-    else
-        return lhs->sortKey_ < rhs->sortKey_;
+    unsigned bits = FloatToRawIntBits(distance);
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
 }
 
-inline bool CompareBatchesBackToFront(Batch* lhs, Batch* rhs)
+/// Copy batch pointers to radix sort items.
+static void SetSortItems(PODVector<RadixSortItem<Batch*> >& items, const PODVector<Batch*>& batches)
 {
-    if (lhs->renderOrder_ != rhs->renderOrder_)
-        return lhs->renderOrder_ < rhs->renderOrder_;
-    else if (lhs->distance_ != rhs->distance_)
-        return lhs->distance_ > rhs->distance_;
-    else
-        return lhs->sortKey_ < rhs->sortKey_;
+    items.Resize(batches.Size());
+    for (unsigned i = 0; i < batches.Size(); ++i)
+        items[i].value_ = batches[i];
 }
 
-inline bool CompareInstancesFrontToBack(const InstanceData& lhs, const InstanceData& rhs)
+/// Copy batch pointers back from sorted radix sort items.
+static void GetSortItems(PODVector<Batch*>& batches, const PODVector<RadixSortItem<Batch*> >& items)
 {
-    return lhs.distance_ < rhs.distance_;
+    for (unsigned i = 0; i < items.Size(); ++i)
+        batches[i] = items[i].value_;
 }
 
-inline bool CompareBatchGroupOrder(BatchGroup* lhs, BatchGroup* rhs)
+/// Calculate keys for radix sort items and sort them. Items with equal keys keep their order from the previous sort.
+template <class T> static void SortItemsByKey(PODVector<RadixSortItem<Batch*> >& items, PODVector<RadixSortItem<Batch*> >& temp, T getKey)
 {
-    return lhs->renderOrder_ < rhs->renderOrder_;
+    for (PODVector<RadixSortItem<Batch*> >::Iterator i = items.Begin(); i != items.End(); ++i)
+        i->key_ = getKey(i->value_);
+
+    temp.Resize(items.Size());
+    RadixSort(items.Begin(), items.End(), temp.Buffer());
+}
+
+/// Sort radix sort items by render order, state and distance, in that priority.
+static void SortItemsByState(PODVector<RadixSortItem<Batch*> >& items, PODVector<RadixSortItem<Batch*> >& temp)
+{
+    // The sorts are stable, so sort by the least significant criterion first
+    SortItemsByKey(items, temp, [](const Batch* batch) { return (unsigned long long)GetDistanceSortKey(batch->distance_); });
+    SortItemsByKey(items, temp, [](const Batch* batch) { return batch->sortKey_; });
+    SortItemsByKey(items, temp, [](const Batch* batch) { return (unsigned long long)batch->renderOrder_; });
 }
 
 void CalculateShadowMatrix(Matrix4& dest, LightBatchQueue* queue, unsigned split, Renderer* renderer)
@@ -732,7 +738,14 @@ void BatchQueue::SortBackToFront()
     for (unsigned i = 0; i < batches_.Size(); ++i)
         sortedBatches_[i] = &batches_[i];
 
-    Sort(sortedBatches_.Begin(), sortedBatches_.End(), CompareBatchesBackToFront);
+    // Sort by render order and distance back to front, with state as the tiebreaker
+    SetSortItems(sortItems_, sortedBatches_);
+    SortItemsByKey(sortItems_, sortTemp_, [](const Batch* batch) { return batch->sortKey_; });
+    SortItemsByKey(sortItems_, sortTemp_, [](const Batch* batch)
+    {
+        return ((unsigned long long)batch->renderOrder_ << 32u) | (~GetDistanceSortKey(batch->distance_));
+    });
+    GetSortItems(sortedBatches_, sortItems_);
 
     sortedBatchGroups_.Resize(batchGroups_.Size());
 
@@ -740,7 +753,10 @@ void BatchQueue::SortBackToFront()
     for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
         sortedBatchGroups_[index++] = &i->second_;
 
-    Sort(sortedBatchGroups_.Begin(), sortedBatchGroups_.End(), CompareBatchGroupOrder);
+    PODVector<Batch*>& sortedBatchGroups = reinterpret_cast<PODVector<Batch*>& >(sortedBatchGroups_);
+    SetSortItems(sortItems_, sortedBatchGroups);
+    SortItemsByKey(sortItems_, sortTemp_, [](const Batch* batch) { return (unsigned long long)batch->renderOrder_; });
+    GetSortItems(sortedBatchGroups, sortItems_);
 }
 
 void BatchQueue::SortFrontToBack()
@@ -781,13 +797,22 @@ void BatchQueue::SortFrontToBack()
 
 void BatchQueue::SortFrontToBack2Pass(PODVector<Batch*>& batches)
 {
+    SetSortItems(sortItems_, batches);
+
     // Mobile devices likely use a tiled deferred approach, with which front-to-back sorting is irrelevant. The 2-pass
     // method is also time consuming, so just sort with state having priority
 #ifdef GL_ES_VERSION_2_0
-    Sort(batches.Begin(), batches.End(), CompareBatchesState);
+    SortItemsByState(sortItems_, sortTemp_);
+    GetSortItems(batches, sortItems_);
 #else
-    // For desktop, first sort by distance and remap shader/material/geometry IDs in the sort key
-    Sort(batches.Begin(), batches.End(), CompareBatchesFrontToBack);
+    // For desktop, first sort by render order and distance with state as the tiebreaker, and remap shader/material/geometry IDs
+    // in the sort key
+    SortItemsByKey(sortItems_, sortTemp_, [](const Batch* batch) { return batch->sortKey_; });
+    SortItemsByKey(sortItems_, sortTemp_, [](const Batch* batch)
+    {
+        return ((unsigned long long)batch->renderOrder_ << 32u) | GetDistanceSortKey(batch->distance_);
+    });
+    GetSortItems(batches, sortItems_);
 
     unsigned freeShaderID = 0;
     unsigned short freeMaterialID = 0;
@@ -834,8 +859,9 @@ void BatchQueue::SortFrontToBack2Pass(PODVector<Batch*>& batches)
     materialRemapping_.Clear();
     geometryRemapping_.Clear();
 
-    // Finally sort again with the rewritten ID's
-    Sort(batches.Begin(), batches.End(), CompareBatchesState);
+    // Finally sort again with the rewritten ID's. The sort items are still in the same order as the batches
+    SortItemsByState(sortItems_, sortTemp_);
+    GetSortItems(batches, sortItems_);
 #endif
 }
 
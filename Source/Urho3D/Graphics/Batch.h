@@ -23,6 +23,8 @@
 #pragma once
 
 #include "../Container/Ptr.h"
+#include "../Container/Sort.h"
+#include "../Core/FrameAllocator.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/Material.h"
 #include "../Math/MathDefs.h"
@@ -168,8 +170,8 @@ struct BatchGroup : public Batch
     /// Prepare and draw.
     void Draw(View* view, Camera* camera, bool allowDepthWrite) const;
 
-    /// Instance data.
-    PODVector<InstanceData> instances_;
+    /// Instance data. Allocated from the frame allocator when set by the view.
+    FramePODVector<InstanceData> instances_;
     /// Instance stream start index, or M_MAX_UNSIGNED if transforms not pre-set.
     unsigned startIndex_;
 };
@@ -252,6 +254,10 @@ public:
     HashMap<unsigned short, unsigned short> materialRemapping_;
     /// Geometry remapping table for 2-pass state and distance sort.
     HashMap<unsigned short, unsigned short> geometryRemapping_;
+    /// Radix sort items of the batches being sorted.
+    PODVector<RadixSortItem<Batch*> > sortItems_;
+    /// Radix sort temporary buffer.
+    PODVector<RadixSortItem<Batch*> > sortTemp_;
 
     /// Unsorted non-instanced draw calls.
     PODVector<Batch> batches_;
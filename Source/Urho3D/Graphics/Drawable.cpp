@@ -67,6 +67,7 @@ Drawable::Drawable(Context* context, unsigned char drawableFlags) :
     updateQueued_(false),
     zoneDirty_(false),
     octant_(nullptr),
+    octantIndex_(0),
     zone_(nullptr),
     viewMask_(DEFAULT_VIEWMASK),
     lightMask_(DEFAULT_LIGHTMASK),
@@ -256,6 +257,9 @@ const BoundingBox& Drawable::GetWorldBoundingBox()
     {
         OnWorldBoundingBoxUpdate();
         worldBoundingBoxDirty_ = false;
+        // The octant's copy of the bounding box for culling is only written in the main thread during the octree update, as
+        // other threads may be culling at the same time. Queue the update if the box changed without the drawable moving
+        MarkForUpdate();
     }
 
     return worldBoundingBox_;
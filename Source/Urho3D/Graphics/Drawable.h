@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "../Container/SmallVector.h"
 #include "../Graphics/GraphicsDefs.h"
 #include "../Math/BoundingBox.h"
 #include "../Scene/Component.h"
@@ -179,6 +180,11 @@ public:
     /// Return world-space bounding box.
     const BoundingBox& GetWorldBoundingBox();
 
+    /// Return whether the world-space bounding box needs to be recalculated.
+    bool IsWorldBoundingBoxDirty() const { return worldBoundingBoxDirty_; }
+    /// Return whether is queued for the octree update. The octant's copy of the world-space bounding box may be out of date until then.
+    bool IsUpdateQueued() const { return updateQueued_; }
+
     /// Return drawable flags.
     unsigned char GetDrawableFlags() const { return drawableFlags_; }
 
@@ -330,7 +336,7 @@ protected:
     /// Local-space bounding box.
     BoundingBox boundingBox_;
     /// Draw call source data.
-    Vector<SourceBatch> batches_;
+    SmallVector<SourceBatch, 1> batches_;
     /// Drawable flags.
     unsigned char drawableFlags_;
     /// Bounding box dirty flag.
@@ -347,6 +353,8 @@ protected:
     bool zoneDirty_;
     /// Octree octant.
     Octant* octant_;
+    /// Index in the octree octant's drawables.
+    unsigned octantIndex_;
     /// Current zone.
     Zone* zone_;
     /// View mask.
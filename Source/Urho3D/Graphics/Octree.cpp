@@ -45,6 +45,7 @@ namespace Urho3D
 
 static const float DEFAULT_OCTREE_SIZE = 1000.0f;
 static const int DEFAULT_OCTREE_LEVELS = 8;
+static const unsigned MIN_DRAWABLE_UPDATES_PER_ITEM = 16;
 
 extern const char* SUBSYSTEM_CATEGORY;
 
@@ -84,11 +85,11 @@ Octant::~Octant()
         // Remove the drawables (if any) from this octant to the root octant
         for (PODVector<Drawable*>::Iterator i = drawables_.Begin(); i != drawables_.End(); ++i)
         {
-            (*i)->SetOctant(root_);
-            root_->drawables_.Push(*i);
+            root_->PushDrawable(*i);
             root_->QueueUpdate(*i);
         }
         drawables_.Clear();
+        drawableBoxes_.Clear();
         numDrawables_ = 0;
     }
 
@@ -149,9 +150,10 @@ void Octant::InsertDrawable(Drawable* drawable)
         if (oldOctant != this)
         {
             // Add first, then remove, because drawable count going to zero deletes the octree branch in question
+            unsigned oldIndex = drawable->octantIndex_;
             AddDrawable(drawable);
             if (oldOctant)
-                oldOctant->RemoveDrawable(drawable, false);
+                oldOctant->RemoveDrawableAt(oldIndex, false);
         }
     }
     else
@@ -226,6 +228,41 @@ void Octant::Initialize(const BoundingBox& box)
     cullingBox_ = BoundingBox(worldBoundingBox_.min_ - halfSize_, worldBoundingBox_.max_ + halfSize_);
 }
 
+void Octant::PushDrawable(Drawable* drawable)
+{
+    drawable->SetOctant(this);
+    drawable->octantIndex_ = drawables_.Size();
+    drawables_.Push(drawable);
+
+    // If the bounding box is dirty, the drawable is queued for the octree update, which copies it when recalculated
+    unsigned index = drawable->octantIndex_;
+    if (index % BoundingBoxSoA::SIZE == 0)
+        drawableBoxes_.Resize(drawableBoxes_.Size() + 1);
+    drawableBoxes_[index / BoundingBoxSoA::SIZE].Set(index % BoundingBoxSoA::SIZE, drawable->worldBoundingBox_);
+}
+
+void Octant::RemoveDrawableAt(unsigned index, bool resetOctant)
+{
+    Drawable* drawable = drawables_[index];
+    unsigned lastIndex = drawables_.Size() - 1;
+    if (index != lastIndex)
+    {
+        Drawable* lastDrawable = drawables_[lastIndex];
+        drawables_[index] = lastDrawable;
+        lastDrawable->octantIndex_ = index;
+        drawableBoxes_[index / BoundingBoxSoA::SIZE].Set(index % BoundingBoxSoA::SIZE,
+            drawableBoxes_[lastIndex / BoundingBoxSoA::SIZE], lastIndex % BoundingBoxSoA::SIZE);
+    }
+
+    drawables_.Pop();
+    if (lastIndex % BoundingBoxSoA::SIZE == 0)
+        drawableBoxes_.Pop();
+
+    if (resetOctant)
+        drawable->SetOctant(nullptr);
+    DecDrawableCount();
+}
+
 void Octant::GetDrawablesInternal(OctreeQuery& query, bool inside) const
 {
     if (this != root_)
@@ -244,6 +281,7 @@ void Octant::GetDrawablesInternal(OctreeQuery& query, bool inside) const
     {
         auto** start = const_cast<Drawable**>(&drawables_[0]);
         Drawable** end = start + drawables_.Size();
+        query.drawableBoxes_ = &drawableBoxes_[0];
         query.TestDrawables(start, end, inside);
     }
 
@@ -380,30 +418,8 @@ void Octree::Update(const FrameInfo& frame)
         auto* queue = GetSubsystem<WorkQueue>();
         scene->BeginThreadedUpdate();
 
-        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = Max((int)(drawableUpdates_.Size() / numWorkItems), 1);
-
-        PODVector<Drawable*>::Iterator start = drawableUpdates_.Begin();
-        // Create a work item for each thread
-        for (int i = 0; i < numWorkItems; ++i)
-        {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = UpdateDrawablesWork;
-            item->aux_ = const_cast<FrameInfo*>(&frame);
-
-            PODVector<Drawable*>::Iterator end = drawableUpdates_.End();
-            if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
-
-            start = end;
-        }
-
-        queue->Complete(M_MAX_UNSIGNED);
+        queue->ParallelFor(drawableUpdates_.Begin(), drawableUpdates_.End(), UpdateDrawablesWork, const_cast<FrameInfo*>(&frame),
+            MIN_DRAWABLE_UPDATES_PER_ITEM);
         scene->EndThreadedUpdate();
     }
 
@@ -446,18 +462,24 @@ void Octree::Update(const FrameInfo& frame)
         for (PODVector<Drawable*>::Iterator i = drawableUpdates_.Begin(); i != drawableUpdates_.End(); ++i)
         {
             Drawable* drawable = *i;
-            drawable->updateQueued_ = false;
             Octant* octant = drawable->GetOctant();
+            // Recalculate the bounding box while still queued, so that the drawable does not queue itself again
             const BoundingBox& box = drawable->GetWorldBoundingBox();
+            drawable->updateQueued_ = false;
 
             // Skip if no octant or does not belong to this octree anymore
             if (!octant || octant->GetRoot() != this)
                 continue;
-            // Skip if still fits the current octant
+            // Copy the box for culling if the drawable still fits the current octant. Otherwise insertion copies it
             if (drawable->IsOccludee() && octant->GetCullingBox().IsInside(box) == INSIDE && octant->CheckDrawableFit(box))
+            {
+                octant->UpdateDrawableBox(drawable);
                 continue;
+            }
 
             InsertDrawable(drawable);
+            // Insertion does not copy the box if the drawable stays in the same octant
+            drawable->GetOctant()->UpdateDrawableBox(drawable);
 
 #ifdef _DEBUG
             // Verify that the drawable will be culled correctly
@@ -549,8 +571,10 @@ void Octree::RaycastSingle(RayOctreeQuery& query) const
 
 void Octree::QueueUpdate(Drawable* drawable)
 {
+    // Drawables may also queue themselves from the worker threads during view processing, when their bounding box is
+    // recalculated there
     Scene* scene = GetScene();
-    if (scene && scene->IsThreadedUpdate())
+    if ((scene && scene->IsThreadedUpdate()) || !Thread::IsMainThread())
     {
         MutexLock lock(octreeMutex_);
         threadedDrawableUpdates_.Push(drawable);
@@ -564,8 +588,10 @@ void Octree::QueueUpdate(Drawable* drawable)
 void Octree::CancelUpdate(Drawable* drawable)
 {
     // This doesn't have to take into account scene being in threaded update, because it is called only
-    // when removing a drawable from octree, which should only ever happen from the main thread.
+    // when removing a drawable from octree, which should only ever happen from the main thread. The drawable may still be
+    // queued from the worker threads of the previous frame's view processing
     drawableUpdates_.Remove(drawable);
+    threadedDrawableUpdates_.Remove(drawable);
     drawable->updateQueued_ = false;
 }
 
@@ -56,20 +56,23 @@ public:
     /// Add a drawable object to this octant.
     void AddDrawable(Drawable* drawable)
     {
-        drawable->SetOctant(this);
-        drawables_.Push(drawable);
+        PushDrawable(drawable);
         IncDrawableCount();
     }
 
     /// Remove a drawable object from this octant.
     void RemoveDrawable(Drawable* drawable, bool resetOctant = true)
     {
-        if (drawables_.Remove(drawable))
-        {
-            if (resetOctant)
-                drawable->SetOctant(nullptr);
-            DecDrawableCount();
-        }
+        unsigned index = drawable->octantIndex_;
+        if (index < drawables_.Size() && drawables_[index] == drawable)
+            RemoveDrawableAt(index, resetOctant);
+    }
+
+    /// Copy a drawable object's world bounding box to the bounding boxes used for culling. Called in the main thread during the octree update, when no culling is in progress.
+    void UpdateDrawableBox(Drawable* drawable)
+    {
+        unsigned index = drawable->octantIndex_;
+        drawableBoxes_[index / BoundingBoxSoA::SIZE].Set(index % BoundingBoxSoA::SIZE, drawable->worldBoundingBox_);
     }
 
     /// Return world-space bounding box.
@@ -107,6 +110,10 @@ protected:
     void GetDrawablesInternal(RayOctreeQuery& query) const;
     /// Return drawable objects only for a threaded ray query, called internally.
     void GetDrawablesOnlyInternal(RayOctreeQuery& query, PODVector<Drawable*>& drawables) const;
+    /// Append a drawable object to the drawables and bounding boxes without updating the drawable count.
+    void PushDrawable(Drawable* drawable);
+    /// Remove a drawable object by index, moving the last drawable object in its place.
+    void RemoveDrawableAt(unsigned index, bool resetOctant);
 
     /// Increase drawable object count recursively.
     void IncDrawableCount()
@@ -138,6 +145,8 @@ protected:
     BoundingBox cullingBox_;
     /// Drawable objects.
     PODVector<Drawable*> drawables_;
+    /// World bounding boxes of the drawable objects in groups of four, for culling them with SIMD instructions.
+    PODVector<BoundingBoxSoA> drawableBoxes_;
     /// Child octants.
     Octant* children_[NUM_OCTANTS]{};
     /// World bounding box center.
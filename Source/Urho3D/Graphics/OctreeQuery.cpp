@@ -105,13 +105,18 @@ Intersection FrustumOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 
 void FrustumOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool inside)
 {
-    while (start != end)
+    auto count = (unsigned)(end - start);
+    unsigned groupMask = 0;
+
+    for (unsigned i = 0; i < count; ++i)
     {
-        Drawable* drawable = *start++;
+        Drawable* drawable = start[i];
+        if (!inside && i % BoundingBoxSoA::SIZE == 0)
+            groupMask = TestDrawableGroup(i);
 
         if ((drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_))
         {
-            if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
+            if (inside || IsDrawableInside(drawable, i, groupMask))
                 result_.Push(drawable);
         }
     }
@@ -67,6 +67,8 @@ public:
     unsigned char drawableFlags_;
     /// Drawable layers to include.
     unsigned viewMask_;
+    /// World bounding boxes of the drawables being tested, in groups of four starting from the first drawable. Set by the octant before testing drawables.
+    const BoundingBoxSoA* drawableBoxes_{};
 };
 
 /// Point octree query.
@@ -151,6 +153,22 @@ public:
 
     /// Frustum.
     Frustum frustum_;
+
+protected:
+    /// Test the group of four drawables containing an index for (partial) inclusion using the octant's bounding boxes. Return a bit mask of the drawables that are not outside.
+    unsigned TestDrawableGroup(unsigned index) const
+    {
+        return drawableBoxes_ ? frustum_.IsInsideFast(drawableBoxes_[index / BoundingBoxSoA::SIZE]) : 0;
+    }
+
+    /// Test a drawable for (partial) inclusion, using the result of its group test unless the octant's copy of its bounding box may be out of date.
+    bool IsDrawableInside(Drawable* drawable, unsigned index, unsigned groupMask) const
+    {
+        if (drawableBoxes_ && !drawable->IsWorldBoundingBoxDirty() && !drawable->IsUpdateQueued())
+            return (groupMask & (1u << (index % BoundingBoxSoA::SIZE))) != 0;
+        else
+            return frustum_.IsInsideFast(drawable->GetWorldBoundingBox()) != OUTSIDE;
+    }
 };
 
 /// General octree query result. Used for Lua bindings only.
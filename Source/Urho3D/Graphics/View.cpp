@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/FrameAllocator.h"
 #include "../Core/Profiler.h"
 #include "../Core/WorkQueue.h"
 #include "../Graphics/Camera.h"
@@ -55,6 +56,11 @@
 namespace Urho3D
 {
 
+/// Minimum number of drawables per work item when checking visibility.
+static const unsigned MIN_VISIBILITY_CHECKS_PER_ITEM = 32;
+/// Minimum number of drawables per work item when updating geometries.
+static const unsigned MIN_GEOMETRY_UPDATES_PER_ITEM = 16;
+
 /// %Frustum octree query for shadowcasters.
 class ShadowCasterOctreeQuery : public FrustumOctreeQuery
 {
@@ -69,14 +75,19 @@ public:
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override
     {
-        while (start != end)
+        auto count = (unsigned)(end - start);
+        unsigned groupMask = 0;
+
+        for (unsigned i = 0; i < count; ++i)
         {
-            Drawable* drawable = *start++;
+            Drawable* drawable = start[i];
+            if (!inside && i % BoundingBoxSoA::SIZE == 0)
+                groupMask = TestDrawableGroup(i);
 
             if (drawable->GetCastShadows() && (drawable->GetDrawableFlags() & drawableFlags_) &&
                 (drawable->GetViewMask() & viewMask_))
             {
-                if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
+                if (inside || IsDrawableInside(drawable, i, groupMask))
                     result_.Push(drawable);
             }
         }
@@ -97,15 +108,20 @@ public:
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override
     {
-        while (start != end)
+        auto count = (unsigned)(end - start);
+        unsigned groupMask = 0;
+
+        for (unsigned i = 0; i < count; ++i)
         {
-            Drawable* drawable = *start++;
+            Drawable* drawable = start[i];
+            if (!inside && i % BoundingBoxSoA::SIZE == 0)
+                groupMask = TestDrawableGroup(i);
             unsigned char flags = drawable->GetDrawableFlags();
 
             if ((flags == DRAWABLE_ZONE || (flags == DRAWABLE_GEOMETRY && drawable->IsOccluder())) &&
                 (drawable->GetViewMask() & viewMask_))
             {
-                if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
+                if (inside || IsDrawableInside(drawable, i, groupMask))
                     result_.Push(drawable);
             }
         }
@@ -141,13 +157,18 @@ public:
     /// Intersection test for drawables. Note: drawable occlusion is performed later in worker threads.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override
     {
-        while (start != end)
+        auto count = (unsigned)(end - start);
+        unsigned groupMask = 0;
+
+        for (unsigned i = 0; i < count; ++i)
         {
-            Drawable* drawable = *start++;
+            Drawable* drawable = start[i];
+            if (!inside && i % BoundingBoxSoA::SIZE == 0)
+                groupMask = TestDrawableGroup(i);
 
             if ((drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_))
             {
-                if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
+                if (inside || IsDrawableInside(drawable, i, groupMask))
                     result_.Push(drawable);
             }
         }
@@ -170,6 +191,10 @@ void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
     bool cameraZoneOverride = view->cameraZoneOverride_;
     PerThreadSceneResult& result = view->sceneResults_[threadIndex];
 
+#ifdef URHO3D_PROFILING
+    AutoProfileBlock profileBlock(view->GetSubsystem<Profiler>(), "CheckVisibility");
+#endif
+
     while (start != end)
     {
         Drawable* drawable = *start++;
@@ -282,7 +307,8 @@ StringHash ParseTextureTypeXml(ResourceCache* cache, const String& filename);
 View::View(Context* context) :
     Object(context),
     graphics_(GetSubsystem<Graphics>()),
-    renderer_(GetSubsystem<Renderer>())
+    renderer_(GetSubsystem<Renderer>()),
+    frameAllocator_(GetSubsystem<FrameAllocator>())
 {
     // Create octree query and scene results vector for each thread
     unsigned numThreads = GetSubsystem<WorkQueue>()->GetNumThreads() + 1; // Worker threads + main thread
@@ -894,30 +920,7 @@ void View::GetDrawables()
             result.maxZ_ = 0.0f;
         }
 
-        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = tempDrawables.Size() / numWorkItems;
-
-        PODVector<Drawable*>::Iterator start = tempDrawables.Begin();
-        // Create a work item for each thread
-        for (int i = 0; i < numWorkItems; ++i)
-        {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = CheckVisibilityWork;
-            item->aux_ = this;
-
-            PODVector<Drawable*>::Iterator end = tempDrawables.End();
-            if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
-
-            start = end;
-        }
-
-        queue->Complete(M_MAX_UNSIGNED);
+        queue->ParallelFor(tempDrawables.Begin(), tempDrawables.End(), CheckVisibilityWork, this, MIN_VISIBILITY_CHECKS_PER_ITEM);
     }
 
     // Combine lights, geometries & scene Z range from the threads
@@ -1344,26 +1347,8 @@ void View::UpdateGeometries()
                 }
             }
 
-            int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-            int drawablesPerItem = threadedGeometries_.Size() / numWorkItems;
-
-            PODVector<Drawable*>::Iterator start = threadedGeometries_.Begin();
-            for (int i = 0; i < numWorkItems; ++i)
-            {
-                PODVector<Drawable*>::Iterator end = threadedGeometries_.End();
-                if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                    end = start + drawablesPerItem;
-
-                SharedPtr<WorkItem> item = queue->GetFreeItem();
-                item->priority_ = M_MAX_UNSIGNED;
-                item->workFunction_ = UpdateDrawableGeometriesWork;
-                item->aux_ = const_cast<FrameInfo*>(&frame_);
-                item->start_ = &(*start);
-                item->end_ = &(*end);
-                queue->AddWorkItem(item);
-
-                start = end;
-            }
+            queue->AddRangeWorkItems(threadedGeometries_.Begin(), threadedGeometries_.End(), UpdateDrawableGeometriesWork,
+                const_cast<FrameInfo*>(&frame_), MIN_GEOMETRY_UPDATES_PER_ITEM);
         }
 
         // While the work queue is processed, update non-threaded geometries
@@ -2275,6 +2260,8 @@ void View::DrawOccluders(OcclusionBuffer* buffer, const PODVector<Drawable*>& oc
 
 void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
 {
+    URHO3D_PROFILE(ProcessLight);
+
     Light* light = query.light_;
     LightType type = light->GetLightType();
     unsigned lightMask = light->GetLightMask();
@@ -2913,6 +2900,7 @@ void View::AddBatchToQueue(BatchQueue& queue, Batch& batch, Technique* tech, boo
             // Create a new group based on the batch
             // In case the group remains below the instancing limit, do not enable instancing shaders yet
             BatchGroup newGroup(batch);
+            newGroup.instances_.SetAllocator(frameAllocator_);
             newGroup.geometryType_ = GEOM_STATIC;
             renderer_->SetBatchShaders(newGroup, tech, allowShadows, queue);
             newGroup.CalculateSortKey();
@@ -35,6 +35,7 @@ namespace Urho3D
 
 class Camera;
 class DebugRenderer;
+class FrameAllocator;
 class Light;
 class Drawable;
 class Graphics;
@@ -312,6 +313,8 @@ private:
     WeakPtr<Graphics> graphics_;
     /// Renderer subsystem.
     WeakPtr<Renderer> renderer_;
+    /// Frame allocator subsystem.
+    WeakPtr<FrameAllocator> frameAllocator_;
     /// Scene to use.
     Scene* scene_{};
     /// Octree to use.
@@ -264,7 +264,7 @@ void Zone::UpdateAmbientGradient()
         Vector3 minZPosition = worldTransform * Vector3(center.x_, center.y_, boundingBox_.min_.z_);
         Vector3 maxZPosition = worldTransform * Vector3(center.x_, center.y_, boundingBox_.max_.z_);
 
-        PODVector<Zone*> result;
+        SmallPODVector<Zone*, 8> result;
         {
             PointOctreeQuery query(reinterpret_cast<PODVector<Drawable*>&>(result), minZPosition, DRAWABLE_ZONE);
             octant_->GetRoot()->GetDrawables(query);
@@ -58,8 +58,12 @@ const char* logLevelPrefixes[] =
 static Log* logInstance = nullptr;
 static bool threadErrorDisplayed = false;
 
+/// Number of messages from other threads that can be queued without locking during a frame.
+static const unsigned THREAD_MESSAGE_QUEUE_SIZE = 1024;
+
 Log::Log(Context* context) :
     Object(context),
+    threadMessages_(THREAD_MESSAGE_QUEUE_SIZE),
 #ifdef _DEBUG
     level_(LOG_DEBUG),
 #else
@@ -152,10 +156,7 @@ void Log::Write(int level, const String& message)
     if (!Thread::IsMainThread())
     {
         if (logInstance)
-        {
-            MutexLock lock(logInstance->logMutex_);
-            logInstance->threadMessages_.Push(StoredLogMessage(message, level, false));
-        }
+            logInstance->StoreThreadMessage(StoredLogMessage(message, level, false));
 
         return;
     }
@@ -211,10 +212,7 @@ void Log::WriteRaw(const String& message, bool error)
     if (!Thread::IsMainThread())
     {
         if (logInstance)
-        {
-            MutexLock lock(logInstance->logMutex_);
-            logInstance->threadMessages_.Push(StoredLogMessage(message, LOG_RAW, error));
-        }
+            logInstance->StoreThreadMessage(StoredLogMessage(message, LOG_RAW, error));
 
         return;
     }
@@ -277,20 +275,42 @@ void Log::HandleEndFrame(StringHash eventType, VariantMap& eventData)
         return;
     }
 
-    MutexLock lock(logMutex_);
-
-    // Process messages accumulated from other threads (if any)
-    while (!threadMessages_.Empty())
+    // Process messages accumulated from other threads (if any). After an overflow the list holds the older messages,
+    // so take it before what was queued since, then write outside the lock
+    List<StoredLogMessage> messages;
     {
-        const StoredLogMessage& stored = threadMessages_.Front();
+        MutexLock lock(logMutex_);
+        messages.Swap(overflowMessages_);
+        StoredLogMessage stored;
+        while (threadMessages_.TryPop(stored))
+            messages.Push(stored);
+        overflowed_.store(false, std::memory_order_release);
+    }
 
-        if (stored.level_ != LOG_RAW)
-            Write(stored.level_, stored.message_);
+    for (List<StoredLogMessage>::ConstIterator i = messages.Begin(); i != messages.End(); ++i)
+    {
+        if (i->level_ != LOG_RAW)
+            Write(i->level_, i->message_);
         else
-            WriteRaw(stored.message_, stored.error_);
-
-        threadMessages_.PopFront();
+            WriteRaw(i->message_, i->error_);
     }
 }
 
+void Log::StoreThreadMessage(StoredLogMessage&& message)
+{
+    // Once the queue has overflowed, keep to the locked list until the main thread has drained both. A failed push leaves
+    // the message untouched
+    if (!overflowed_.load(std::memory_order_acquire) && threadMessages_.TryPush(std::move(message)))
+        return;
+
+    // Move the queued messages in front of this one, including any this thread stored just before, so that the main thread
+    // can write the list before the queue without reordering
+    MutexLock lock(logMutex_);
+    StoredLogMessage queued;
+    while (threadMessages_.TryPop(queued))
+        overflowMessages_.Push(queued);
+    overflowMessages_.Push(message);
+    overflowed_.store(true, std::memory_order_release);
+}
+
 }
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "../Container/List.h"
+#include "../Container/RingQueue.h"
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
 #include "../Core/StringUtils.h"
@@ -109,13 +110,19 @@ public:
     static void WriteRaw(const String& message, bool error = false);
 
 private:
+    /// Store a message from another thread for processing at the end of the frame.
+    void StoreThreadMessage(StoredLogMessage&& message);
     /// Handle end of frame. Process the threaded log messages.
     void HandleEndFrame(StringHash eventType, VariantMap& eventData);
 
-    /// Mutex for threaded operation.
-    Mutex logMutex_;
     /// Log messages from other threads.
-    List<StoredLogMessage> threadMessages_;
+    MPMCQueue<StoredLogMessage> threadMessages_;
+    /// Mutex for the messages that did not fit in the queue.
+    Mutex logMutex_;
+    /// Log messages from other threads that did not fit in the queue, followed by everything stored until the main thread drains both.
+    List<StoredLogMessage> overflowMessages_;
+    /// Whether the queue has overflowed since the main thread last drained it. While set, messages go to the locked list to keep their order.
+    std::atomic<bool> overflowed_{};
     /// Log file.
     SharedPtr<File> logFile_;
     /// Last log message.
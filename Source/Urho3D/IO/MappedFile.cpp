@@ -0,0 +1,221 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../IO/File.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../IO/MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+MappedFile::MappedFile(Context* context) :
+    Object(context),
+    data_(nullptr),
+    size_(0),
+#ifdef _WIN32
+    mappingHandle_(nullptr),
+#endif
+    open_(false),
+    mapped_(false)
+{
+}
+
+MappedFile::MappedFile(Context* context, const String& fileName) :
+    Object(context),
+    data_(nullptr),
+    size_(0),
+#ifdef _WIN32
+    mappingHandle_(nullptr),
+#endif
+    open_(false),
+    mapped_(false)
+{
+    Open(fileName);
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const String& fileName)
+{
+    Close();
+
+    auto* fileSystem = GetSubsystem<FileSystem>();
+    if (fileSystem && !fileSystem->CheckAccess(GetPath(fileName)))
+    {
+        URHO3D_LOGERRORF("Access denied to %s", fileName.CString());
+        return false;
+    }
+
+    if (fileName.Empty())
+    {
+        URHO3D_LOGERROR("Could not open file with empty name");
+        return false;
+    }
+
+    fileName_ = fileName;
+
+#ifdef __ANDROID__
+    if (URHO3D_IS_ASSET(fileName))
+        return ReadToMemory();
+#endif
+
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileW(GetWideNativePath(fileName).CString(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        URHO3D_LOGERRORF("Could not open file %s", fileName.CString());
+        fileName_.Clear();
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart > M_MAX_UNSIGNED)
+    {
+        CloseHandle(fileHandle);
+        URHO3D_LOGERRORF("Could not open file %s which is larger than 4GB", fileName.CString());
+        fileName_.Clear();
+        return false;
+    }
+
+    size_ = (unsigned)fileSize.QuadPart;
+    // Empty files can not be mapped
+    if (size_)
+    {
+        mappingHandle_ = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle_)
+        {
+            data_ = static_cast<const unsigned char*>(MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, 0));
+            if (!data_)
+            {
+                CloseHandle(mappingHandle_);
+                mappingHandle_ = nullptr;
+            }
+        }
+    }
+    // The mapping keeps the file open
+    CloseHandle(fileHandle);
+#else
+    int fd = open(GetNativePath(fileName).CString(), O_RDONLY);
+    if (fd < 0)
+    {
+        URHO3D_LOGERRORF("Could not open file %s", fileName.CString());
+        fileName_.Clear();
+        return false;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || (unsigned long long)st.st_size > M_MAX_UNSIGNED)
+    {
+        close(fd);
+        URHO3D_LOGERRORF("Could not open file %s which is larger than 4GB", fileName.CString());
+        fileName_.Clear();
+        return false;
+    }
+
+    size_ = (unsigned)st.st_size;
+    // Empty files can not be mapped
+    if (size_)
+    {
+        void* ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr != MAP_FAILED)
+            data_ = static_cast<const unsigned char*>(ptr);
+    }
+    // The mapping keeps the file open
+    close(fd);
+#endif
+
+    if (!data_ && size_)
+    {
+        URHO3D_LOGWARNINGF("Could not memory-map file %s, reading it instead", fileName.CString());
+        return ReadToMemory();
+    }
+
+    open_ = true;
+    mapped_ = data_ != nullptr;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (mapped_)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(mappingHandle_);
+        mappingHandle_ = nullptr;
+#else
+        munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+    }
+
+    buffer_.Reset();
+    fileName_.Clear();
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+    mapped_ = false;
+}
+
+bool MappedFile::ReadToMemory()
+{
+    File file(context_);
+    if (!file.Open(fileName_))
+    {
+        fileName_.Clear();
+        return false;
+    }
+
+    size_ = file.GetSize();
+    buffer_ = new unsigned char[size_];
+    if (file.Read(buffer_.Get(), size_) != size_)
+    {
+        URHO3D_LOGERRORF("Could not read file %s", fileName_.CString());
+        Close();
+        return false;
+    }
+
+    data_ = buffer_.Get();
+    open_ = true;
+    mapped_ = false;
+    return true;
+}
+
+}
@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Container/ArrayPtr.h"
+#include "../Core/Object.h"
+
+namespace Urho3D
+{
+
+/// Read-only memory-mapped file. Falls back to reading the file into memory where mapping is not available, such as for Android asset files.
+class URHO3D_API MappedFile : public Object
+{
+    URHO3D_OBJECT(MappedFile, Object);
+
+public:
+    /// Construct.
+    explicit MappedFile(Context* context);
+    /// Construct and open a filesystem file.
+    MappedFile(Context* context, const String& fileName);
+    /// Destruct. Close the file if open.
+    ~MappedFile() override;
+
+    /// Open a filesystem file for reading. Return true if successful.
+    bool Open(const String& fileName);
+    /// Close the file.
+    void Close();
+
+    /// Return the file name.
+    const String& GetName() const { return fileName_; }
+    /// Return the file contents.
+    const unsigned char* GetData() const { return data_; }
+    /// Return the file size.
+    unsigned GetSize() const { return size_; }
+    /// Return whether is open.
+    bool IsOpen() const { return open_; }
+    /// Return whether the contents are memory-mapped instead of read into memory.
+    bool IsMapped() const { return mapped_; }
+
+private:
+    /// Read the file into memory when it can not be mapped. Return true if successful.
+    bool ReadToMemory();
+
+    /// File name.
+    String fileName_;
+    /// File contents.
+    const unsigned char* data_;
+    /// File size.
+    unsigned size_;
+    /// Buffer for the file contents when not mapped.
+    SharedArrayPtr<unsigned char> buffer_;
+#ifdef _WIN32
+    /// File mapping object handle.
+    void* mappingHandle_;
+#endif
+    /// Open flag.
+    bool open_;
+    /// Memory-mapped flag.
+    bool mapped_;
+};
+
+}
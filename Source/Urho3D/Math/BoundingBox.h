@@ -325,4 +325,52 @@ public:
     float dummyMax_{}; // This is never used, but exists to pad the max_ value to four floats.
 };
 
+/// Four axis-aligned bounding boxes in structure-of-arrays layout, for testing them at once with SIMD instructions.
+struct BoundingBoxSoA
+{
+    /// Number of bounding boxes.
+    static const unsigned SIZE = 4;
+
+    /// Set a bounding box.
+    void Set(unsigned index, const BoundingBox& box)
+    {
+        minX_[index] = box.min_.x_;
+        minY_[index] = box.min_.y_;
+        minZ_[index] = box.min_.z_;
+        maxX_[index] = box.max_.x_;
+        maxY_[index] = box.max_.y_;
+        maxZ_[index] = box.max_.z_;
+    }
+
+    /// Copy a bounding box from another group.
+    void Set(unsigned index, const BoundingBoxSoA& boxes, unsigned srcIndex)
+    {
+        minX_[index] = boxes.minX_[srcIndex];
+        minY_[index] = boxes.minY_[srcIndex];
+        minZ_[index] = boxes.minZ_[srcIndex];
+        maxX_[index] = boxes.maxX_[srcIndex];
+        maxY_[index] = boxes.maxY_[srcIndex];
+        maxZ_[index] = boxes.maxZ_[srcIndex];
+    }
+
+    /// Return a bounding box.
+    BoundingBox Get(unsigned index) const
+    {
+        return BoundingBox(Vector3(minX_[index], minY_[index], minZ_[index]), Vector3(maxX_[index], maxY_[index], maxZ_[index]));
+    }
+
+    /// Minimum X coordinates.
+    float minX_[SIZE];
+    /// Minimum Y coordinates.
+    float minY_[SIZE];
+    /// Minimum Z coordinates.
+    float minZ_[SIZE];
+    /// Maximum X coordinates.
+    float maxX_[SIZE];
+    /// Maximum Y coordinates.
+    float maxY_[SIZE];
+    /// Maximum Z coordinates.
+    float maxZ_[SIZE];
+};
+
 }
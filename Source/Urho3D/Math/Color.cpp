@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringUtils.h"
 #include "../Math/Color.h"
 
 #include <cstdio>
@@ -251,7 +252,7 @@ Color Color::Lerp(const Color& rhs, float t) const
 String Color::ToString() const
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%g %g %g %g", r_, g_, b_, a_);
+    FormatFloats(tempBuffer, Data(), 4);
     return String(tempBuffer);
 }
 
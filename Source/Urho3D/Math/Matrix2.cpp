@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringUtils.h"
 #include "../Math/Matrix2.h"
 
 #include <cstdio>
@@ -53,7 +54,7 @@ Matrix2 Matrix2::Inverse() const
 String Matrix2::ToString() const
 {
     char tempBuffer[MATRIX_CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%g %g %g %g", m00_, m01_, m10_, m11_);
+    FormatFloats(tempBuffer, Data(), 4);
     return String(tempBuffer);
 }
 }
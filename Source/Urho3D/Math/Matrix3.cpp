@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringUtils.h"
 #include "../Math/Matrix3.h"
 
 #include <cstdio>
@@ -65,7 +66,7 @@ Matrix3 Matrix3::Inverse() const
 String Matrix3::ToString() const
 {
     char tempBuffer[MATRIX_CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%g %g %g %g %g %g %g %g %g", m00_, m01_, m02_, m10_, m11_, m12_, m20_, m21_, m22_);
+    FormatFloats(tempBuffer, Data(), 9);
     return String(tempBuffer);
 }
 
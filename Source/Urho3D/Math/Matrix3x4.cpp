@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringUtils.h"
 #include "../Math/Matrix3x4.h"
 
 #include <cstdio>
@@ -83,8 +84,7 @@ Matrix3x4 Matrix3x4::Inverse() const
 String Matrix3x4::ToString() const
 {
     char tempBuffer[MATRIX_CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%g %g %g %g %g %g %g %g %g %g %g %g", m00_, m01_, m02_, m03_, m10_, m11_, m12_, m13_, m20_, m21_, m22_,
-        m23_);
+    FormatFloats(tempBuffer, Data(), 12);
     return String(tempBuffer);
 }
 
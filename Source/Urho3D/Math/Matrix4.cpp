@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringUtils.h"
 #include "../Math/Matrix3x4.h"
 #include "../Math/Matrix4.h"
 
@@ -136,8 +137,7 @@ Matrix4 Matrix4::Inverse() const
 String Matrix4::ToString() const
 {
     char tempBuffer[MATRIX_CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%g %g %g %g %g %g %g %g %g %g %g %g %g %g %g %g", m00_, m01_, m02_, m03_, m10_, m11_, m12_, m13_, m20_,
-        m21_, m22_, m23_, m30_, m31_, m32_, m33_);
+    FormatFloats(tempBuffer, Data(), 16);
     return String(tempBuffer);
 }
 
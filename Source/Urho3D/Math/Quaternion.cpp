@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringUtils.h"
 #include "../Math/Quaternion.h"
 
 #include <cstdio>
@@ -325,7 +326,7 @@ Quaternion Quaternion::Nlerp(const Quaternion& rhs, float t, bool shortestPath)
 String Quaternion::ToString() const
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%g %g %g %g", w_, x_, y_, z_);
+    FormatFloats(tempBuffer, Data(), 4);
     return String(tempBuffer);
 }
 
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringUtils.h"
 #include "../Math/Rect.h"
 
 #include <cstdio>
@@ -74,7 +75,7 @@ void IntRect::Merge(const IntRect& rect)
 String Rect::ToString() const
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%g %g %g %g", min_.x_, min_.y_, max_.x_, max_.y_);
+    FormatFloats(tempBuffer, Data(), 4);
     return String(tempBuffer);
 }
 
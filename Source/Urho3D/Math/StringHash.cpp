@@ -52,14 +52,6 @@ static StringHashRegister& GetGlobalStringHashRegister()
 
 const StringHash StringHash::ZERO;
 
-StringHash::StringHash(const char* str) noexcept :
-    value_(Calculate(str))
-{
-#ifdef URHO3D_HASH_DEBUG
-    Urho3D::GetGlobalStringHashRegister().RegisterString(*this, str);
-#endif
-}
-
 StringHash::StringHash(const String& str) noexcept :
     value_(Calculate(str.CString()))
 {
@@ -81,6 +73,15 @@ unsigned StringHash::Calculate(const char* str, unsigned hash)
     return hash;
 }
 
+unsigned StringHash::CalculateRegistered(const char* str)
+{
+    unsigned hash = Calculate(str);
+#ifdef URHO3D_HASH_DEBUG
+    Urho3D::GetGlobalStringHashRegister().RegisterString(StringHash(hash), str);
+#endif
+    return hash;
+}
+
 StringHashRegister* StringHash::GetGlobalStringHashRegister()
 {
 #ifdef URHO3D_HASH_DEBUG
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "../Container/Str.h"
+#include "../Math/MathDefs.h"
 
 namespace Urho3D
 {
@@ -34,7 +35,7 @@ class URHO3D_API StringHash
 {
 public:
     /// Construct with zero value.
-    StringHash() noexcept :
+    constexpr StringHash() noexcept :
         value_(0)
     {
     }
@@ -43,13 +44,32 @@ public:
     StringHash(const StringHash& rhs) noexcept = default;
 
     /// Construct with an initial value.
-    explicit StringHash(unsigned value) noexcept :
+    constexpr explicit StringHash(unsigned value) noexcept :
         value_(value)
     {
     }
 
+#ifndef URHO3D_HASH_DEBUG
+    /// Construct from a string literal or char array. The hash of a literal is calculated at compile time.
+    template <unsigned N> constexpr StringHash(const char (&str)[N]) noexcept :     // NOLINT(google-explicit-constructor)
+        value_(CalculateConstexpr(str))
+    {
+    }
+#else
+    /// Construct from a string literal or char array.
+    template <unsigned N> StringHash(const char (&str)[N]) noexcept :     // NOLINT(google-explicit-constructor)
+        value_(CalculateRegistered(str))
+    {
+    }
+#endif
+
     /// Construct from a C string.
-    StringHash(const char* str) noexcept;        // NOLINT(google-explicit-constructor)
+    template <class T, typename std::enable_if<std::is_convertible<T, const char*>::value && !std::is_array<T>::value, int>::type = 0>
+    StringHash(const T& str) noexcept :          // NOLINT(google-explicit-constructor)
+        value_(CalculateRegistered(str))
+    {
+    }
+
     /// Construct from a string.
     StringHash(const String& str) noexcept;      // NOLINT(google-explicit-constructor)
 
@@ -87,7 +107,7 @@ public:
     explicit operator bool() const { return value_ != 0; }
 
     /// Return hash value.
-    unsigned Value() const { return value_; }
+    constexpr unsigned Value() const { return value_; }
 
     /// Return as string.
     String ToString() const;
@@ -96,11 +116,17 @@ public:
     String Reverse() const;
 
     /// Return hash value for HashSet & HashMap.
-    unsigned ToHash() const { return value_; }
+    constexpr unsigned ToHash() const { return value_; }
 
     /// Calculate hash value from a C string.
     static unsigned Calculate(const char* str, unsigned hash = 0);
 
+    /// Calculate hash value from a C string at compile time. Gives the same result as Calculate().
+    static constexpr unsigned CalculateConstexpr(const char* str, unsigned hash = 0)
+    {
+        return str && *str ? CalculateConstexpr(str + 1, SDBMHash(hash, (unsigned char)*str)) : hash;
+    }
+
     /// Get global StringHashRegister. Use for debug purposes only. Return nullptr if URHO3D_HASH_DEBUG is off.
     static StringHashRegister* GetGlobalStringHashRegister();
 
@@ -108,6 +134,9 @@ public:
     static const StringHash ZERO;
 
 private:
+    /// Calculate hash value from a C string and register it for reverse lookup if URHO3D_HASH_DEBUG is on.
+    static unsigned CalculateRegistered(const char* str);
+
     /// Hash value.
     unsigned value_;
 };
@@ -0,0 +1,246 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Math/TransformArrays.h"
+
+// The AVX paths are compiled with a function target attribute and selected at runtime, so the rest of the library keeps
+// running on CPUs with SSE only
+#if defined(URHO3D_SSE) && !defined(__EMSCRIPTEN__) && !defined(IOS) && !defined(TVOS)
+#define URHO3D_AVX_ARRAYS
+#include <immintrin.h>
+#if !defined(__linux__)
+#include <LibCpuId/libcpuid.h>
+#endif
+#if defined(_MSC_VER)
+#define AVX_FUNCTION
+#else
+#define AVX_FUNCTION __attribute__((target("avx")))
+#endif
+#endif
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+#ifdef URHO3D_AVX_ARRAYS
+/// Return whether the CPU and the operating system support AVX instructions.
+static bool DetectAVX()
+{
+#if defined(__linux__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") != 0;
+#else
+    if (!cpuid_present())
+        return false;
+
+    struct cpu_raw_data_t raw{};
+    struct cpu_id_t data{};
+    if (cpuid_get_raw_data(&raw) < 0 || cpu_identify(&raw, &data) < 0)
+        return false;
+    if (!data.flags[CPU_FEATURE_AVX] || !data.flags[CPU_FEATURE_OSXSAVE])
+        return false;
+
+    // The operating system must also save the YMM registers on context switch
+#if defined(_MSC_VER)
+    unsigned long long xcr0 = _xgetbv(0);
+#else
+    unsigned eax, edx;
+    __asm__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    unsigned long long xcr0 = ((unsigned long long)edx << 32u) | eax;
+#endif
+    return (xcr0 & 0x6u) == 0x6u;
+#endif
+}
+
+/// Return whether to use the AVX paths. Detected once.
+static bool UseAVX()
+{
+    static const bool avx = DetectAVX();
+    return avx;
+}
+
+/// Load the same four floats to both halves of an AVX register.
+AVX_FUNCTION static inline __m256 LoadBothHalves(const float* data)
+{
+    __m128 value = _mm_loadu_ps(data);
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(value), value, 1);
+}
+
+/// Load four floats from two addresses to the halves of an AVX register.
+AVX_FUNCTION static inline __m256 LoadHalves(const float* low, const float* high)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+/// Multiply a matrix whose first two rows are in an AVX register and last row in an SSE register. The rows of the right hand side matrix are duplicated to both halves.
+AVX_FUNCTION static inline void MultiplyMatrixAVX(Matrix3x4& dest, __m256 l01, __m128 l2, __m256 r0, __m256 r1, __m256 r2)
+{
+    // Same operation order as in Matrix3x4::operator *, so that the results are identical
+    const __m256 r3 = _mm256_set_ps(1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f);
+    __m256 t0 = _mm256_mul_ps(_mm256_permute_ps(l01, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+    __m256 t1 = _mm256_mul_ps(_mm256_permute_ps(l01, _MM_SHUFFLE(1, 1, 1, 1)), r1);
+    __m256 t2 = _mm256_mul_ps(_mm256_permute_ps(l01, _MM_SHUFFLE(2, 2, 2, 2)), r2);
+    __m256 t3 = _mm256_mul_ps(l01, r3);
+    __m256 row01 = _mm256_add_ps(_mm256_add_ps(t0, t1), _mm256_add_ps(t2, t3));
+
+    __m128 u0 = _mm_mul_ps(_mm_permute_ps(l2, _MM_SHUFFLE(0, 0, 0, 0)), _mm256_castps256_ps128(r0));
+    __m128 u1 = _mm_mul_ps(_mm_permute_ps(l2, _MM_SHUFFLE(1, 1, 1, 1)), _mm256_castps256_ps128(r1));
+    __m128 u2 = _mm_mul_ps(_mm_permute_ps(l2, _MM_SHUFFLE(2, 2, 2, 2)), _mm256_castps256_ps128(r2));
+    __m128 u3 = _mm_mul_ps(l2, _mm256_castps256_ps128(r3));
+    __m128 row2 = _mm_add_ps(_mm_add_ps(u0, u1), _mm_add_ps(u2, u3));
+
+    _mm256_storeu_ps(&dest.m00_, row01);
+    _mm_storeu_ps(&dest.m20_, row2);
+}
+
+AVX_FUNCTION static void MultiplyMatricesAVX(Matrix3x4* dest, const Matrix3x4* lhs, const Matrix3x4* rhs, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+    {
+        // Load everything before storing, as the destination may be either source
+        __m256 l01 = _mm256_loadu_ps(&lhs[i].m00_);
+        __m128 l2 = _mm_loadu_ps(&lhs[i].m20_);
+        __m256 r0 = LoadBothHalves(&rhs[i].m00_);
+        __m256 r1 = LoadBothHalves(&rhs[i].m10_);
+        __m256 r2 = LoadBothHalves(&rhs[i].m20_);
+        MultiplyMatrixAVX(dest[i], l01, l2, r0, r1, r2);
+    }
+
+    _mm256_zeroupper();
+}
+
+AVX_FUNCTION static void MultiplyMatricesAVX(Matrix3x4* dest, const Matrix3x4& lhs, const Matrix3x4* rhs, unsigned count)
+{
+    __m256 l01 = _mm256_loadu_ps(&lhs.m00_);
+    __m128 l2 = _mm_loadu_ps(&lhs.m20_);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        __m256 r0 = LoadBothHalves(&rhs[i].m00_);
+        __m256 r1 = LoadBothHalves(&rhs[i].m10_);
+        __m256 r2 = LoadBothHalves(&rhs[i].m20_);
+        MultiplyMatrixAVX(dest[i], l01, l2, r0, r1, r2);
+    }
+
+    _mm256_zeroupper();
+}
+
+AVX_FUNCTION static void TransformBoundingBoxesAVX(BoundingBox* dest, const BoundingBox* boxes, const Matrix3x4* transforms, unsigned count)
+{
+    // Transform two boxes at a time, one in each half. Same operation order as in BoundingBox::Transformed
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+    unsigned i = 0;
+    for (; i + 1 < count; i += 2)
+    {
+        // The fourth components are padding, replace them with one
+        __m256 minPt = _mm256_blend_ps(LoadHalves(&boxes[i].min_.x_, &boxes[i + 1].min_.x_), one, 0x88);
+        __m256 maxPt = _mm256_blend_ps(LoadHalves(&boxes[i].max_.x_, &boxes[i + 1].max_.x_), one, 0x88);
+        __m256 centerPoint = _mm256_mul_ps(_mm256_add_ps(minPt, maxPt), half);
+        __m256 halfSize = _mm256_sub_ps(centerPoint, minPt);
+        __m256 m0 = LoadHalves(&transforms[i].m00_, &transforms[i + 1].m00_);
+        __m256 m1 = LoadHalves(&transforms[i].m10_, &transforms[i + 1].m10_);
+        __m256 m2 = LoadHalves(&transforms[i].m20_, &transforms[i + 1].m20_);
+        __m256 r0 = _mm256_mul_ps(m0, centerPoint);
+        __m256 r1 = _mm256_mul_ps(m1, centerPoint);
+        __m256 t0 = _mm256_add_ps(_mm256_unpacklo_ps(r0, r1), _mm256_unpackhi_ps(r0, r1));
+        __m256 r2 = _mm256_mul_ps(m2, centerPoint);
+        __m256 t2 = _mm256_add_ps(_mm256_unpacklo_ps(r2, zero), _mm256_unpackhi_ps(r2, zero));
+        __m256 newCenter = _mm256_add_ps(_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)),
+            _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)));
+        __m256 x = _mm256_and_ps(absMask, _mm256_mul_ps(m0, halfSize));
+        __m256 y = _mm256_and_ps(absMask, _mm256_mul_ps(m1, halfSize));
+        __m256 z = _mm256_and_ps(absMask, _mm256_mul_ps(m2, halfSize));
+        t0 = _mm256_add_ps(_mm256_unpacklo_ps(x, y), _mm256_unpackhi_ps(x, y));
+        t2 = _mm256_add_ps(_mm256_unpacklo_ps(z, zero), _mm256_unpackhi_ps(z, zero));
+        __m256 newDir = _mm256_add_ps(_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)),
+            _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)));
+        __m256 newMin = _mm256_sub_ps(newCenter, newDir);
+        __m256 newMax = _mm256_add_ps(newCenter, newDir);
+
+        dest[i] = BoundingBox(_mm256_castps256_ps128(newMin), _mm256_castps256_ps128(newMax));
+        dest[i + 1] = BoundingBox(_mm256_extractf128_ps(newMin, 1), _mm256_extractf128_ps(newMax, 1));
+    }
+
+    _mm256_zeroupper();
+
+    if (i < count)
+        dest[i] = boxes[i].Transformed(transforms[i]);
+}
+#endif
+
+void MultiplyMatrices(Matrix3x4* dest, const Matrix3x4* lhs, const Matrix3x4* rhs, unsigned count)
+{
+#ifdef URHO3D_AVX_ARRAYS
+    if (UseAVX())
+    {
+        MultiplyMatricesAVX(dest, lhs, rhs, count);
+        return;
+    }
+#endif
+
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = lhs[i] * rhs[i];
+}
+
+void MultiplyMatrices(Matrix3x4* dest, const Matrix3x4& lhs, const Matrix3x4* rhs, unsigned count)
+{
+#ifdef URHO3D_AVX_ARRAYS
+    if (UseAVX())
+    {
+        MultiplyMatricesAVX(dest, lhs, rhs, count);
+        return;
+    }
+#endif
+
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = lhs * rhs[i];
+}
+
+void TransformBoundingBoxes(BoundingBox* dest, const BoundingBox* boxes, const Matrix3x4* transforms, unsigned count)
+{
+#ifdef URHO3D_AVX_ARRAYS
+    if (UseAVX())
+    {
+        TransformBoundingBoxesAVX(dest, boxes, transforms, count);
+        return;
+    }
+#endif
+
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = boxes[i].Transformed(transforms[i]);
+}
+
+void ComposeTransforms(Matrix3x4* dest, const Vector3* translations, const Quaternion* rotations, const Vector3* scales, unsigned count)
+{
+    // The quaternion to matrix conversion consists mostly of shuffles within one register, so use the SSE path of Matrix3x4 on all CPUs
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = Matrix3x4(translations[i], rotations[i], scales[i]);
+}
+
+}
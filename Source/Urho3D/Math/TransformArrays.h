@@ -0,0 +1,42 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Math/BoundingBox.h"
+#include "../Math/Matrix3x4.h"
+
+namespace Urho3D
+{
+
+/// Multiply arrays of 3x4 matrices, dest[i] = lhs[i] * rhs[i]. The destination may be the same array as either source.
+URHO3D_API void MultiplyMatrices(Matrix3x4* dest, const Matrix3x4* lhs, const Matrix3x4* rhs, unsigned count);
+/// Multiply an array of 3x4 matrices by a matrix from the left, dest[i] = lhs * rhs[i]. The destination may be the same array as the source.
+URHO3D_API void MultiplyMatrices(Matrix3x4* dest, const Matrix3x4& lhs, const Matrix3x4* rhs, unsigned count);
+/// Transform an array of bounding boxes by an array of matrices, dest[i] = boxes[i].Transformed(transforms[i]). The destination may be the same array as the source.
+URHO3D_API void TransformBoundingBoxes(BoundingBox* dest, const BoundingBox* boxes, const Matrix3x4* transforms, unsigned count);
+/// Compose an array of 3x4 matrices from translation, rotation and scale arrays.
+URHO3D_API void ComposeTransforms(Matrix3x4* dest, const Vector3* translations, const Quaternion* rotations, const Vector3* scales, unsigned count);
+
+}
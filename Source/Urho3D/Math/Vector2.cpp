@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringUtils.h"
 #include "../Math/Vector2.h"
 
 #include <cstdio>
@@ -48,7 +49,7 @@ const IntVector2 IntVector2::ONE(1, 1);
 String Vector2::ToString() const
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%g %g", x_, y_);
+    FormatFloats(tempBuffer, Data(), 2);
     return String(tempBuffer);
 }
 
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringUtils.h"
 #include "../Math/Vector3.h"
 
 #include <cstdio>
@@ -52,7 +53,7 @@ const IntVector3 IntVector3::ONE(1, 1, 1);
 String Vector3::ToString() const
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%g %g %g", x_, y_, z_);
+    FormatFloats(tempBuffer, Data(), 3);
     return String(tempBuffer);
 }
 
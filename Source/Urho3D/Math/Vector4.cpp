@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringUtils.h"
 #include "../Math/Vector4.h"
 
 #include <cstdio>
@@ -37,7 +38,7 @@ const Vector4 Vector4::ONE(1.0f, 1.0f, 1.0f, 1.0f);
 String Vector4::ToString() const
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
-    sprintf(tempBuffer, "%g %g %g %g", x_, y_, z_, w_);
+    FormatFloats(tempBuffer, Data(), 4);
     return String(tempBuffer);
 }
 
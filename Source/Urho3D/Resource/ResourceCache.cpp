@@ -265,16 +265,17 @@ void ResourceCache::ReleaseResources(StringHash type, bool force)
     HashMap<StringHash, ResourceGroup>::Iterator i = resourceGroups_.Find(type);
     if (i != resourceGroups_.End())
     {
-        for (HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
+        for (FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
              j != i->second_.resources_.End();)
         {
-            HashMap<StringHash, SharedPtr<Resource> >::Iterator current = j++;
             // If other references exist, do not release, unless forced
-            if ((current->second_.Refs() == 1 && current->second_.WeakRefs() == 0) || force)
+            if ((j->second_.Refs() == 1 && j->second_.WeakRefs() == 0) || force)
             {
-                i->second_.resources_.Erase(current);
+                j = i->second_.resources_.Erase(j);
                 released = true;
             }
+            else
+                ++j;
         }
     }
 
@@ -289,19 +290,22 @@ void ResourceCache::ReleaseResources(StringHash type, const String& partialName,
     HashMap<StringHash, ResourceGroup>::Iterator i = resourceGroups_.Find(type);
     if (i != resourceGroups_.End())
     {
-        for (HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
+        for (FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
              j != i->second_.resources_.End();)
         {
-            HashMap<StringHash, SharedPtr<Resource> >::Iterator current = j++;
-            if (current->second_->GetName().Contains(partialName))
+            if (j->second_->GetName().Contains(partialName))
             {
                 // If other references exist, do not release, unless forced
-                if ((current->second_.Refs() == 1 && current->second_.WeakRefs() == 0) || force)
+                if ((j->second_.Refs() == 1 && j->second_.WeakRefs() == 0) || force)
                 {
-                    i->second_.resources_.Erase(current);
+                    j = i->second_.resources_.Erase(j);
                     released = true;
                 }
+                else
+                    ++j;
             }
+            else
+                ++j;
         }
     }
 
@@ -320,19 +324,22 @@ void ResourceCache::ReleaseResources(const String& partialName, bool force)
 
         for (HashMap<StringHash, ResourceGroup>::Iterator i = resourceGroups_.Begin(); i != resourceGroups_.End(); ++i)
         {
-            for (HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
+            for (FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
                  j != i->second_.resources_.End();)
             {
-                HashMap<StringHash, SharedPtr<Resource> >::Iterator current = j++;
-                if (current->second_->GetName().Contains(partialName))
+                if (j->second_->GetName().Contains(partialName))
                 {
                     // If other references exist, do not release, unless forced
-                    if ((current->second_.Refs() == 1 && current->second_.WeakRefs() == 0) || force)
+                    if ((j->second_.Refs() == 1 && j->second_.WeakRefs() == 0) || force)
                     {
-                        i->second_.resources_.Erase(current);
+                        j = i->second_.resources_.Erase(j);
                         released = true;
                     }
+                    else
+                        ++j;
                 }
+                else
+                    ++j;
             }
             if (released)
                 UpdateResourceGroup(i->first_);
@@ -351,16 +358,17 @@ void ResourceCache::ReleaseAllResources(bool force)
         for (HashMap<StringHash, ResourceGroup>::Iterator i = resourceGroups_.Begin();
              i != resourceGroups_.End(); ++i)
         {
-            for (HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
+            for (FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
                  j != i->second_.resources_.End();)
             {
-                HashMap<StringHash, SharedPtr<Resource> >::Iterator current = j++;
                 // If other references exist, do not release, unless forced
-                if ((current->second_.Refs() == 1 && current->second_.WeakRefs() == 0) || force)
+                if ((j->second_.Refs() == 1 && j->second_.WeakRefs() == 0) || force)
                 {
-                    i->second_.resources_.Erase(current);
+                    j = i->second_.resources_.Erase(j);
                     released = true;
                 }
+                else
+                    ++j;
             }
             if (released)
                 UpdateResourceGroup(i->first_);
@@ -399,7 +407,8 @@ void ResourceCache::ReloadResourceWithDependencies(const String& fileName)
 {
     StringHash fileNameHash(fileName);
     // If the filename is a resource we keep track of, reload it
-    const SharedPtr<Resource>& resource = FindResource(fileNameHash);
+    // Copy the pointer, as reloading may load other resources and move the cached ones
+    SharedPtr<Resource> resource = FindResource(fileNameHash);
     if (resource)
     {
         URHO3D_LOGDEBUG("Reloading changed resource " + fileName);
@@ -723,7 +732,7 @@ void ResourceCache::GetResources(PODVector<Resource*>& result, StringHash type)
     HashMap<StringHash, ResourceGroup>::ConstIterator i = resourceGroups_.Find(type);
     if (i != resourceGroups_.End())
     {
-        for (HashMap<StringHash, SharedPtr<Resource> >::ConstIterator j = i->second_.resources_.Begin();
+        for (FlatHashMap<StringHash, SharedPtr<Resource> >::ConstIterator j = i->second_.resources_.Begin();
              j != i->second_.resources_.End(); ++j)
             result.Push(j->second_);
     }
@@ -932,7 +941,7 @@ String ResourceCache::PrintMemoryUsage() const
         else
             average = 0;
         unsigned long long largest = 0;
-        for (HashMap<StringHash, SharedPtr<Resource> >::ConstIterator resIt = cit->second_.resources_.Begin(); resIt != cit->second_.resources_.End(); ++resIt)
+        for (FlatHashMap<StringHash, SharedPtr<Resource> >::ConstIterator resIt = cit->second_.resources_.Begin(); resIt != cit->second_.resources_.End(); ++resIt)
         {
             if (resIt->second_->GetMemoryUse() > largest)
                 largest = resIt->second_->GetMemoryUse();
@@ -979,7 +988,7 @@ const SharedPtr<Resource>& ResourceCache::FindResource(StringHash type, StringHa
     HashMap<StringHash, ResourceGroup>::Iterator i = resourceGroups_.Find(type);
     if (i == resourceGroups_.End())
         return noResource;
-    HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Find(nameHash);
+    FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Find(nameHash);
     if (j == i->second_.resources_.End())
         return noResource;
 
@@ -992,7 +1001,7 @@ const SharedPtr<Resource>& ResourceCache::FindResource(StringHash nameHash)
 
     for (HashMap<StringHash, ResourceGroup>::Iterator i = resourceGroups_.Begin(); i != resourceGroups_.End(); ++i)
     {
-        HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Find(nameHash);
+        FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Find(nameHash);
         if (j != i->second_.resources_.End())
             return j->second_;
     }
@@ -1012,7 +1021,7 @@ void ResourceCache::ReleasePackageResources(PackageFile* package, bool force)
         // We do not know the actual resource type, so search all type containers
         for (HashMap<StringHash, ResourceGroup>::Iterator j = resourceGroups_.Begin(); j != resourceGroups_.End(); ++j)
         {
-            HashMap<StringHash, SharedPtr<Resource> >::Iterator k = j->second_.resources_.Find(nameHash);
+            FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator k = j->second_.resources_.Find(nameHash);
             if (k != j->second_.resources_.End())
             {
                 // If other references exist, do not release, unless forced
@@ -1040,9 +1049,9 @@ void ResourceCache::UpdateResourceGroup(StringHash type)
     {
         unsigned totalSize = 0;
         unsigned oldestTimer = 0;
-        HashMap<StringHash, SharedPtr<Resource> >::Iterator oldestResource = i->second_.resources_.End();
+        FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator oldestResource = i->second_.resources_.End();
 
-        for (HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
+        for (FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
              j != i->second_.resources_.End(); ++j)
         {
             totalSize += j->second_->GetMemoryUse();
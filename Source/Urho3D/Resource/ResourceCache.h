@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "../Container/FlatHashMap.h"
 #include "../Container/HashSet.h"
 #include "../Container/List.h"
 #include "../Core/Mutex.h"
@@ -55,7 +56,7 @@ struct ResourceGroup
     /// Current memory use.
     unsigned long long memoryUse_;
     /// Resources.
-    HashMap<StringHash, SharedPtr<Resource> > resources_;
+    FlatHashMap<StringHash, SharedPtr<Resource> > resources_;
 };
 
 /// Resource request types.
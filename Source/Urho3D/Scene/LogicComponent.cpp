@@ -37,8 +37,11 @@ LogicComponent::LogicComponent(Context* context) :
     Component(context),
     updateEventMask_(USE_UPDATE | USE_POSTUPDATE | USE_FIXEDUPDATE | USE_FIXEDPOSTUPDATE),
     currentEventMask_(0),
-    delayedStartCalled_(false)
+    delayedStartCalled_(false),
+    threadSafeUpdate_(false)
 {
+    for (unsigned& index : threadedUpdateIndices_)
+        index = M_MAX_UNSIGNED;
 }
 
 LogicComponent::~LogicComponent() = default;
@@ -73,6 +76,15 @@ void LogicComponent::SetUpdateEventMask(UpdateEventFlags mask)
     }
 }
 
+void LogicComponent::SetThreadSafeUpdate(bool enable)
+{
+    if (threadSafeUpdate_ != enable)
+    {
+        threadSafeUpdate_ = enable;
+        UpdateEventSubscription();
+    }
+}
+
 void LogicComponent::OnNodeSet(Node* node)
 {
     if (node)
@@ -110,30 +122,36 @@ void LogicComponent::UpdateEventSubscription()
         return;
 
     bool enabled = IsEnabledEffective();
+    // Thread-safe components are updated by the scene instead of events once the delayed start has been called
+    bool threaded = threadSafeUpdate_ && delayedStartCalled_;
 
     bool needUpdate = enabled && ((updateEventMask_ & USE_UPDATE) || !delayedStartCalled_);
-    if (needUpdate && !(currentEventMask_ & USE_UPDATE))
+    bool needUpdateEvent = needUpdate && !threaded;
+    if (needUpdateEvent && !(currentEventMask_ & USE_UPDATE))
     {
         SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(LogicComponent, HandleSceneUpdate));
         currentEventMask_ |= USE_UPDATE;
     }
-    else if (!needUpdate && (currentEventMask_ & USE_UPDATE))
+    else if (!needUpdateEvent && (currentEventMask_ & USE_UPDATE))
     {
         UnsubscribeFromEvent(scene, E_SCENEUPDATE);
         currentEventMask_ &= ~USE_UPDATE;
     }
+    scene->SetThreadedLogicUpdate(this, USE_UPDATE, needUpdate && threaded);
 
     bool needPostUpdate = enabled && (updateEventMask_ & USE_POSTUPDATE);
-    if (needPostUpdate && !(currentEventMask_ & USE_POSTUPDATE))
+    bool needPostUpdateEvent = needPostUpdate && !threaded;
+    if (needPostUpdateEvent && !(currentEventMask_ & USE_POSTUPDATE))
     {
         SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(LogicComponent, HandleScenePostUpdate));
         currentEventMask_ |= USE_POSTUPDATE;
     }
-    else if (!needPostUpdate && (currentEventMask_ & USE_POSTUPDATE))
+    else if (!needPostUpdateEvent && (currentEventMask_ & USE_POSTUPDATE))
     {
         UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
         currentEventMask_ &= ~USE_POSTUPDATE;
     }
+    scene->SetThreadedLogicUpdate(this, USE_POSTUPDATE, needPostUpdate && threaded);
 
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
     Component* world = GetFixedUpdateSource();
@@ -141,28 +159,32 @@ void LogicComponent::UpdateEventSubscription()
         return;
 
     bool needFixedUpdate = enabled && (updateEventMask_ & USE_FIXEDUPDATE);
-    if (needFixedUpdate && !(currentEventMask_ & USE_FIXEDUPDATE))
+    bool needFixedUpdateEvent = needFixedUpdate && !threaded;
+    if (needFixedUpdateEvent && !(currentEventMask_ & USE_FIXEDUPDATE))
     {
         SubscribeToEvent(world, E_PHYSICSPRESTEP, URHO3D_HANDLER(LogicComponent, HandlePhysicsPreStep));
         currentEventMask_ |= USE_FIXEDUPDATE;
     }
-    else if (!needFixedUpdate && (currentEventMask_ & USE_FIXEDUPDATE))
+    else if (!needFixedUpdateEvent && (currentEventMask_ & USE_FIXEDUPDATE))
     {
         UnsubscribeFromEvent(world, E_PHYSICSPRESTEP);
         currentEventMask_ &= ~USE_FIXEDUPDATE;
     }
+    scene->SetThreadedLogicUpdate(this, USE_FIXEDUPDATE, needFixedUpdate && threaded);
 
     bool needFixedPostUpdate = enabled && (updateEventMask_ & USE_FIXEDPOSTUPDATE);
-    if (needFixedPostUpdate && !(currentEventMask_ & USE_FIXEDPOSTUPDATE))
+    bool needFixedPostUpdateEvent = needFixedPostUpdate && !threaded;
+    if (needFixedPostUpdateEvent && !(currentEventMask_ & USE_FIXEDPOSTUPDATE))
     {
         SubscribeToEvent(world, E_PHYSICSPOSTSTEP, URHO3D_HANDLER(LogicComponent, HandlePhysicsPostStep));
         currentEventMask_ |= USE_FIXEDPOSTUPDATE;
     }
-    else if (!needFixedPostUpdate && (currentEventMask_ & USE_FIXEDPOSTUPDATE))
+    else if (!needFixedPostUpdateEvent && (currentEventMask_ & USE_FIXEDPOSTUPDATE))
     {
         UnsubscribeFromEvent(world, E_PHYSICSPOSTSTEP);
         currentEventMask_ &= ~USE_FIXEDPOSTUPDATE;
     }
+    scene->SetThreadedLogicUpdate(this, USE_FIXEDPOSTUPDATE, needFixedPostUpdate && threaded);
 #endif
 }
 
@@ -176,6 +198,13 @@ void LogicComponent::HandleSceneUpdate(StringHash eventType, VariantMap& eventDa
         DelayedStart();
         delayedStartCalled_ = true;
 
+        // If thread-safe, move to the scene's threaded update, which calls Update() after this event
+        if (threadSafeUpdate_)
+        {
+            UpdateEventSubscription();
+            return;
+        }
+
         // If did not need actual update events, unsubscribe now
         if (!(updateEventMask_ & USE_UPDATE))
         {
@@ -208,6 +237,14 @@ void LogicComponent::HandlePhysicsPreStep(StringHash eventType, VariantMap& even
     {
         DelayedStart();
         delayedStartCalled_ = true;
+
+        // If thread-safe, move to the scene's threaded update, which calls FixedUpdate() after the event has been sent to this
+        // component
+        if (threadSafeUpdate_)
+        {
+            UpdateEventSubscription();
+            return;
+        }
     }
 
     // Execute user-defined fixed update function
@@ -45,11 +45,16 @@ enum UpdateEvent : unsigned
 };
 URHO3D_FLAGSET(UpdateEvent, UpdateEventFlags);
 
+/// Number of update events, which are also the phases of the threaded logic update.
+static const unsigned NUM_UPDATE_EVENTS = 4;
+
 /// Helper base class for user-defined game logic components that hooks up to update events and forwards them to virtual functions similar to ScriptInstance class.
 class URHO3D_API LogicComponent : public Component
 {
     URHO3D_OBJECT(LogicComponent, Component);
 
+    friend class Scene;
+
     /// Construct.
     explicit LogicComponent(Context* context);
     /// Destruct.
@@ -78,9 +83,13 @@ class URHO3D_API LogicComponent : public Component
 
     /// Set what update events should be subscribed to. Use this for optimization: by default all are in use. Note that this is not an attribute and is not saved or network-serialized, therefore it should always be called eg. in the subclass constructor.
     void SetUpdateEventMask(UpdateEventFlags mask);
+    /// Set whether the update functions are thread-safe. After DelayedStart() has been called in the main thread, thread-safe components are not updated through events, but by the scene in the worker threads after each update event, in parallel with each other. The update functions may then only modify the component itself and its own node hierarchy, and must not send events, enable or disable components, or create or remove nodes and components. Like the update event mask, this is not an attribute.
+    void SetThreadSafeUpdate(bool enable);
 
     /// Return what update events are subscribed to.
     UpdateEventFlags GetUpdateEventMask() const { return updateEventMask_; }
+    /// Return whether the update functions are thread-safe.
+    bool IsThreadSafeUpdate() const { return threadSafeUpdate_; }
 
     /// Return whether the DelayedStart() function has been called.
     bool IsDelayedStartCalled() const { return delayedStartCalled_; }
@@ -108,8 +117,12 @@ private:
     UpdateEventFlags updateEventMask_;
     /// Current event subscription mask.
     UpdateEventFlags currentEventMask_;
+    /// Indices in the scene's threaded logic update of each update event, M_MAX_UNSIGNED if not updated by the scene.
+    unsigned threadedUpdateIndices_[NUM_UPDATE_EVENTS];
     /// Flag for delayed start.
     bool delayedStartCalled_;
+    /// Thread-safe update flag.
+    bool threadSafeUpdate_;
 };
 
 }
@@ -48,6 +48,7 @@ namespace Urho3D
 Node::Node(Context* context) :
     Animatable(context),
     worldTransform_(Matrix3x4::IDENTITY),
+    transformIndex_(M_MAX_UNSIGNED),
     dirty_(false),
     enabled_(true),
     enabledPrev_(true),
@@ -740,6 +741,7 @@ void Node::SetOwner(Connection* owner)
 
 void Node::MarkDirty()
 {
+    TransformStore* transformStore = scene_ ? scene_->GetTransformStore() : nullptr;
     Node *cur = this;
     for (;;)
     {
@@ -753,6 +755,8 @@ void Node::MarkDirty()
         if (cur->dirty_)
             return;
         cur->dirty_ = true;
+        if (transformStore)
+            transformStore->MarkDirty(cur, cur->transformIndex_);
 
         // Notify listener components first, then mark child nodes
         for (Vector<WeakPtr<Component> >::Iterator i = cur->listeners_.Begin(); i != cur->listeners_.End();)
@@ -837,6 +841,8 @@ void Node::AddChild(Node* node, unsigned index)
 
     // Add to the child vector, then add to the scene if not added yet
     children_.Insert(index, nodeShared);
+    if (scene_ && scene_->GetTransformStore())
+        scene_->GetTransformStore()->MarkStructureDirty();
     if (scene_ && node->GetScene() != scene_)
         scene_->NodeAdded(node);
 
@@ -2128,6 +2134,8 @@ void Node::RemoveChild(Vector<SharedPtr<Node> >::Iterator i)
         scene_->NodeRemoved(child);
 
     children_.Erase(i);
+    if (scene_ && scene_->GetTransformStore())
+        scene_->GetTransformStore()->MarkStructureDirty();
 }
 
 void Node::GetChildrenRecursive(PODVector<Node*>& dest) const
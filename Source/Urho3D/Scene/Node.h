@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "../Container/SmallVector.h"
 #include "../IO/VectorBuffer.h"
 #include "../Math/Matrix3x4.h"
 #include "../Scene/Animatable.h"
@@ -36,6 +37,7 @@ class Connection;
 class Node;
 class Scene;
 class SceneResolver;
+class TransformStore;
 
 struct NodeReplicationState;
 
@@ -77,6 +79,8 @@ class URHO3D_API Node : public Animatable
     URHO3D_OBJECT(Node, Animatable);
 
     friend class Connection;
+    friend class Scene;
+    friend class TransformStore;
 
 public:
     /// Construct.
@@ -667,6 +671,8 @@ private:
 
     /// World-space transform matrix.
     mutable Matrix3x4 worldTransform_;
+    /// Index in the scene's transform store.
+    unsigned transformIndex_;
     /// World transform needs update flag.
     mutable bool dirty_;
     /// Enabled flag.
@@ -694,7 +700,7 @@ private:
     /// World-space rotation.
     mutable Quaternion worldRotation_;
     /// Components.
-    Vector<SharedPtr<Component> > components_;
+    SmallVector<SharedPtr<Component>, 4> components_;
     /// Child scene nodes.
     Vector<SharedPtr<Node> > children_;
     /// Node listeners.
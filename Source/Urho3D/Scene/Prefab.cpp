@@ -0,0 +1,403 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../Resource/JSONFile.h"
+#include "../Resource/ResourceCache.h"
+#include "../Resource/XMLFile.h"
+#include "../Scene/Prefab.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneResolver.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Find a file attribute by name, starting from the attribute after the previous match, as attributes are usually saved in order. Return M_MAX_UNSIGNED if not found.
+static unsigned FindFileAttribute(const Vector<AttributeInfo>& attributes, const String& name, unsigned& startIndex)
+{
+    unsigned i = startIndex;
+    for (unsigned attempts = attributes.Size(); attempts; --attempts)
+    {
+        const AttributeInfo& attr = attributes[i];
+        if ((attr.mode_ & AM_FILE) && !attr.name_.Compare(name, true))
+        {
+            startIndex = (i + 1) % attributes.Size();
+            return i;
+        }
+
+        i = (i + 1) % attributes.Size();
+    }
+
+    return M_MAX_UNSIGNED;
+}
+
+/// Return the integer value of an enum attribute by name, or empty if not found.
+static Variant GetEnumValue(const AttributeInfo& attr, const String& value)
+{
+    int enumValue = 0;
+    for (const char** enumPtr = attr.enumNames_; *enumPtr; ++enumPtr, ++enumValue)
+    {
+        if (!value.Compare(*enumPtr, false))
+            return enumValue;
+    }
+
+    URHO3D_LOGWARNING("Unknown enum value " + value + " in attribute " + attr.name_);
+    return Variant::EMPTY;
+}
+
+/// Set a range of prefab attribute values to an object.
+static void SetPrefabAttributes(Serializable* dest, const PrefabAttribute* start, const PrefabAttribute* end)
+{
+    const Vector<AttributeInfo>* attributes = dest->GetAttributes();
+    if (!attributes)
+        return;
+
+    for (; start != end; ++start)
+        dest->OnSetAttribute(attributes->At(start->index_), start->value_);
+}
+
+Prefab::Prefab(Context* context) :
+    Resource(context),
+    hasIDAttributes_(false)
+{
+}
+
+Prefab::~Prefab() = default;
+
+void Prefab::RegisterObject(Context* context)
+{
+    context->RegisterFactory<Prefab>();
+}
+
+bool Prefab::BeginLoad(Deserializer& source)
+{
+    bool success;
+    if (GetExtension(source.GetName()) == ".json")
+    {
+        JSONFile jsonFile(context_);
+        success = jsonFile.Load(source) && LoadJSON(jsonFile.GetRoot());
+    }
+    else
+    {
+        XMLFile xmlFile(context_);
+        success = xmlFile.Load(source) && LoadXML(xmlFile.GetRoot());
+    }
+
+    if (!success)
+        return false;
+
+    // If async loading, request the referenced resources to also be loaded, so that they are ready in EndLoad()
+    if (GetAsyncLoadState() == ASYNC_LOADING)
+        LoadResources(true);
+
+    return true;
+}
+
+bool Prefab::EndLoad()
+{
+    LoadResources(false);
+    return true;
+}
+
+bool Prefab::LoadXML(const XMLElement& source)
+{
+    ResetToDefaults();
+
+    if (source.IsNull())
+    {
+        URHO3D_LOGERROR("Could not load prefab " + GetName() + ", null source element");
+        return false;
+    }
+
+    LoadNodeXML(source);
+    SetMemoryUse(sizeof(Prefab) + nodes_.Size() * sizeof(PrefabNode) + components_.Size() * sizeof(PrefabComponent) +
+        attributes_.Size() * sizeof(PrefabAttribute));
+    return true;
+}
+
+bool Prefab::LoadJSON(const JSONValue& source)
+{
+    ResetToDefaults();
+
+    if (source.IsNull())
+    {
+        URHO3D_LOGERROR("Could not load prefab " + GetName() + ", null JSON source element");
+        return false;
+    }
+
+    LoadNodeJSON(source);
+    SetMemoryUse(sizeof(Prefab) + nodes_.Size() * sizeof(PrefabNode) + components_.Size() * sizeof(PrefabComponent) +
+        attributes_.Size() * sizeof(PrefabAttribute));
+    return true;
+}
+
+bool Prefab::Apply(Node* dest, CreateMode mode) const
+{
+    if (nodes_.Empty())
+    {
+        URHO3D_LOGERROR("Can not instantiate empty prefab " + GetName());
+        return false;
+    }
+
+    // The resolver has to remember every created node and component, so only use it if there are ID attributes to resolve
+    if (hasIDAttributes_)
+    {
+        SceneResolver resolver;
+        ApplyNode(0, dest, &resolver, mode);
+        resolver.Resolve();
+    }
+    else
+        ApplyNode(0, dest, nullptr, mode);
+
+    return true;
+}
+
+void Prefab::LoadNodeXML(const XMLElement& source)
+{
+    unsigned index = nodes_.Size();
+    PrefabNode node{};
+    node.id_ = source.GetUInt("id");
+    node.firstAttribute_ = attributes_.Size();
+    LoadAttributesXML(source, Node::GetTypeStatic());
+    node.numAttributes_ = attributes_.Size() - node.firstAttribute_;
+
+    node.firstComponent_ = components_.Size();
+    for (XMLElement compElem = source.GetChild("component"); compElem; compElem = compElem.GetNext("component"))
+    {
+        if (AddComponent(compElem.GetAttribute("type"), compElem.GetUInt("id")))
+        {
+            LoadAttributesXML(compElem, components_.Back().type_);
+            components_.Back().numAttributes_ = attributes_.Size() - components_.Back().firstAttribute_;
+        }
+    }
+    node.numComponents_ = components_.Size() - node.firstComponent_;
+    nodes_.Push(node);
+
+    for (XMLElement childElem = source.GetChild("node"); childElem; childElem = childElem.GetNext("node"))
+    {
+        LoadNodeXML(childElem);
+        ++nodes_[index].numChildren_;
+    }
+}
+
+void Prefab::LoadNodeJSON(const JSONValue& source)
+{
+    unsigned index = nodes_.Size();
+    PrefabNode node{};
+    node.id_ = source.Get("id").GetUInt();
+    node.firstAttribute_ = attributes_.Size();
+    LoadAttributesJSON(source, Node::GetTypeStatic());
+    node.numAttributes_ = attributes_.Size() - node.firstAttribute_;
+
+    node.firstComponent_ = components_.Size();
+    const JSONArray& componentsArray = source.Get("components").GetArray();
+    for (unsigned i = 0; i < componentsArray.Size(); ++i)
+    {
+        const JSONValue& compVal = componentsArray[i];
+        if (AddComponent(compVal.Get("type").GetString(), compVal.Get("id").GetUInt()))
+        {
+            LoadAttributesJSON(compVal, components_.Back().type_);
+            components_.Back().numAttributes_ = attributes_.Size() - components_.Back().firstAttribute_;
+        }
+    }
+    node.numComponents_ = components_.Size() - node.firstComponent_;
+    nodes_.Push(node);
+
+    const JSONArray& childrenArray = source.Get("children").GetArray();
+    for (unsigned i = 0; i < childrenArray.Size(); ++i)
+    {
+        LoadNodeJSON(childrenArray[i]);
+        ++nodes_[index].numChildren_;
+    }
+}
+
+void Prefab::LoadAttributesXML(const XMLElement& source, StringHash type)
+{
+    if (source.HasChild("objectanimation") || source.HasChild("attributeanimation"))
+        URHO3D_LOGWARNING("Attribute animations are not supported in prefab " + GetName() + ", ignoring them");
+
+    const Vector<AttributeInfo>* attributes = context_->GetAttributes(type);
+    if (!attributes)
+        return;
+
+    unsigned startIndex = 0;
+    for (XMLElement attrElem = source.GetChild("attribute"); attrElem; attrElem = attrElem.GetNext("attribute"))
+    {
+        String name = attrElem.GetAttribute("name");
+        unsigned index = FindFileAttribute(*attributes, name, startIndex);
+        if (index == M_MAX_UNSIGNED)
+        {
+            URHO3D_LOGWARNING("Unknown attribute " + name + " in XML data");
+            continue;
+        }
+
+        const AttributeInfo& attr = attributes->At(index);
+        Variant value = attr.enumNames_ ? GetEnumValue(attr, attrElem.GetAttribute("value")) : attrElem.GetVariantValue(attr.type_);
+        if (!value.IsEmpty())
+            attributes_.Push(PrefabAttribute{index, value});
+    }
+}
+
+void Prefab::LoadAttributesJSON(const JSONValue& source, StringHash type)
+{
+    if (!source.Get("objectanimation").IsNull() || !source.Get("attributeanimation").IsNull())
+        URHO3D_LOGWARNING("Attribute animations are not supported in prefab " + GetName() + ", ignoring them");
+
+    const Vector<AttributeInfo>* attributes = context_->GetAttributes(type);
+    const JSONValue& attributesValue = source.Get("attributes");
+    if (!attributes || !attributesValue.IsObject())
+        return;
+
+    unsigned startIndex = 0;
+    const JSONObject& attributesObject = attributesValue.GetObject();
+    for (JSONObject::ConstIterator i = attributesObject.Begin(); i != attributesObject.End(); ++i)
+    {
+        unsigned index = FindFileAttribute(*attributes, i->first_, startIndex);
+        if (index == M_MAX_UNSIGNED)
+        {
+            URHO3D_LOGWARNING("Unknown attribute " + i->first_ + " in JSON data");
+            continue;
+        }
+
+        const AttributeInfo& attr = attributes->At(index);
+        Variant value = attr.enumNames_ ? GetEnumValue(attr, i->second_.GetString()) : i->second_.GetVariantValue(attr.type_);
+        if (!value.IsEmpty())
+            attributes_.Push(PrefabAttribute{index, value});
+    }
+}
+
+bool Prefab::AddComponent(const String& typeName, unsigned id)
+{
+    StringHash type(typeName);
+    if (context_->GetTypeName(type).Empty())
+    {
+        URHO3D_LOGWARNING("Component type " + typeName + " not known, skipping it in prefab " + GetName());
+        return false;
+    }
+
+    PrefabComponent component{};
+    component.type_ = type;
+    component.id_ = id;
+    component.firstAttribute_ = attributes_.Size();
+    components_.Push(component);
+
+    const Vector<AttributeInfo>* attributes = context_->GetAttributes(type);
+    if (attributes)
+    {
+        for (Vector<AttributeInfo>::ConstIterator i = attributes->Begin(); i != attributes->End(); ++i)
+        {
+            if (i->mode_ & (AM_NODEID | AM_COMPONENTID | AM_NODEIDVECTOR))
+                hasIDAttributes_ = true;
+        }
+    }
+
+    return true;
+}
+
+unsigned Prefab::ApplyNode(unsigned index, Node* dest, SceneResolver* resolver, CreateMode mode) const
+{
+    const PrefabNode& node = nodes_[index];
+    if (resolver)
+        resolver->AddNode(node.id_, dest);
+
+    const PrefabAttribute* attributes = attributes_.Buffer();
+    SetPrefabAttributes(dest, attributes + node.firstAttribute_, attributes + node.firstAttribute_ + node.numAttributes_);
+
+    for (unsigned i = node.firstComponent_; i < node.firstComponent_ + node.numComponents_; ++i)
+    {
+        const PrefabComponent& component = components_[i];
+        Component* newComponent = dest->CreateComponent(component.type_,
+            (mode == REPLICATED && Scene::IsReplicatedID(component.id_)) ? REPLICATED : LOCAL);
+        if (newComponent)
+        {
+            if (resolver)
+                resolver->AddComponent(component.id_, newComponent);
+            SetPrefabAttributes(newComponent, attributes + component.firstAttribute_, attributes + component.firstAttribute_ +
+                component.numAttributes_);
+        }
+    }
+
+    // The children follow the node, each followed by its own children
+    ++index;
+    for (unsigned i = 0; i < node.numChildren_; ++i)
+    {
+        unsigned childID = nodes_[index].id_;
+        Node* child = dest->CreateChild(0, (mode == REPLICATED && Scene::IsReplicatedID(childID)) ? REPLICATED : LOCAL);
+        index = ApplyNode(index, child, resolver, mode);
+    }
+
+    return index;
+}
+
+void Prefab::LoadResources(bool background)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    if (!cache)
+        return;
+
+    for (Vector<PrefabAttribute>::ConstIterator i = attributes_.Begin(); i != attributes_.End(); ++i)
+    {
+        if (i->value_.GetType() == VAR_RESOURCEREF)
+        {
+            const ResourceRef& ref = i->value_.GetResourceRef();
+            LoadResource(cache, ref.type_, ref.name_, background);
+        }
+        else if (i->value_.GetType() == VAR_RESOURCEREFLIST)
+        {
+            const ResourceRefList& refList = i->value_.GetResourceRefList();
+            for (unsigned j = 0; j < refList.names_.Size(); ++j)
+                LoadResource(cache, refList.type_, refList.names_[j], background);
+        }
+    }
+}
+
+void Prefab::LoadResource(ResourceCache* cache, StringHash type, const String& name, bool background)
+{
+    if (name.Empty())
+        return;
+
+    if (background)
+        cache->BackgroundLoadResource(type, name, true, this);
+    else
+    {
+        SharedPtr<Resource> resource(cache->GetResource(type, name));
+        if (resource && !resources_.Contains(resource))
+            resources_.Push(resource);
+    }
+}
+
+void Prefab::ResetToDefaults()
+{
+    nodes_.Clear();
+    components_.Clear();
+    attributes_.Clear();
+    resources_.Clear();
+    hasIDAttributes_ = false;
+}
+
+}
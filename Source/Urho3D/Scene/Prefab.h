@@ -0,0 +1,144 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Resource/Resource.h"
+#include "../Scene/Node.h"
+
+namespace Urho3D
+{
+
+class JSONValue;
+class ResourceCache;
+class XMLElement;
+
+/// Attribute value in a prefab, with the attribute index resolved at load time.
+struct PrefabAttribute
+{
+    /// Index in the attributes of the object type.
+    unsigned index_;
+    /// Attribute value.
+    Variant value_;
+};
+
+/// Component in a prefab.
+struct PrefabComponent
+{
+    /// Component type.
+    StringHash type_;
+    /// Component ID in the prefab file.
+    unsigned id_;
+    /// Index of the first attribute.
+    unsigned firstAttribute_;
+    /// Number of attributes.
+    unsigned numAttributes_;
+};
+
+/// Node in a prefab. Nodes are stored in depth-first order, so the children of a node follow it.
+struct PrefabNode
+{
+    /// Node ID in the prefab file.
+    unsigned id_;
+    /// Index of the first attribute.
+    unsigned firstAttribute_;
+    /// Number of attributes.
+    unsigned numAttributes_;
+    /// Index of the first component.
+    unsigned firstComponent_;
+    /// Number of components.
+    unsigned numComponents_;
+    /// Number of child nodes.
+    unsigned numChildren_;
+};
+
+/// Object prefab resource. Loads a node hierarchy from the same XML or JSON data as Scene::InstantiateXML() and Scene::InstantiateJSON(), with the attribute names, enum values and attribute types resolved once at load time, and keeps the referenced resources loaded, so that instantiation only creates the objects and sets the attribute values.
+class URHO3D_API Prefab : public Resource
+{
+    URHO3D_OBJECT(Prefab, Resource);
+
+public:
+    /// Construct.
+    explicit Prefab(Context* context);
+    /// Destruct.
+    ~Prefab() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Load resource from stream. May be called from a worker thread. Return true if successful.
+    bool BeginLoad(Deserializer& source) override;
+    /// Finish resource loading. Always called from the main thread. Return true if successful.
+    bool EndLoad() override;
+    /// Load from XML data. Return true if successful.
+    bool LoadXML(const XMLElement& source);
+    /// Load from JSON data. Return true if successful.
+    bool LoadJSON(const JSONValue& source);
+
+    /// Create the attributes, components and child nodes of the prefab in a node created for it, and resolve the node and component ID attributes. Does not apply the attributes. Called by Scene::InstantiatePrefab(). Return true if successful.
+    bool Apply(Node* dest, CreateMode mode) const;
+
+    /// Return number of nodes.
+    unsigned GetNumNodes() const { return nodes_.Size(); }
+    /// Return number of components.
+    unsigned GetNumComponents() const { return components_.Size(); }
+    /// Return nodes in depth-first order.
+    const PODVector<PrefabNode>& GetNodes() const { return nodes_; }
+    /// Return components.
+    const PODVector<PrefabComponent>& GetComponents() const { return components_; }
+    /// Return attribute values of the nodes and components.
+    const Vector<PrefabAttribute>& GetAttributes() const { return attributes_; }
+
+private:
+    /// Load a node and its children from XML data.
+    void LoadNodeXML(const XMLElement& source);
+    /// Load a node and its children from JSON data.
+    void LoadNodeJSON(const JSONValue& source);
+    /// Load the attributes of a node or component from XML data.
+    void LoadAttributesXML(const XMLElement& source, StringHash type);
+    /// Load the attributes of a node or component from JSON data.
+    void LoadAttributesJSON(const JSONValue& source, StringHash type);
+    /// Add a component and check whether its type has node or component ID attributes.
+    bool AddComponent(const String& typeName, unsigned id);
+    /// Create a node's attributes, components and child nodes recursively. Return the index of the next node.
+    unsigned ApplyNode(unsigned index, Node* dest, SceneResolver* resolver, CreateMode mode) const;
+    /// Load the resources referenced by the attributes, or request them to be loaded in the background.
+    void LoadResources(bool background);
+    /// Load a referenced resource and keep it, or request it to be loaded in the background.
+    void LoadResource(ResourceCache* cache, StringHash type, const String& name, bool background);
+    /// Reset to empty.
+    void ResetToDefaults();
+
+    /// Nodes in depth-first order.
+    PODVector<PrefabNode> nodes_;
+    /// Components.
+    PODVector<PrefabComponent> components_;
+    /// Attribute values of the nodes and components.
+    Vector<PrefabAttribute> attributes_;
+    /// Referenced resources, kept loaded.
+    Vector<SharedPtr<Resource> > resources_;
+    /// Whether the component types have node or component ID attributes, which need to be resolved.
+    bool hasIDAttributes_;
+};
+
+}
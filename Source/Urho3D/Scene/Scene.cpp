@@ -25,16 +25,24 @@
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/Timer.h"
 #include "../Core/WorkQueue.h"
 #include "../IO/File.h"
 #include "../IO/Log.h"
+#include "../IO/MappedFile.h"
+#include "../IO/MemoryBuffer.h"
 #include "../IO/PackageFile.h"
+#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
+#include "../Physics/PhysicsEvents.h"
+#endif
 #include "../Resource/ResourceCache.h"
 #include "../Resource/ResourceEvents.h"
 #include "../Resource/XMLFile.h"
 #include "../Resource/JSONFile.h"
 #include "../Scene/Component.h"
 #include "../Scene/ObjectAnimation.h"
+#include "../Scene/Prefab.h"
 #include "../Scene/ReplicationState.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
@@ -54,6 +62,223 @@ const char* SUBSYSTEM_CATEGORY = "Subsystem";
 
 static const float DEFAULT_SMOOTHING_CONSTANT = 50.0f;
 static const float DEFAULT_SNAP_THRESHOLD = 5.0f;
+/// Default minimum time in microseconds from freeing a node or component ID until it is reused.
+static const long long DEFAULT_FREED_ID_REUSE_DELAY = 10000000;
+/// Minimum number of thread-safe logic components per work item.
+static const unsigned MIN_LOGIC_COMPONENTS_PER_ITEM = 16;
+
+/// Update event and timestep of a threaded logic update.
+struct ThreadedLogicUpdate
+{
+    /// Update event.
+    UpdateEvent updateEvent_;
+    /// Timestep.
+    float timeStep_;
+};
+
+static void UpdateLogicComponentsWork(const WorkItem* item, unsigned /*threadIndex*/)
+{
+    const ThreadedLogicUpdate& update = *reinterpret_cast<ThreadedLogicUpdate*>(item->aux_);
+    auto** start = reinterpret_cast<LogicComponent**>(item->start_);
+    auto** end = reinterpret_cast<LogicComponent**>(item->end_);
+
+    switch (update.updateEvent_)
+    {
+    case USE_UPDATE:
+        while (start != end)
+            (*start++)->Update(update.timeStep_);
+        break;
+
+    case USE_POSTUPDATE:
+        while (start != end)
+            (*start++)->PostUpdate(update.timeStep_);
+        break;
+
+    case USE_FIXEDUPDATE:
+        while (start != end)
+            (*start++)->FixedUpdate(update.timeStep_);
+        break;
+
+    case USE_FIXEDPOSTUPDATE:
+        while (start != end)
+            (*start++)->FixedPostUpdate(update.timeStep_);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/// Mapped scene format version.
+static const unsigned MAPPED_SCENE_VERSION = 1;
+/// Attribute count of an object type that is saved with Serializable::Save() because it has instance-specific attributes.
+static const unsigned MAPPED_SCENE_STREAM_TYPE = M_MAX_UNSIGNED;
+
+/// Attribute of an object type in the mapped scene format.
+struct MappedSceneAttribute
+{
+    /// Registered attribute, or null if not found and to be skipped.
+    const AttributeInfo* attr_;
+    /// Attribute type in the file.
+    VariantType type_;
+    /// Attribute size in the file, or 0 if not fixed.
+    unsigned size_;
+};
+
+/// Object type in the mapped scene format.
+struct MappedSceneType
+{
+    /// Type hash.
+    StringHash type_;
+    /// Whether the objects are saved with Serializable::Save() instead of the attribute schema.
+    bool stream_;
+    /// Attribute schema.
+    PODVector<MappedSceneAttribute> attributes_;
+};
+
+static void AddMappedSceneType(const Serializable* object, Vector<MappedSceneType>& types, HashMap<StringHash, unsigned>& typeIndices)
+{
+    StringHash type = object->GetType();
+    const Vector<AttributeInfo>* attributes = object->GetContext()->GetAttributes(type);
+    // Objects such as script instances may have attributes of their own, which do not fit a schema of the type
+    bool stream = object->GetAttributes() != attributes;
+
+    HashMap<StringHash, unsigned>::ConstIterator i = typeIndices.Find(type);
+    if (i != typeIndices.End())
+    {
+        MappedSceneType& existing = types[i->second_];
+        if (stream && !existing.stream_)
+        {
+            existing.stream_ = true;
+            existing.attributes_.Clear();
+        }
+        return;
+    }
+
+    typeIndices[type] = types.Size();
+    types.Resize(types.Size() + 1);
+    MappedSceneType& newType = types.Back();
+    newType.type_ = type;
+    newType.stream_ = stream;
+    if (stream || !attributes)
+        return;
+
+    for (unsigned j = 0; j < attributes->Size(); ++j)
+    {
+        const AttributeInfo& attr = attributes->At(j);
+        if (!(attr.mode_ & AM_FILE) || (attr.mode_ & AM_FILEREADONLY) == AM_FILEREADONLY)
+            continue;
+        newType.attributes_.Push(MappedSceneAttribute{&attr, attr.type_, GetFixedAttributeSize(attr.type_)});
+    }
+}
+
+static void CollectMappedSceneTypes(const Node* node, Vector<MappedSceneType>& types, HashMap<StringHash, unsigned>& typeIndices)
+{
+    AddMappedSceneType(node, types, typeIndices);
+
+    const Vector<SharedPtr<Component> >& components = node->GetComponents();
+    for (unsigned i = 0; i < components.Size(); ++i)
+    {
+        if (!components[i]->IsTemporary())
+            AddMappedSceneType(components[i], types, typeIndices);
+    }
+
+    const Vector<SharedPtr<Node> >& children = node->GetChildren();
+    for (unsigned i = 0; i < children.Size(); ++i)
+    {
+        if (!children[i]->IsTemporary())
+            CollectMappedSceneTypes(children[i], types, typeIndices);
+    }
+}
+
+static bool WriteMappedObjectData(Serializer& dest, VectorBuffer& buffer)
+{
+    return dest.WriteUInt(buffer.GetSize()) && dest.Write(buffer.GetData(), buffer.GetSize()) == buffer.GetSize();
+}
+
+static bool WriteMappedNode(Serializer& dest, const Node* node, const Vector<MappedSceneType>& types,
+    const HashMap<StringHash, unsigned>& typeIndices, VectorBuffer& buffer)
+{
+    dest.WriteUInt(*typeIndices[node->GetType()]);
+    dest.WriteUInt(node->GetID());
+    // Write the attributes only, without the components and child nodes
+    buffer.Clear();
+    if (!node->Serializable::Save(buffer) || !WriteMappedObjectData(dest, buffer))
+        return false;
+
+    const Vector<SharedPtr<Component> >& components = node->GetComponents();
+    dest.WriteUInt(node->GetNumPersistentComponents());
+    for (unsigned i = 0; i < components.Size(); ++i)
+    {
+        Component* component = components[i];
+        if (component->IsTemporary())
+            continue;
+
+        unsigned typeIndex = *typeIndices[component->GetType()];
+        dest.WriteUInt(typeIndex);
+        dest.WriteUInt(component->GetID());
+        buffer.Clear();
+        // Stream type components are saved whole, including their type and ID, as in the binary scene format
+        if (!(types[typeIndex].stream_ ? component->Save(buffer) : component->Serializable::Save(buffer)) ||
+            !WriteMappedObjectData(dest, buffer))
+            return false;
+    }
+
+    const Vector<SharedPtr<Node> >& children = node->GetChildren();
+    dest.WriteUInt(node->GetNumPersistentChildren());
+    for (unsigned i = 0; i < children.Size(); ++i)
+    {
+        if (!children[i]->IsTemporary() && !WriteMappedNode(dest, children[i], types, typeIndices, buffer))
+            return false;
+    }
+
+    return true;
+}
+
+static inline bool ReadMappedUInt(const unsigned char*& data, const unsigned char* end, unsigned& value)
+{
+    if (end - data < (ptrdiff_t)sizeof value)
+        return false;
+    memcpy(&value, data, sizeof value);
+    data += sizeof value;
+    return true;
+}
+
+static bool ReadMappedObjectData(const unsigned char*& data, const unsigned char* end, const unsigned char*& objectData,
+    unsigned& objectSize)
+{
+    if (!ReadMappedUInt(data, end, objectSize) || (unsigned)(end - data) < objectSize)
+        return false;
+    objectData = data;
+    data += objectSize;
+    return true;
+}
+
+static void LoadMappedAttributes(Serializable* object, const MappedSceneType& type, const unsigned char* data, unsigned size)
+{
+    const unsigned char* end = data + size;
+
+    for (PODVector<MappedSceneAttribute>::ConstIterator i = type.attributes_.Begin(); i != type.attributes_.End(); ++i)
+    {
+        if (i->size_)
+        {
+            if ((unsigned)(end - data) < i->size_)
+                break;
+            // Fixed-size attributes are set directly from the data, without a Variant if the accessor supports it
+            if (i->attr_)
+                object->OnSetAttributeData(*i->attr_, data);
+            data += i->size_;
+        }
+        else
+        {
+            MemoryBuffer buffer(data, (unsigned)(end - data));
+            Variant value = buffer.ReadVariant(i->type_);
+            if (i->attr_)
+                object->OnSetAttribute(*i->attr_, value);
+            data += buffer.GetPosition();
+        }
+    }
+}
 
 Scene::Scene(Context* context) :
     Node(context),
@@ -61,6 +286,8 @@ Scene::Scene(Context* context) :
     replicatedComponentID_(FIRST_REPLICATED_ID),
     localNodeID_(FIRST_LOCAL_ID),
     localComponentID_(FIRST_LOCAL_ID),
+    freedIDReuseDelay_(DEFAULT_FREED_ID_REUSE_DELAY),
+    freedIDTime_(0),
     checksum_(0),
     asyncLoadingMs_(5),
     timeScale_(1.0f),
@@ -87,9 +314,9 @@ Scene::~Scene()
     RemoveAllChildren();
 
     // Remove scene reference and owner from all nodes that still exist
-    for (HashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
+    for (FlatHashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
         i->second_->ResetScene();
-    for (HashMap<unsigned, Node*>::Iterator i = localNodes_.Begin(); i != localNodes_.End(); ++i)
+    for (FlatHashMap<unsigned, Node*>::Iterator i = localNodes_.Begin(); i != localNodes_.End(); ++i)
         i->second_->ResetScene();
 }
 
@@ -118,7 +345,8 @@ bool Scene::Load(Deserializer& source)
     StopAsyncLoading();
 
     // Check ID
-    if (source.ReadFileID() != "USCN")
+    String fileID = source.ReadFileID();
+    if (fileID != "USCN" && fileID != "USCM")
     {
         URHO3D_LOGERROR(source.GetName() + " is not a valid scene file");
         return false;
@@ -128,8 +356,18 @@ bool Scene::Load(Deserializer& source)
 
     Clear();
 
+    bool success;
+    if (fileID == "USCM")
+    {
+        // The mapped scene format is loaded from memory, so read the rest of the stream
+        PODVector<unsigned char> data(source.GetSize() - source.GetPosition());
+        success = source.Read(data.Buffer(), data.Size()) == data.Size() && LoadMappedData(data.Buffer(), data.Size());
+    }
+    else
+        success = Node::Load(source);
+
     // Load the whole scene, then perform post-load if successfully loaded
-    if (Node::Load(source))
+    if (success)
     {
         FinishLoading(&source);
         return true;
@@ -210,7 +448,7 @@ void Scene::AddReplicationState(NodeReplicationState* state)
     Node::AddReplicationState(state);
 
     // This is the first update for a new connection. Mark all replicated nodes dirty
-    for (HashMap<unsigned, Node*>::ConstIterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
+    for (FlatHashMap<unsigned, Node*>::ConstIterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
         state->sceneState_->dirtyNodes_.Insert(i->first_);
 }
 
@@ -306,6 +544,86 @@ bool Scene::SaveJSON(Serializer& dest, const String& indentation) const
         return false;
 }
 
+bool Scene::LoadMapped(const String& fileName)
+{
+    URHO3D_PROFILE(LoadSceneMapped);
+
+    StopAsyncLoading();
+
+    MappedFile file(context_);
+    if (!file.Open(fileName))
+        return false;
+
+    // Check ID
+    const unsigned char* data = file.GetData();
+    unsigned size = file.GetSize();
+    if (size < 4 || memcmp(data, "USCM", 4) != 0)
+    {
+        URHO3D_LOGERROR(fileName + " is not a valid mapped scene file");
+        return false;
+    }
+
+    URHO3D_LOGINFO("Loading scene from " + fileName);
+
+    Clear();
+
+    if (LoadMappedData(data + 4, size - 4))
+    {
+        // Calculate the same checksum as File
+        unsigned checksum = 0;
+        for (unsigned i = 0; i < size; ++i)
+            checksum = SDBMHash(checksum, data[i]);
+
+        fileName_ = fileName;
+        checksum_ = checksum;
+        return true;
+    }
+    else
+        return false;
+}
+
+bool Scene::SaveMapped(Serializer& dest) const
+{
+    URHO3D_PROFILE(SaveSceneMapped);
+
+    Vector<MappedSceneType> types;
+    HashMap<StringHash, unsigned> typeIndices;
+    CollectMappedSceneTypes(this, types, typeIndices);
+
+    // Write ID, version and the attribute schema of each object type
+    if (!dest.WriteFileID("USCM") || !dest.WriteUInt(MAPPED_SCENE_VERSION) || !dest.WriteUInt(types.Size()))
+    {
+        URHO3D_LOGERROR("Could not save scene, writing to stream failed");
+        return false;
+    }
+
+    auto* ptr = dynamic_cast<Deserializer*>(&dest);
+    if (ptr)
+        URHO3D_LOGINFO("Saving scene to " + ptr->GetName());
+
+    for (unsigned i = 0; i < types.Size(); ++i)
+    {
+        const MappedSceneType& type = types[i];
+        dest.WriteStringHash(type.type_);
+        dest.WriteUInt(type.stream_ ? MAPPED_SCENE_STREAM_TYPE : type.attributes_.Size());
+        for (unsigned j = 0; j < type.attributes_.Size(); ++j)
+        {
+            const MappedSceneAttribute& attr = type.attributes_[j];
+            dest.WriteStringHash(StringHash(attr.attr_->name_));
+            dest.WriteUByte((unsigned char)attr.type_);
+        }
+    }
+
+    VectorBuffer buffer;
+    if (WriteMappedNode(dest, this, types, typeIndices, buffer))
+    {
+        FinishSaving(&dest);
+        return true;
+    }
+    else
+        return false;
+}
+
 bool Scene::LoadAsync(File* file, LoadMode mode)
 {
     if (!file)
@@ -612,6 +930,31 @@ Node* Scene::InstantiateJSON(Deserializer& source, const Vector3& position, cons
     return InstantiateJSON(json->GetRoot(), position, rotation, mode);
 }
 
+Node* Scene::InstantiatePrefab(const Prefab* prefab, const Vector3& position, const Quaternion& rotation, CreateMode mode)
+{
+    URHO3D_PROFILE(InstantiatePrefab);
+
+    if (!prefab)
+    {
+        URHO3D_LOGERROR("Null prefab for instantiation");
+        return nullptr;
+    }
+
+    // Rewrite IDs when instantiating
+    Node* node = CreateChild(0, mode);
+    if (prefab->Apply(node, mode))
+    {
+        node->SetTransform(position, rotation);
+        node->ApplyAttributes();
+        return node;
+    }
+    else
+    {
+        node->Remove();
+        return nullptr;
+    }
+}
+
 void Scene::Clear(bool clearReplicated, bool clearLocal)
 {
     StopAsyncLoading();
@@ -633,11 +976,15 @@ void Scene::Clear(bool clearReplicated, bool clearLocal)
     {
         replicatedNodeID_ = FIRST_REPLICATED_ID;
         replicatedComponentID_ = FIRST_REPLICATED_ID;
+        freedReplicatedNodeIDs_.Clear();
+        freedReplicatedComponentIDs_.Clear();
     }
     if (clearLocal)
     {
         localNodeID_ = FIRST_LOCAL_ID;
         localComponentID_ = FIRST_LOCAL_ID;
+        freedLocalNodeIDs_.Clear();
+        freedLocalComponentIDs_.Clear();
     }
 }
 
@@ -669,6 +1016,11 @@ void Scene::SetAsyncLoadingMs(int ms)
     asyncLoadingMs_ = Max(ms, 1);
 }
 
+void Scene::SetFreedIDReuseDelay(float delay)
+{
+    freedIDReuseDelay_ = (long long)((double)Max(delay, 0.0f) * 1000000.0 + 0.5);
+}
+
 void Scene::SetElapsedTime(float time)
 {
     elapsedTime_ = time;
@@ -707,12 +1059,12 @@ Node* Scene::GetNode(unsigned id) const
 {
     if (IsReplicatedID(id))
     {
-        HashMap<unsigned, Node*>::ConstIterator i = replicatedNodes_.Find(id);
+        FlatHashMap<unsigned, Node*>::ConstIterator i = replicatedNodes_.Find(id);
         return i != replicatedNodes_.End() ? i->second_ : nullptr;
     }
     else
     {
-        HashMap<unsigned, Node*>::ConstIterator i = localNodes_.Find(id);
+        FlatHashMap<unsigned, Node*>::ConstIterator i = localNodes_.Find(id);
         return i != localNodes_.End() ? i->second_ : nullptr;
     }
 }
@@ -734,12 +1086,12 @@ Component* Scene::GetComponent(unsigned id) const
 {
     if (IsReplicatedID(id))
     {
-        HashMap<unsigned, Component*>::ConstIterator i = replicatedComponents_.Find(id);
+        FlatHashMap<unsigned, Component*>::ConstIterator i = replicatedComponents_.Find(id);
         return i != replicatedComponents_.End() ? i->second_ : nullptr;
     }
     else
     {
-        HashMap<unsigned, Component*>::ConstIterator i = localComponents_.Find(id);
+        FlatHashMap<unsigned, Component*>::ConstIterator i = localComponents_.Find(id);
         return i != localComponents_.End() ? i->second_ : nullptr;
     }
 }
@@ -779,6 +1131,7 @@ void Scene::Update(float timeStep)
 
     // Update variable timestep logic
     SendEvent(E_SCENEUPDATE, eventData);
+    UpdateThreadedLogic(USE_UPDATE, timeStep);
 
     // Update scene attribute animation.
     SendEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
@@ -802,6 +1155,9 @@ void Scene::Update(float timeStep)
 
     // Post-update variable timestep logic
     SendEvent(E_SCENEPOSTUPDATE, eventData);
+    UpdateThreadedLogic(USE_POSTUPDATE, timeStep);
+
+    UpdateTransforms();
 
     // Note: using a float for elapsed time accumulation is inherently inaccurate. The purpose of this value is
     // primarily to update material animation effects, as it is available to shaders. It can be reset by calling
@@ -809,6 +1165,26 @@ void Scene::Update(float timeStep)
     elapsedTime_ += timeStep;
 }
 
+void Scene::SetTransformStoreEnabled(bool enable)
+{
+    if (enable == transformStore_.NotNull())
+        return;
+
+    if (enable)
+        transformStore_ = new TransformStore();
+    else
+        transformStore_.Reset();
+}
+
+void Scene::UpdateTransforms()
+{
+    if (!transformStore_)
+        return;
+
+    URHO3D_PROFILE(UpdateTransforms);
+    transformStore_->Update(this, GetSubsystem<WorkQueue>());
+}
+
 void Scene::BeginThreadedUpdate()
 {
     // Check the work queue subsystem whether it actually has created worker threads. If not, do not enter threaded mode.
@@ -839,10 +1215,53 @@ void Scene::DelayedMarkedDirty(Component* component)
     delayedDirtyComponents_.Push(component);
 }
 
+void Scene::SetThreadedLogicUpdate(LogicComponent* component, UpdateEvent updateEvent, bool enable)
+{
+    unsigned eventIndex = LogBaseTwo(updateEvent);
+    unsigned& index = component->threadedUpdateIndices_[eventIndex];
+    if (enable == (index != M_MAX_UNSIGNED))
+        return;
+
+    if (!Thread::IsMainThread())
+    {
+        URHO3D_LOGERROR("Logic components can not be added to or removed from the threaded update in worker threads");
+        return;
+    }
+
+    PODVector<LogicComponent*>& components = threadedLogicComponents_[eventIndex];
+    if (enable)
+    {
+        index = components.Size();
+        components.Push(component);
+
+#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
+        // The physics world sends the fixed update events, so handle them from any sender and check the scene
+        if ((updateEvent == USE_FIXEDUPDATE || updateEvent == USE_FIXEDPOSTUPDATE) && !HasSubscribedToEvent(E_PHYSICSPRESTEP))
+        {
+            SubscribeToEvent(E_PHYSICSPRESTEP, URHO3D_HANDLER(Scene, HandlePhysicsPreStep));
+            SubscribeToEvent(E_PHYSICSPOSTSTEP, URHO3D_HANDLER(Scene, HandlePhysicsPostStep));
+        }
+#endif
+    }
+    else
+    {
+        // Move the last component to the removed component's place, as the update order is not defined
+        LogicComponent* last = components.Back();
+        components[index] = last;
+        last->threadedUpdateIndices_[eventIndex] = index;
+        components.Pop();
+        index = M_MAX_UNSIGNED;
+    }
+}
+
 unsigned Scene::GetFreeNodeID(CreateMode mode)
 {
     if (mode == REPLICATED)
     {
+        unsigned freedID = freedReplicatedNodeIDs_.Pop(GetFreedIDTime(), freedIDReuseDelay_, replicatedNodes_);
+        if (freedID)
+            return freedID;
+
         for (;;)
         {
             unsigned ret = replicatedNodeID_;
@@ -857,6 +1276,10 @@ unsigned Scene::GetFreeNodeID(CreateMode mode)
     }
     else
     {
+        unsigned freedID = freedLocalNodeIDs_.Pop(GetFreedIDTime(), freedIDReuseDelay_, localNodes_);
+        if (freedID)
+            return freedID;
+
         for (;;)
         {
             unsigned ret = localNodeID_;
@@ -875,6 +1298,10 @@ unsigned Scene::GetFreeComponentID(CreateMode mode)
 {
     if (mode == REPLICATED)
     {
+        unsigned freedID = freedReplicatedComponentIDs_.Pop(GetFreedIDTime(), freedIDReuseDelay_, replicatedComponents_);
+        if (freedID)
+            return freedID;
+
         for (;;)
         {
             unsigned ret = replicatedComponentID_;
@@ -889,6 +1316,10 @@ unsigned Scene::GetFreeComponentID(CreateMode mode)
     }
     else
     {
+        unsigned freedID = freedLocalComponentIDs_.Pop(GetFreedIDTime(), freedIDReuseDelay_, localComponents_);
+        if (freedID)
+            return freedID;
+
         for (;;)
         {
             unsigned ret = localComponentID_;
@@ -903,6 +1334,20 @@ unsigned Scene::GetFreeComponentID(CreateMode mode)
     }
 }
 
+long long Scene::GetFreedIDTime()
+{
+    // The high-resolution timer frequency is set up by the Time subsystem. Without it no clock is available, and freed IDs
+    // are not reused
+    if (!HiresTimer::IsSupported())
+        return -1;
+
+    // Use one clock for all scenes, started on first use. The system clock may be adjusted backwards, so keep the time
+    // monotonic per scene
+    static HiresTimer timer;
+    freedIDTime_ = Max(freedIDTime_, timer.GetUSec(false));
+    return freedIDTime_;
+}
+
 void Scene::NodeAdded(Node* node)
 {
     if (!node || node->GetScene() == this)
@@ -926,7 +1371,7 @@ void Scene::NodeAdded(Node* node)
     // If node with same ID exists, remove the scene reference from it and overwrite with the new node
     if (IsReplicatedID(id))
     {
-        HashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Find(id);
+        FlatHashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Find(id);
         if (i != replicatedNodes_.End() && i->second_ != node)
         {
             URHO3D_LOGWARNING("Overwriting node with ID " + String(id));
@@ -940,7 +1385,7 @@ void Scene::NodeAdded(Node* node)
     }
     else
     {
-        HashMap<unsigned, Node*>::Iterator i = localNodes_.Find(id);
+        FlatHashMap<unsigned, Node*>::Iterator i = localNodes_.Find(id);
         if (i != localNodes_.End() && i->second_ != node)
         {
             URHO3D_LOGWARNING("Overwriting node with ID " + String(id));
@@ -984,11 +1429,12 @@ void Scene::NodeRemoved(Node* node)
     unsigned id = node->GetID();
     if (Scene::IsReplicatedID(id))
     {
-        replicatedNodes_.Erase(id);
+        if (replicatedNodes_.Erase(id))
+            freedReplicatedNodeIDs_.Push(id, GetFreedIDTime());
         MarkReplicationDirty(node);
     }
-    else
-        localNodes_.Erase(id);
+    else if (localNodes_.Erase(id))
+        freedLocalNodeIDs_.Push(id, GetFreedIDTime());
 
     node->ResetScene();
 
@@ -1025,7 +1471,7 @@ void Scene::ComponentAdded(Component* component)
 
     if (IsReplicatedID(id))
     {
-        HashMap<unsigned, Component*>::Iterator i = replicatedComponents_.Find(id);
+        FlatHashMap<unsigned, Component*>::Iterator i = replicatedComponents_.Find(id);
         if (i != replicatedComponents_.End() && i->second_ != component)
         {
             URHO3D_LOGWARNING("Overwriting component with ID " + String(id));
@@ -1036,7 +1482,7 @@ void Scene::ComponentAdded(Component* component)
     }
     else
     {
-        HashMap<unsigned, Component*>::Iterator i = localComponents_.Find(id);
+        FlatHashMap<unsigned, Component*>::Iterator i = localComponents_.Find(id);
         if (i != localComponents_.End() && i->second_ != component)
         {
             URHO3D_LOGWARNING("Overwriting component with ID " + String(id));
@@ -1056,11 +1502,23 @@ void Scene::ComponentRemoved(Component* component)
 
     unsigned id = component->GetID();
     if (Scene::IsReplicatedID(id))
-        replicatedComponents_.Erase(id);
-    else
-        localComponents_.Erase(id);
+    {
+        if (replicatedComponents_.Erase(id))
+            freedReplicatedComponentIDs_.Push(id, GetFreedIDTime());
+    }
+    else if (localComponents_.Erase(id))
+        freedLocalComponentIDs_.Push(id, GetFreedIDTime());
 
     component->SetID(0);
+
+    // Remove logic components from the threaded update while the scene is still accessible
+    if (component->IsInstanceOf<LogicComponent>())
+    {
+        auto* logicComponent = static_cast<LogicComponent*>(component);
+        for (unsigned i = 0; i < NUM_UPDATE_EVENTS; ++i)
+            SetThreadedLogicUpdate(logicComponent, UpdateEvent(1u << i), false);
+    }
+
     component->OnSceneSet(nullptr);
 }
 
@@ -1112,10 +1570,10 @@ void Scene::CleanupConnection(Connection* connection)
 {
     Node::CleanupConnection(connection);
 
-    for (HashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
+    for (FlatHashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
         i->second_->CleanupConnection(connection);
 
-    for (HashMap<unsigned, Component*>::Iterator i = replicatedComponents_.Begin(); i != replicatedComponents_.End(); ++i)
+    for (FlatHashMap<unsigned, Component*>::Iterator i = replicatedComponents_.Begin(); i != replicatedComponents_.End(); ++i)
         i->second_->CleanupConnection(connection);
 }
 
@@ -1288,6 +1746,181 @@ void Scene::FinishSaving(Serializer* dest) const
     }
 }
 
+bool Scene::LoadMappedData(const unsigned char* data, unsigned size)
+{
+    const unsigned char* end = data + size;
+
+    unsigned version;
+    unsigned numTypes;
+    if (!ReadMappedUInt(data, end, version) || version != MAPPED_SCENE_VERSION)
+    {
+        URHO3D_LOGERROR("Unsupported mapped scene format version");
+        return false;
+    }
+
+    // Each type takes at least 8 bytes
+    if (!ReadMappedUInt(data, end, numTypes) || numTypes > (unsigned)(end - data) / 8)
+    {
+        URHO3D_LOGERROR("Could not load scene, corrupted attribute schema");
+        return false;
+    }
+
+    // Read the attribute schemas and match them to the registered attributes by name and type
+    Vector<MappedSceneType> types(numTypes);
+    for (unsigned i = 0; i < numTypes; ++i)
+    {
+        MappedSceneType& type = types[i];
+        unsigned typeHash;
+        unsigned numAttributes;
+        if (!ReadMappedUInt(data, end, typeHash) || !ReadMappedUInt(data, end, numAttributes))
+        {
+            URHO3D_LOGERROR("Could not load scene, corrupted attribute schema");
+            return false;
+        }
+
+        type.type_ = StringHash(typeHash);
+        type.stream_ = numAttributes == MAPPED_SCENE_STREAM_TYPE;
+        if (type.stream_)
+            continue;
+
+        // Each attribute takes 5 bytes
+        if (numAttributes > (unsigned)(end - data) / 5)
+        {
+            URHO3D_LOGERROR("Could not load scene, corrupted attribute schema");
+            return false;
+        }
+
+        const Vector<AttributeInfo>* attributes = context_->GetAttributes(type.type_);
+        type.attributes_.Resize(numAttributes);
+        for (unsigned j = 0; j < numAttributes; ++j)
+        {
+            MappedSceneAttribute& attr = type.attributes_[j];
+            unsigned nameHash;
+            if (!ReadMappedUInt(data, end, nameHash) || data == end || *data >= MAX_VAR_TYPES)
+            {
+                URHO3D_LOGERROR("Could not load scene, corrupted attribute schema");
+                return false;
+            }
+
+            attr.attr_ = nullptr;
+            attr.type_ = (VariantType)*data++;
+            attr.size_ = GetFixedAttributeSize(attr.type_);
+            for (unsigned k = 0; attributes && k < attributes->Size(); ++k)
+            {
+                const AttributeInfo& info = attributes->At(k);
+                if ((info.mode_ & AM_FILE) && info.type_ == attr.type_ && StringHash(info.name_).Value() == nameHash)
+                {
+                    attr.attr_ = &info;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Read own ID. Will not be applied, only stored for resolving possible references
+    unsigned typeIndex;
+    unsigned nodeID;
+    if (!ReadMappedUInt(data, end, typeIndex) || !ReadMappedUInt(data, end, nodeID) || typeIndex >= numTypes ||
+        types[typeIndex].type_ != GetType())
+    {
+        URHO3D_LOGERROR("Could not load scene, corrupted node data");
+        return false;
+    }
+
+    SceneResolver resolver;
+    resolver.AddNode(nodeID, this);
+
+    // Read attributes, components and child nodes
+    if (LoadMappedNode(this, types[typeIndex], data, end, types, resolver))
+    {
+        resolver.Resolve();
+        ApplyAttributes();
+        return true;
+    }
+    else
+        return false;
+}
+
+bool Scene::LoadMappedNode(Node* node, const MappedSceneType& type, const unsigned char*& data, const unsigned char* end,
+    const Vector<MappedSceneType>& types, SceneResolver& resolver)
+{
+    const unsigned char* objectData;
+    unsigned objectSize;
+    if (!ReadMappedObjectData(data, end, objectData, objectSize))
+    {
+        URHO3D_LOGERROR("Could not load scene, corrupted node data");
+        return false;
+    }
+    LoadMappedAttributes(node, type, objectData, objectSize);
+
+    unsigned numComponents;
+    if (!ReadMappedUInt(data, end, numComponents))
+    {
+        URHO3D_LOGERROR("Could not load scene, corrupted node data");
+        return false;
+    }
+
+    for (unsigned i = 0; i < numComponents; ++i)
+    {
+        unsigned typeIndex;
+        unsigned compID;
+        if (!ReadMappedUInt(data, end, typeIndex) || !ReadMappedUInt(data, end, compID) || typeIndex >= types.Size() ||
+            !ReadMappedObjectData(data, end, objectData, objectSize))
+        {
+            URHO3D_LOGERROR("Could not load scene, corrupted component data");
+            return false;
+        }
+
+        const MappedSceneType& compType = types[typeIndex];
+        Component* newComponent = node->SafeCreateComponent(String::EMPTY, compType.type_, Scene::IsReplicatedID(compID) ?
+            REPLICATED : LOCAL, compID);
+        if (!newComponent)
+            continue;
+
+        resolver.AddComponent(compID, newComponent);
+        if (compType.stream_ || newComponent->IsInstanceOf<UnknownComponent>())
+        {
+            MemoryBuffer buffer(objectData, objectSize);
+            // Skip the type and ID of a component saved whole
+            if (compType.stream_)
+            {
+                buffer.ReadStringHash();
+                buffer.ReadUInt();
+            }
+            // Do not abort if component fails to load, as the component data has a size and we can skip to the next
+            newComponent->Load(buffer);
+        }
+        else
+            LoadMappedAttributes(newComponent, compType, objectData, objectSize);
+    }
+
+    unsigned numChildren;
+    if (!ReadMappedUInt(data, end, numChildren))
+    {
+        URHO3D_LOGERROR("Could not load scene, corrupted node data");
+        return false;
+    }
+
+    for (unsigned i = 0; i < numChildren; ++i)
+    {
+        unsigned typeIndex;
+        unsigned nodeID;
+        if (!ReadMappedUInt(data, end, typeIndex) || !ReadMappedUInt(data, end, nodeID) || typeIndex >= types.Size() ||
+            types[typeIndex].type_ != Node::GetTypeStatic())
+        {
+            URHO3D_LOGERROR("Could not load scene, corrupted node data");
+            return false;
+        }
+
+        Node* newNode = node->CreateChild(nodeID, Scene::IsReplicatedID(nodeID) ? REPLICATED : LOCAL);
+        resolver.AddNode(nodeID, newNode);
+        if (!LoadMappedNode(newNode, types[typeIndex], data, end, types, resolver))
+            return false;
+    }
+
+    return true;
+}
+
 void Scene::PreloadResources(File* file, bool isSceneFile)
 {
     // If not threaded, can not background load resources, so rather load synchronously later when needed
@@ -1527,12 +2160,51 @@ void Scene::PreloadResourcesJSON(const JSONValue& value)
 #endif
 }
 
+void Scene::UpdateThreadedLogic(UpdateEvent updateEvent, float timeStep)
+{
+    PODVector<LogicComponent*>& components = threadedLogicComponents_[LogBaseTwo(updateEvent)];
+    if (components.Empty())
+        return;
+
+    URHO3D_PROFILE(UpdateThreadedLogic);
+
+    // Components marked dirty by the transform changes delay their non-threadsafe work until the end of the threaded update
+    ThreadedLogicUpdate update{updateEvent, timeStep};
+    auto* queue = GetSubsystem<WorkQueue>();
+    BeginThreadedUpdate();
+    queue->ParallelFor(components.Begin(), components.End(), UpdateLogicComponentsWork, &update, MIN_LOGIC_COMPONENTS_PER_ITEM);
+    EndThreadedUpdate();
+}
+
+#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
+
+void Scene::HandlePhysicsPreStep(StringHash eventType, VariantMap& eventData)
+{
+    using namespace PhysicsPreStep;
+
+    auto* world = static_cast<Component*>(eventData[P_WORLD].GetPtr());
+    if (world && world->GetScene() == this)
+        UpdateThreadedLogic(USE_FIXEDUPDATE, eventData[P_TIMESTEP].GetFloat());
+}
+
+void Scene::HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData)
+{
+    using namespace PhysicsPostStep;
+
+    auto* world = static_cast<Component*>(eventData[P_WORLD].GetPtr());
+    if (world && world->GetScene() == this)
+        UpdateThreadedLogic(USE_FIXEDPOSTUPDATE, eventData[P_TIMESTEP].GetFloat());
+}
+
+#endif
+
 void RegisterSceneLibrary(Context* context)
 {
     ValueAnimation::RegisterObject(context);
     ObjectAnimation::RegisterObject(context);
     Node::RegisterObject(context);
     Scene::RegisterObject(context);
+    Prefab::RegisterObject(context);
     SmoothedTransform::RegisterObject(context);
     UnknownComponent::RegisterObject(context);
     SplinePath::RegisterObject(context);
@@ -24,18 +24,23 @@
 
 #pragma once
 
+#include "../Container/FlatHashMap.h"
 #include "../Container/HashSet.h"
 #include "../Core/Mutex.h"
 #include "../Resource/XMLElement.h"
 #include "../Resource/JSONFile.h"
+#include "../Scene/LogicComponent.h"
 #include "../Scene/Node.h"
 #include "../Scene/SceneResolver.h"
+#include "../Scene/TransformStore.h"
 
 namespace Urho3D
 {
 
 class File;
 class PackageFile;
+class Prefab;
+struct MappedSceneType;
 
 static const unsigned FIRST_REPLICATED_ID = 0x1;
 static const unsigned LAST_REPLICATED_ID = 0xffffff;
@@ -83,6 +88,88 @@ struct AsyncProgress
     unsigned totalNodes_;
 };
 
+/// Queue of freed node or component IDs, which are reused in the order they were freed. Times are integer microseconds from a monotonic clock. A negative time means that no clock is available, in which case IDs are neither queued nor reused.
+struct FreedIDQueue
+{
+    /// Freed ID and the time it was freed.
+    struct Entry
+    {
+        /// ID.
+        unsigned id_;
+        /// Generation of the free, which identifies the latest free of the ID.
+        unsigned generation_;
+        /// Time in microseconds when freed.
+        long long time_;
+    };
+
+    /// Add a freed ID with the time it was freed. If the ID is still queued from an earlier free, only the new free counts.
+    void Push(unsigned id, long long time)
+    {
+        if (time < 0)
+            return;
+
+        // The generation only wraps after 2^32 frees, long after an earlier entry of the same ID has been consumed
+        ++generation_;
+        entries_.Push(Entry{id, generation_, time});
+        generations_[id] = generation_;
+    }
+
+    /// Remove and return the oldest ID freed at least the delay before the time that is not used by the objects, or 0 if none.
+    template <class T> unsigned Pop(long long time, long long delay, const FlatHashMap<unsigned, T*>& objects)
+    {
+        if (time < 0)
+            return 0;
+
+        unsigned id = 0;
+
+        while (head_ < entries_.Size())
+        {
+            const Entry& entry = entries_[head_];
+            FlatHashMap<unsigned, unsigned>::Iterator i = generations_.Find(entry.id_);
+            // Skip the entry if the ID has been freed again later or already reused
+            if (i != generations_.End() && i->second_ == entry.generation_)
+            {
+                if (time - entry.time_ < delay)
+                    break;
+                generations_.Erase(i);
+                // An ID may have been taken again explicitly after it was freed, so check that it is still unused
+                if (!objects.Contains(entry.id_))
+                    id = entry.id_;
+            }
+
+            ++head_;
+            if (id)
+                break;
+        }
+
+        // Compact when over half of the buffer has been consumed, which keeps the cost constant on average
+        if (head_ && head_ * 2 >= entries_.Size())
+        {
+            entries_.Erase(0, head_);
+            head_ = 0;
+        }
+
+        return id;
+    }
+
+    /// Remove all IDs.
+    void Clear()
+    {
+        entries_.Clear();
+        generations_.Clear();
+        head_ = 0;
+    }
+
+    /// Freed IDs, oldest first starting from the head. May contain stale entries of IDs freed again later.
+    PODVector<Entry> entries_;
+    /// Generation of the latest free of each queued ID.
+    FlatHashMap<unsigned, unsigned> generations_;
+    /// Generation of the latest free.
+    unsigned generation_{};
+    /// Index of the oldest entry.
+    unsigned head_{};
+};
+
 /// Root scene node, represents the whole scene.
 class URHO3D_API Scene : public Node
 {
@@ -100,7 +187,7 @@ public:
     /// Register object factory. Node must be registered first.
     static void RegisterObject(Context* context);
 
-    /// Load from binary data. Removes all existing child nodes and components first. Return true if successful.
+    /// Load from binary data. Removes all existing child nodes and components first. Also accepts the mapped scene format, which is then read into memory. Return true if successful.
     bool Load(Deserializer& source) override;
     /// Save to binary data. Return true if successful.
     bool Save(Serializer& dest) const override;
@@ -121,6 +208,10 @@ public:
     bool SaveXML(Serializer& dest, const String& indentation = "\t") const;
     /// Save to a JSON file. Return true if successful.
     bool SaveJSON(Serializer& dest, const String& indentation = "\t") const;
+    /// Load from a binary file in the mapped scene format, which is memory-mapped and applied without copying. Removes all existing child nodes and components first. Return true if successful.
+    bool LoadMapped(const String& fileName);
+    /// Save to a binary file in the mapped scene format, which stores an attribute schema for each object type. Return true if successful.
+    bool SaveMapped(Serializer& dest) const;
     /// Load from a binary file asynchronously. Return true if started successfully. The LOAD_RESOURCES_ONLY mode can also be used to preload resources from object prefab files.
     bool LoadAsync(File* file, LoadMode mode = LOAD_SCENE_AND_RESOURCES);
     /// Load from an XML file asynchronously. Return true if started successfully. The LOAD_RESOURCES_ONLY mode can also be used to preload resources from object prefab files.
@@ -141,6 +232,8 @@ public:
         (const JSONValue& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
     /// Instantiate scene content from JSON data. Return root node if successful.
     Node* InstantiateJSON(Deserializer& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
+    /// Instantiate scene content from a prefab resource. Return root node if successful.
+    Node* InstantiatePrefab(const Prefab* prefab, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
 
     /// Clear scene completely of either replicated, local or all nodes and components.
     void Clear(bool clearReplicated = true, bool clearLocal = true);
@@ -156,6 +249,8 @@ public:
     void SetSnapThreshold(float threshold);
     /// Set maximum milliseconds per frame to spend on async scene loading.
     void SetAsyncLoadingMs(int ms);
+    /// Set minimum time in seconds from freeing a node or component ID until it is reused, so that references to removed objects, such as in network replication, have time to expire. Default 10.
+    void SetFreedIDReuseDelay(float delay);
     /// Add a required package file for networking. To be called on the server.
     void AddRequiredPackageFile(PackageFile* package);
     /// Clear required package files.
@@ -166,6 +261,10 @@ public:
     void UnregisterVar(const String& name);
     /// Clear all registered node user variable hash reverse mappings.
     void UnregisterAllVars();
+    /// Enable or disable the transform store. When enabled, the world transforms of dirty nodes are updated in one linear pass at the end of the scene update, in the worker threads if there are many nodes, instead of lazily when first requested. Benefits scenes with a large number of moving nodes.
+    void SetTransformStoreEnabled(bool enable);
+    /// Update the world transforms of dirty nodes using the transform store, if enabled. Called automatically at the end of the scene update.
+    void UpdateTransforms();
 
     /// Return node from the whole scene by ID, or null if not found.
     Node* GetNode(unsigned id) const;
@@ -207,12 +306,20 @@ public:
     /// Return maximum milliseconds per frame to spend on async loading.
     int GetAsyncLoadingMs() const { return asyncLoadingMs_; }
 
+    /// Return minimum time in seconds from freeing a node or component ID until it is reused.
+    float GetFreedIDReuseDelay() const { return (float)freedIDReuseDelay_ / 1000000.0f; }
+
     /// Return required package files.
     const Vector<SharedPtr<PackageFile> >& GetRequiredPackageFiles() const { return requiredPackageFiles_; }
 
     /// Return a node user variable name, or empty if not registered.
     const String& GetVarName(StringHash hash) const;
 
+    /// Return whether the transform store is enabled.
+    bool IsTransformStoreEnabled() const { return transformStore_.NotNull(); }
+    /// Return the transform store, or null if not enabled.
+    TransformStore* GetTransformStore() const { return transformStore_.Get(); }
+
     /// Update scene. Called by HandleUpdate.
     void Update(float timeStep);
     /// Begin a threaded update. During threaded update components can choose to delay dirty processing.
@@ -221,9 +328,13 @@ public:
     void EndThreadedUpdate();
     /// Add a component to the delayed dirty notify queue. Is thread-safe.
     void DelayedMarkedDirty(Component* component);
+    /// Add or remove a thread-safe logic component in the threaded logic update after an update event. Called by LogicComponent.
+    void SetThreadedLogicUpdate(LogicComponent* component, UpdateEvent updateEvent, bool enable);
 
     /// Return threaded update flag.
     bool IsThreadedUpdate() const { return threadedUpdate_; }
+    /// Return number of thread-safe logic components updated after an update event.
+    unsigned GetNumThreadedLogicComponents(UpdateEvent updateEvent) const { return threadedLogicComponents_[LogBaseTwo(updateEvent)].Size(); }
 
     /// Get free node ID, either non-local or local.
     unsigned GetFreeNodeID(CreateMode mode);
@@ -273,21 +384,36 @@ private:
     void FinishLoading(Deserializer* source);
     /// Finish saving. Sets the scene filename and checksum.
     void FinishSaving(Serializer* dest) const;
+    /// Load the mapped scene format following the file ID from memory. Return true if successful.
+    bool LoadMappedData(const unsigned char* data, unsigned size);
+    /// Load the attributes, components and child nodes of a node in the mapped scene format. Return true if successful.
+    bool LoadMappedNode(Node* node, const MappedSceneType& type, const unsigned char*& data, const unsigned char* end,
+        const Vector<MappedSceneType>& types, SceneResolver& resolver);
+    /// Return the time in microseconds for timing the reuse of freed IDs, or -1 if the high-resolution timer has not been initialized by the Time subsystem.
+    long long GetFreedIDTime();
     /// Preload resources from a binary scene or object prefab file.
     void PreloadResources(File* file, bool isSceneFile);
     /// Preload resources from an XML scene or object prefab file.
     void PreloadResourcesXML(const XMLElement& element);
     /// Preload resources from a JSON scene or object prefab file.
     void PreloadResourcesJSON(const JSONValue& value);
+    /// Update the thread-safe logic components of an update event in the worker threads.
+    void UpdateThreadedLogic(UpdateEvent updateEvent, float timeStep);
+#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
+    /// Handle physics pre-step event for the threaded logic update.
+    void HandlePhysicsPreStep(StringHash eventType, VariantMap& eventData);
+    /// Handle physics post-step event for the threaded logic update.
+    void HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData);
+#endif
 
     /// Replicated scene nodes by ID.
-    HashMap<unsigned, Node*> replicatedNodes_;
+    FlatHashMap<unsigned, Node*> replicatedNodes_;
     /// Local scene nodes by ID.
-    HashMap<unsigned, Node*> localNodes_;
+    FlatHashMap<unsigned, Node*> localNodes_;
     /// Replicated components by ID.
-    HashMap<unsigned, Component*> replicatedComponents_;
+    FlatHashMap<unsigned, Component*> replicatedComponents_;
     /// Local components by ID.
-    HashMap<unsigned, Component*> localComponents_;
+    FlatHashMap<unsigned, Component*> localComponents_;
     /// Cached tagged nodes by tag.
     HashMap<StringHash, PODVector<Node*> > taggedNodes_;
     /// Asynchronous loading progress.
@@ -306,10 +432,14 @@ private:
     HashSet<unsigned> networkUpdateComponents_;
     /// Delayed dirty notification queue for components.
     PODVector<Component*> delayedDirtyComponents_;
+    /// Thread-safe logic components by update event.
+    PODVector<LogicComponent*> threadedLogicComponents_[NUM_UPDATE_EVENTS];
     /// Mutex for the delayed dirty notification queue.
     Mutex sceneMutex_;
     /// Preallocated event data map for smoothing update events.
     VariantMap smoothingData_;
+    /// Transform store, if enabled.
+    UniquePtr<TransformStore> transformStore_;
     /// Next free non-local node ID.
     unsigned replicatedNodeID_;
     /// Next free non-local component ID.
@@ -318,6 +448,18 @@ private:
     unsigned localNodeID_;
     /// Next free local component ID.
     unsigned localComponentID_;
+    /// Freed non-local node IDs.
+    FreedIDQueue freedReplicatedNodeIDs_;
+    /// Freed non-local component IDs.
+    FreedIDQueue freedReplicatedComponentIDs_;
+    /// Freed local node IDs.
+    FreedIDQueue freedLocalNodeIDs_;
+    /// Freed local component IDs.
+    FreedIDQueue freedLocalComponentIDs_;
+    /// Minimum time in microseconds from freeing an ID until it is reused.
+    long long freedIDReuseDelay_;
+    /// Latest time in microseconds read for freeing or reusing IDs.
+    long long freedIDTime_;
     /// Scene source file checksum.
     mutable unsigned checksum_;
     /// Maximum milliseconds per frame to spend on async scene loading.
@@ -25,6 +25,7 @@
 #include "../Core/Context.h"
 #include "../IO/Deserializer.h"
 #include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
 #include "../IO/Serializer.h"
 #include "../Resource/XMLElement.h"
 #include "../Resource/JSONValue.h"
@@ -53,6 +54,47 @@ static unsigned RemapAttributeIndex(const Vector<AttributeInfo>* attributes, con
     return netAttrIndex; // Could not remap
 }
 
+unsigned GetFixedAttributeSize(VariantType type)
+{
+    switch (type)
+    {
+    case VAR_INT:
+    case VAR_FLOAT:
+        return 4;
+
+    case VAR_BOOL:
+        return 1;
+
+    case VAR_INT64:
+    case VAR_DOUBLE:
+    case VAR_VECTOR2:
+    case VAR_INTVECTOR2:
+        return 8;
+
+    case VAR_VECTOR3:
+    case VAR_INTVECTOR3:
+        return 12;
+
+    case VAR_VECTOR4:
+    case VAR_QUATERNION:
+    case VAR_COLOR:
+    case VAR_INTRECT:
+        return 16;
+
+    case VAR_MATRIX3:
+        return sizeof(Matrix3);
+
+    case VAR_MATRIX3X4:
+        return sizeof(Matrix3x4);
+
+    case VAR_MATRIX4:
+        return sizeof(Matrix4);
+
+    default:
+        return 0;
+    }
+}
+
 Serializable::Serializable(Context* context) :
     Object(context),
     setInstanceDefault_(false),
@@ -175,6 +217,16 @@ void Serializable::OnSetAttribute(const AttributeInfo& attr, const Variant& src)
         MarkNetworkUpdate();
 }
 
+void Serializable::OnSetAttributeData(const AttributeInfo& attr, const void* src)
+{
+    // The accessor can not store instance default values
+    if (!setInstanceDefault_ && attr.accessor_ && attr.accessor_->SetData(this, src))
+        return;
+
+    MemoryBuffer buffer(src, GetFixedAttributeSize(attr.type_));
+    OnSetAttribute(attr, buffer.ReadVariant(attr.type_));
+}
+
 void Serializable::OnGetAttribute(const AttributeInfo& attr, Variant& dest) const
 {
     // Check for accessor function mode
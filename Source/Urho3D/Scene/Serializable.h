@@ -26,6 +26,8 @@
 #include "../Core/Object.h"
 
 #include <cstddef>
+#include <cstring>
+#include <type_traits>
 
 namespace Urho3D
 {
@@ -53,6 +55,8 @@ public:
 
     /// Handle attribute write access. Default implementation writes to the variable at offset, or invokes the set accessor.
     virtual void OnSetAttribute(const AttributeInfo& attr, const Variant& src);
+    /// Handle attribute write access from binary data of a fixed-size attribute type. Default implementation invokes the set accessor without constructing a Variant if possible, otherwise calls OnSetAttribute().
+    virtual void OnSetAttributeData(const AttributeInfo& attr, const void* src);
     /// Handle attribute read access. Default implementation reads the variable at offset, or invokes the get accessor.
     virtual void OnGetAttribute(const AttributeInfo& attr, Variant& dest) const;
     /// Return attribute descriptions, or null if none defined.
@@ -189,35 +193,122 @@ SharedPtr<AttributeAccessor> MakeVariantAttributeAccessor(TGetFunction getFuncti
     return SharedPtr<AttributeAccessor>(new VariantAttributeAccessorImpl<TClassType, TGetFunction, TSetFunction>(getFunction, setFunction));
 }
 
+/// Return the size of an attribute type in binary data as written by Serializer::WriteVariantData(), or 0 if the size is not fixed.
+URHO3D_API unsigned GetFixedAttributeSize(VariantType type);
+
+/// Whether an attribute type has a fixed size in binary data, and can be set from it without constructing a Variant.
+template <class T> struct IsFixedSizeAttributeType : std::false_type { };
+template <> struct IsFixedSizeAttributeType<int> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<unsigned> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<long long> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<unsigned long long> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<bool> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<float> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<double> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<StringHash> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<Vector2> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<Vector3> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<Vector4> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<Quaternion> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<Color> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<IntRect> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<IntVector2> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<IntVector3> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<Matrix3> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<Matrix3x4> : std::true_type { };
+template <> struct IsFixedSizeAttributeType<Matrix4> : std::true_type { };
+
+/// Template implementation of the typed attribute accessor. Attributes of fixed-size types can also be set directly from binary data.
+template <class TClassType, class T, class TGetFunction, class TSetFunction>
+class TypedAttributeAccessorImpl : public AttributeAccessor
+{
+public:
+    /// Construct.
+    TypedAttributeAccessorImpl(TGetFunction getFunction, TSetFunction setFunction) : getFunction_(getFunction), setFunction_(setFunction) { }
+
+    /// Invoke getter function.
+    void Get(const Serializable* ptr, Variant& value) const override
+    {
+        assert(ptr);
+        const auto classPtr = static_cast<const TClassType*>(ptr);
+        getFunction_(*classPtr, value);
+    }
+
+    /// Invoke setter function.
+    void Set(Serializable* ptr, const Variant& value) override
+    {
+        assert(ptr);
+        auto classPtr = static_cast<TClassType*>(ptr);
+        setFunction_(*classPtr, value.Get<T>());
+    }
+
+    /// Invoke setter function with the value copied from binary data.
+    bool SetData(Serializable* ptr, const void* src) override
+    {
+        return SetDataImpl(ptr, src, IsFixedSizeAttributeType<T>());
+    }
+
+private:
+    /// Copy a fixed-size value from binary data and invoke setter function.
+    bool SetDataImpl(Serializable* ptr, const void* src, std::true_type)
+    {
+        assert(ptr);
+        auto classPtr = static_cast<TClassType*>(ptr);
+        T value;
+        memcpy(static_cast<void*>(&value), src, sizeof(T));
+        setFunction_(*classPtr, value);
+        return true;
+    }
+
+    /// Reject binary data for types without fixed size.
+    bool SetDataImpl(Serializable* /*ptr*/, const void* /*src*/, std::false_type) { return false; }
+
+    /// Get functor.
+    TGetFunction getFunction_;
+    /// Set functor.
+    TSetFunction setFunction_;
+};
+
+/// Make typed attribute accessor implementation.
+/// \tparam TClassType Serializable class type.
+/// \tparam T Attribute value type.
+/// \tparam TGetFunction Functional object with call signature `void getFunction(const TClassType& self, Variant& value)`
+/// \tparam TSetFunction Functional object with call signature `void setFunction(TClassType& self, const T& value)`
+template <class TClassType, class T, class TGetFunction, class TSetFunction>
+SharedPtr<AttributeAccessor> MakeTypedAttributeAccessor(TGetFunction getFunction, TSetFunction setFunction)
+{
+    return SharedPtr<AttributeAccessor>(new TypedAttributeAccessorImpl<TClassType, T, TGetFunction, TSetFunction>(getFunction, setFunction));
+}
+
 /// Make member attribute accessor.
-#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR(typeName, variable) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR(typeName, variable) Urho3D::MakeTypedAttributeAccessor<ClassName, typeName >( \
     [](const ClassName& self, Urho3D::Variant& value) { value = self.variable; }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.Get<typeName>(); })
+    [](ClassName& self, const typeName& value) { self.variable = value; })
 
 /// Make member attribute accessor with custom post-set callback.
-#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR_EX(typeName, variable, postSetCallback) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR_EX(typeName, variable, postSetCallback) Urho3D::MakeTypedAttributeAccessor<ClassName, typeName >( \
     [](const ClassName& self, Urho3D::Variant& value) { value = self.variable; }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.Get<typeName>(); self.postSetCallback(); })
+    [](ClassName& self, const typeName& value) { self.variable = value; self.postSetCallback(); })
 
 /// Make get/set attribute accessor.
-#define URHO3D_MAKE_GET_SET_ATTRIBUTE_ACCESSOR(getFunction, setFunction, typeName) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_GET_SET_ATTRIBUTE_ACCESSOR(getFunction, setFunction, typeName) Urho3D::MakeTypedAttributeAccessor<ClassName, typeName >( \
     [](const ClassName& self, Urho3D::Variant& value) { value = self.getFunction(); }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.setFunction(value.Get<typeName>()); })
+    [](ClassName& self, const typeName& value) { self.setFunction(value); })
 
 /// Make member enum attribute accessor.
-#define URHO3D_MAKE_MEMBER_ENUM_ATTRIBUTE_ACCESSOR(variable) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_MEMBER_ENUM_ATTRIBUTE_ACCESSOR(variable) Urho3D::MakeTypedAttributeAccessor<ClassName, int>( \
     [](const ClassName& self, Urho3D::Variant& value) { value = static_cast<int>(self.variable); }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.variable = static_cast<decltype(self.variable)>(value.Get<int>()); })
+    [](ClassName& self, const int& value) { self.variable = static_cast<decltype(self.variable)>(value); })
 
 /// Make member enum attribute accessor with custom post-set callback.
-#define URHO3D_MAKE_MEMBER_ENUM_ATTRIBUTE_ACCESSOR_EX(variable, postSetCallback) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_MEMBER_ENUM_ATTRIBUTE_ACCESSOR_EX(variable, postSetCallback) Urho3D::MakeTypedAttributeAccessor<ClassName, int>( \
     [](const ClassName& self, Urho3D::Variant& value) { value = static_cast<int>(self.variable); }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.variable = static_cast<decltype(self.variable)>(value.Get<int>()); self.postSetCallback(); })
+    [](ClassName& self, const int& value) { self.variable = static_cast<decltype(self.variable)>(value); self.postSetCallback(); })
 
 /// Make get/set enum attribute accessor.
-#define URHO3D_MAKE_GET_SET_ENUM_ATTRIBUTE_ACCESSOR(getFunction, setFunction, typeName) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_GET_SET_ENUM_ATTRIBUTE_ACCESSOR(getFunction, setFunction, typeName) Urho3D::MakeTypedAttributeAccessor<ClassName, int>( \
     [](const ClassName& self, Urho3D::Variant& value) { value = static_cast<int>(self.getFunction()); }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.setFunction(static_cast<typeName>(value.Get<int>())); })
+    [](ClassName& self, const int& value) { self.setFunction(static_cast<typeName>(value)); })
 
 /// Attribute metadata.
 namespace AttributeMetadata
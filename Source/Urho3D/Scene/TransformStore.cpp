@@ -0,0 +1,137 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/WorkQueue.h"
+#include "../Scene/Node.h"
+#include "../Scene/TransformStore.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Minimum number of nodes to update the transforms in the worker threads.
+static const unsigned MIN_THREADED_TRANSFORM_NODES = 4096;
+
+static void UpdateSubtreesWork(const WorkItem* item, unsigned /*threadIndex*/)
+{
+    // The range holds the first node indices of whole top-level subtrees. The index after the end is the next subtree's first node,
+    // or the node count
+    auto* store = reinterpret_cast<TransformStore*>(item->aux_);
+    store->UpdateNodes(*reinterpret_cast<unsigned*>(item->start_), *reinterpret_cast<unsigned*>(item->end_));
+}
+
+TransformStore::TransformStore() :
+    structureDirty_(true)
+{
+}
+
+void TransformStore::Update(Node* root, WorkQueue* workQueue)
+{
+    if (structureDirty_)
+        Rebuild(root);
+
+    unsigned numSubtrees = subtreeBegins_.Size() - 1;
+    if (workQueue && workQueue->GetNumThreads() && numSubtrees > 1 && nodes_.Size() >= MIN_THREADED_TRANSFORM_NODES)
+        workQueue->ParallelFor(subtreeBegins_.Begin(), subtreeBegins_.End() - 1, UpdateSubtreesWork, this);
+    else
+        UpdateNodes(0, nodes_.Size());
+}
+
+void TransformStore::UpdateNodes(unsigned begin, unsigned end)
+{
+    // Parents precede their children, so the parent world transforms are already up to date
+    for (unsigned i = begin; i < end; ++i)
+    {
+        if (!dirty_[i])
+            continue;
+
+        Node* node = nodes_[i];
+        int parentIndex = parentIndices_[i];
+        Matrix3x4 localTransform(node->position_, node->rotation_, node->scale_);
+        if (parentIndex >= 0)
+        {
+            worldTransforms_[i] = worldTransforms_[parentIndex] * localTransform;
+            worldRotations_[i] = worldRotations_[parentIndex] * node->rotation_;
+        }
+        else
+        {
+            worldTransforms_[i] = localTransform;
+            worldRotations_[i] = node->rotation_;
+        }
+
+        node->worldTransform_ = worldTransforms_[i];
+        node->worldRotation_ = worldRotations_[i];
+        node->dirty_ = false;
+        dirty_[i] = 0;
+    }
+}
+
+void TransformStore::Rebuild(Node* root)
+{
+    nodes_.Clear();
+    parentIndices_.Clear();
+    subtreeBegins_.Clear();
+
+    const Vector<SharedPtr<Node> >& children = root->GetChildren();
+    for (Vector<SharedPtr<Node> >::ConstIterator i = children.Begin(); i != children.End(); ++i)
+    {
+        subtreeBegins_.Push(nodes_.Size());
+        AddNodeRecursive(*i, -1);
+    }
+    subtreeBegins_.Push(nodes_.Size());
+
+    unsigned numNodes = nodes_.Size();
+    worldTransforms_.Resize(numNodes);
+    worldRotations_.Resize(numNodes);
+    dirty_.Resize(numNodes);
+
+    // Take the world transforms of clean nodes from the nodes, as they may have been calculated lazily
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        Node* node = nodes_[i];
+        node->transformIndex_ = i;
+        dirty_[i] = (unsigned char)node->dirty_;
+        if (!node->dirty_)
+        {
+            worldTransforms_[i] = node->worldTransform_;
+            worldRotations_[i] = node->worldRotation_;
+        }
+    }
+
+    structureDirty_ = false;
+}
+
+void TransformStore::AddNodeRecursive(Node* node, int parentIndex)
+{
+    auto index = (int)nodes_.Size();
+    nodes_.Push(node);
+    parentIndices_.Push(parentIndex);
+
+    const Vector<SharedPtr<Node> >& children = node->GetChildren();
+    for (Vector<SharedPtr<Node> >::ConstIterator i = children.Begin(); i != children.End(); ++i)
+        AddNodeRecursive(*i, index);
+}
+
+}
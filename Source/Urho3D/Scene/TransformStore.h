@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/Vector.h"
+#include "../Math/Matrix3x4.h"
+
+namespace Urho3D
+{
+
+class Node;
+class WorkQueue;
+
+/// Structure-of-arrays storage of the node hierarchy and world transforms of a scene in depth-first order, so that the world transforms of all dirty nodes can be updated in one linear pass instead of lazily node by node.
+class URHO3D_API TransformStore
+{
+public:
+    /// Construct.
+    TransformStore();
+
+    /// Mark the node hierarchy changed. The arrays are rebuilt on the next update.
+    void MarkStructureDirty() { structureDirty_ = true; }
+    /// Mark a node's world transform dirty. Ignored if the node is not stored yet. Is thread-safe for different nodes.
+    void MarkDirty(const Node* node, unsigned index)
+    {
+        if (index < nodes_.Size() && nodes_[index] == node)
+            dirty_[index] = 1;
+    }
+    /// Update the world transforms of the dirty nodes and write them to the nodes. Rebuild the arrays first if the hierarchy has changed. Top-level subtrees are processed in the worker threads if a work queue is given and there are enough nodes.
+    void Update(Node* root, WorkQueue* workQueue = nullptr);
+    /// Update the world transforms of the dirty nodes in an index range, which must consist of whole top-level subtrees. Called by Update().
+    void UpdateNodes(unsigned begin, unsigned end);
+
+    /// Return number of stored nodes.
+    unsigned GetNumNodes() const { return nodes_.Size(); }
+    /// Return the nodes in depth-first order.
+    const PODVector<Node*>& GetNodes() const { return nodes_; }
+    /// Return parent indices, -1 for children of the root.
+    const PODVector<int>& GetParentIndices() const { return parentIndices_; }
+    /// Return world transforms. Valid for nodes that are not dirty.
+    const PODVector<Matrix3x4>& GetWorldTransforms() const { return worldTransforms_; }
+    /// Return world rotations. Valid for nodes that are not dirty.
+    const PODVector<Quaternion>& GetWorldRotations() const { return worldRotations_; }
+
+private:
+    /// Rebuild the arrays from the node hierarchy.
+    void Rebuild(Node* root);
+    /// Append a node and its children recursively.
+    void AddNodeRecursive(Node* node, int parentIndex);
+
+    /// Nodes in depth-first order.
+    PODVector<Node*> nodes_;
+    /// Parent node indices, -1 for children of the root.
+    PODVector<int> parentIndices_;
+    /// First node index of each top-level subtree, followed by the node count.
+    PODVector<unsigned> subtreeBegins_;
+    /// World transforms.
+    PODVector<Matrix3x4> worldTransforms_;
+    /// World rotations.
+    PODVector<Quaternion> worldRotations_;
+    /// World transform dirty flags.
+    PODVector<unsigned char> dirty_;
+    /// Hierarchy changed flag.
+    bool structureDirty_;
+};
+
+}
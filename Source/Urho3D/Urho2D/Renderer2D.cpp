@@ -49,6 +49,7 @@ namespace Urho3D
 extern const char* blendModeNames[];
 
 static const unsigned MASK_VERTEX2D = MASK_POSITION | MASK_COLOR | MASK_TEXCOORD1;
+static const unsigned MIN_VISIBILITY_CHECKS_PER_ITEM = 64;
 
 ViewBatchInfo2D::ViewBatchInfo2D() :
     vertexBufferUpdateFrameNumber_(0),
@@ -338,29 +339,7 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
         URHO3D_PROFILE(CheckDrawableVisibility);
 
         auto* queue = GetSubsystem<WorkQueue>();
-        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = drawables_.Size() / numWorkItems;
-
-        PODVector<Drawable2D*>::Iterator start = drawables_.Begin();
-        for (int i = 0; i < numWorkItems; ++i)
-        {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = CheckDrawableVisibilityWork;
-            item->aux_ = this;
-
-            PODVector<Drawable2D*>::Iterator end = drawables_.End();
-            if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
-
-            start = end;
-        }
-
-        queue->Complete(M_MAX_UNSIGNED);
+        queue->ParallelFor(drawables_.Begin(), drawables_.End(), CheckDrawableVisibilityWork, this, MIN_VISIBILITY_CHECKS_PER_ITEM);
     }
 
     ViewBatchInfo2D& viewBatchInfo = viewBatchInfos_[camera];